@@ -3,12 +3,23 @@
 #include <ArduinoJson.h>
 // 통신
 #include "src/net/web/web.h"
+#include "src/net/wifi/wifi_ap.h"
+#include "src/net/wifi/radio_scheduler.h"
 #include "src/net/rest/RestSender.h"
+#include "src/net/telemetry/Telemetry.h"
+#include "src/fs/event_log/EventLog.h"
 // 설정
 #include "src/config/config.h"
-// #include "src/devices/nfc/NfcReaderSPI.h"
 // Up Down 트렌드 감지
 #include "src/app/trend/TrendDetector.h"
+// 태스크 런타임 (sense / nfc / uplink)
+#include "src/app/runtime/Runtime.h"
+// 거리 트레이스 기록 (/api/trace)
+#include "src/app/recorder/TraceRecorder.h"
+// 태그 체크인 세션 / 회원 테이블
+#include "src/app/session/SessionManager.h"
+// 활동 상태별 절전 (측정 주기 / 레이저 / light sleep)
+#include "src/app/power/PowerManager.h"
 // laser Cli
 #include "src/app/cli/cli_laser.h"
 // 물리 기기들
@@ -16,19 +27,36 @@
 #include "src/devices/power/power.h"
 #include "src/devices/status_led/status_led.h"
 #include "src/devices/distance/DistanceSensor.h"
-#include "src/devices/nfc/NfcReaderUart.h"
+#include "src/devices/nfc/NfcReader.h"
+// 비동기 로그 / 구간 트레이서 (/api/systrace)
+#include "src/util/log/Log.h"
+#include "src/util/tracer/Tracer.h"
 
 // -------------------- NFC --------------------
-
+// 백엔드(HSU/SPI)는 NfcBackend.h 의 GYMBUDDY_NFC_SPI 로 선택
+
+#if GYMBUDDY_NFC_SPI
+constexpr int NFC_SCK_PIN  = 12;  // FSPI IO_MUX 핀 (GPIO 매트릭스 안 거침 → 고속 클럭 가능)
+constexpr int NFC_MISO_PIN = 13;
+constexpr int NFC_MOSI_PIN = 11;
+constexpr int NFC_SS_PIN   = 10;
+constexpr int NFC_RST_PIN  = -1;  // 별도 제어 없으면 -1
+constexpr int NFC_IRQ_PIN  = -1;  // PN532 IRQ (연결하면 응답 준비 인터럽트, -1 이면 상태 폴링)
+
+Nfc::Pins nfcPins{NFC_SCK_PIN, NFC_MISO_PIN, NFC_MOSI_PIN, NFC_SS_PIN, NFC_RST_PIN, NFC_IRQ_PIN};
+Nfc::Config nfcCfg{ .link = { .spiHz = 1000000 } };
+#else
 constexpr int NFC_RX_PIN = 10; // ESP32 RX  <- PN532 TX
 constexpr int NFC_TX_PIN = 11; // ESP32 TX  -> PN532 RX
 constexpr int NFC_RST_PIN = -1; // 별도 제어 없으면 -1
+constexpr int NFC_IRQ_PIN = -1; // HSU 는 IRQ 없음 → light sleep 안 함
 
-NfcReaderUart::Pins  nfcPins{NFC_RX_PIN, NFC_TX_PIN, NFC_RST_PIN};
-NfcReaderUart::Config nfcCfg;
+Nfc::Pins  nfcPins{NFC_RX_PIN, NFC_TX_PIN, NFC_RST_PIN};
+Nfc::Config nfcCfg;
+#endif
 
 // 전역 리더 인스턴스
-NfcReaderUart nfcUart(nfcPins, nfcCfg);
+Nfc nfc(nfcPins, nfcCfg);
 
 // -------------------- Distance Sensor (VL53L0X via I2C) --------------------
 
@@ -37,7 +65,7 @@ Adafruit_VL53L0X lox;
 constexpr int DIS_SDA_PIN   = 36;
 constexpr int DIS_SCL_PIN   = 35;
 constexpr int PIN_XSHUT     = -1; // 미사용 
-constexpr int PIN_INT       = -1; // 미사용
+constexpr int PIN_INT       = -1; // VL53L0X GPIO1 (연결하면 data-ready 인터럽트, -1 이면 폴링)
 
 DistanceSensor::Pins pins{DIS_SDA_PIN, DIS_SCL_PIN, PIN_XSHUT, PIN_INT};
 
@@ -45,15 +73,23 @@ DistanceSensor::Config disCfg{
   .i2cHz = 100000,
   .measureTimeoutMs = 200,
   .touchThresholdMm = 40,
-  .medianN = 3
+  .medianN = 3,
+  .continuous = true,
+  .timingBudgetUs = 33000,
+  .periodMs = 0,
+  .filter = {
+    .hampelWindow = 7,
+    .hampelK_x10  = 30,
+    .medianWindow = 3,
+    .emaShift     = 0
+  }
 };
 
 DistanceSensor distanceSensor(pins, disCfg, Wire);
 // -------------------- Trend Detector --------------------
 TrendDetector detector; 
 
-uint32_t lastPrintMs = 0;
-const uint32_t PRINT_INTERVAL_MS = 50;
+constexpr uint32_t SAMPLE_PERIOD_MS = 20;   // 연속 측정 링버퍼를 비우는 주기
 
 // -------------------- RestSender --------------------
 
@@ -68,18 +104,35 @@ RestSender::Config rsCfg{
 
 RestSender sender(rsCfg);
 
+// 태그 체크인 → 운동 세션
+SessionManager session;
+
+// 오프라인 대비 rep 이벤트 저장소 (LittleFS)
+EventLog eventLog;
+bool eventLogReady = false;
+
 // -------------------- Laser / Power Pins --------------------
 
 constexpr int LASER_EN_PIN = 4;   // 레이저 EN(PWM) — 10k/20k 분압 뒤 5V 모듈은 3.3V PWM만 인가됨
 constexpr int VBAT_ADC_PIN = 8;    // 배터리 전압 ADC
 
+// -------------------- Runtime --------------------
+
+const char* DEVICE_ID = "GymBuddy-Yeongdeungpo-01";
+
+// LittleFS 로그 미러 (nullptr = Serial 만). 예: "/log.txt" → 64KB 넘으면 /log.txt.1 로 회전
+constexpr const char* LOG_FILE = nullptr;
+
+uint32_t lastStatsMs = 0;
+constexpr uint32_t STATS_INTERVAL_MS = 10000;
+
 // ======================================================
 
 void setup() {
   // --- Serial ---
   Serial.begin(115200);
   Serial.setTimeout(50);
-  Serial.println("setup");
+  LOGI("SYS", "setup");
 
   // --- Laser PWM ---
   Laser::begin(LASER_EN_PIN, Laser::DEFAULT_FREQ, Laser::DEFAULT_DUTY);
@@ -88,114 +141,138 @@ void setup() {
   Power::begin(VBAT_ADC_PIN);
   Power::configureChargerPin();
   if (!Power::enableCharging()) {
-    Serial.println("Failed to enable charger during boot");
+    LOGE("Power", "Failed to enable charger during boot");
   }
 
   // --- Config / Wi-Fi ---
   Config::begin();
-  auto cfg = Config::get();
+  const auto cfg = Config::get();
 
-  bool wantSTA = cfg.staSsid.length() > 0;
+  bool wantSTA = cfg->staSsid.length() > 0;
   WiFi.mode(wantSTA ? WIFI_AP_STA : WIFI_AP);
-  WiFi.softAP(cfg.apSsid.c_str(), cfg.apPass.c_str());
+  WiFi.softAP(cfg->apSsid.c_str(), cfg->apPass.c_str());
+  WiFiMgr::watchLink();
   if (wantSTA) {
-    WiFi.begin(cfg.staSsid.c_str(), cfg.staPass.c_str());
+    WiFi.begin(cfg->staSsid.c_str(), cfg->staPass.c_str());
   }
 
-  Serial.println("Access Point started at:");
-  Serial.println(WiFi.softAPIP());
+  LOGI("SYS", "Access Point started at: %s", WiFi.softAPIP().toString().c_str());
 
   // --- LittleFS ---
   if (!LittleFS.begin()) {
-    Serial.println("LittleFS mount failed, attempting to format...");
+    LOGW("FS", "LittleFS mount failed, attempting to format...");
     LittleFS.end();
     if (!LittleFS.format()) {
-      Serial.println("LittleFS format failed");
+      LOGE("FS", "LittleFS format failed");
       return;
     }
     if (!LittleFS.begin()) {
-      Serial.println("LittleFS mount failed after format");
+      LOGE("FS", "LittleFS mount failed after format");
       return;
     }
-    Serial.println("LittleFS formatted successfully");
+    LOGI("FS", "LittleFS formatted successfully");
   }
-  Serial.println("LittleFS formatted successfully");
+  LOGI("FS", "LittleFS mounted");
+
+#if GYMBUDDY_STATUS_LED
+  // --- Status LED (esp_timer 구동, loop 와 무관. 패턴은 /leds.json 으로 변경 가능) ---
+  StatusLED::begin();
+#endif
+
+  // --- Log (여기부터 로그는 링 → 출력 태스크) ---
+  Log::Config logCfg;
+  logCfg.filePath = LOG_FILE;
+  Log::begin(logCfg);
+
+  // --- Event log (store-and-forward) ---
+  eventLogReady = eventLog.begin();
+  if (!eventLogReady) {
+    LOGE("FS", "EventLog init failed, events will not survive offline periods");
+  }
+
+  // --- Members table (UID → 회원 ID) ---
+  Members::begin();
+
+  // --- Trace recorder (링은 부팅 시 한 번만 할당) ---
+  TraceRecorder::Config trCfg;
+  trCfg.periodUs = disCfg.timingBudgetUs;
+  TraceRecorder::begin(trCfg);
+
+  // --- Systrace (GYMBUDDY_TRACE=1 일 때만 버퍼 할당) ---
+  Tracer::begin();
 
   // --- HTTP Routes ---
   WebServerApp::begin();
-  Serial.println("setup Routes Successfully");
+  LOGI("SYS", "setup Routes Successfully");
 
   // --- Distance Sensor (VL53L0X) ---
-  Serial.println("[VL53L0X] init...");
+  LOGI("DIST", "VL53L0X init...");
 
   if (!distanceSensor.begin()) {
-    Serial.println("! DistanceSensor init failed. Check power/I2C wiring/XSHUT.");
+    LOGE("DIST", "DistanceSensor init failed. Check power/I2C wiring/XSHUT.");
+    Log::flush();
     while (true) { delay(1000); }
   }
 
-  Serial.println("VL53L0X ready");
+  LOGI("DIST", "VL53L0X ready");
 
- // --- NFC ---
- Serial.println("[INFO] PN532 HSU(UART) init...");
-  if (!nfcUart.begin()) {
-    Serial.println("! PN532 HSU init failed (DIP=00, RX/TX 교차, 전원 확인)");
+  // --- NFC ---
+  LOGI("NFC", "PN532 %s init...", Nfc::kLink);
+  if (!nfc.begin()) {
+    LOGE("NFC", "PN532 init failed (DIP 스위치/배선/전원 확인)");
   } else {
     uint32_t ver;
-    if (nfcUart.getFirmware(ver)) {
-      Serial.printf("PN532 FW: 0x%08lX\n", (unsigned long)ver);
+    if (nfc.getFirmware(ver)) {
+      LOGI("NFC", "PN532 FW: 0x%08lX", (unsigned long)ver);
     }
+    // 명령 1회 왕복 시간 (전송 계층 비교용)
+    const auto b = nfc.benchExchange(32);
+    LOGI("NFC", "PN532 %s exchange: n=%u fail=%u mean=%luus min=%luus max=%luus",
+         Nfc::kLink, (unsigned)b.ok, (unsigned)b.failed,
+         (unsigned long)b.meanUs, (unsigned long)b.minUs, (unsigned long)b.maxUs);
   }
 
+  // --- Tasks ---
+  Runtime::Config rtCfg;
+  rtCfg.samplePeriodMs = SAMPLE_PERIOD_MS;
+  rtCfg.setIdleMs      = cfg->setIdleMs;
+  session.setIdleMs(cfg->sessionIdleMs);
+  sender.setBatch({cfg->batchMaxEvents, cfg->batchMaxBytes, cfg->batchMaxAgeMs});
+  // 라디오 절전 + 업링크 창 (poll 은 uplink 태스크)
+  RadioScheduler::Config radioCfg;
+  radioCfg.policy         = (RadioScheduler::Policy)cfg->radioPolicy;
+  radioCfg.listenInterval = cfg->listenInterval;
+  radioCfg.windowMs       = cfg->uplinkWindowMs;
+  radioCfg.highWater      = cfg->uplinkHighWater;
+  radioCfg.apIdleOffMs    = cfg->apIdleOffMs;
+  RadioScheduler::begin(&sender, radioCfg);
+  if (!Runtime::begin({&distanceSensor, &detector, &nfc, &sender,
+                       eventLogReady ? &eventLog : nullptr, DEVICE_ID, &session}, rtCfg)) {
+    LOGE("RT", "Runtime task start failed");
+  }
+
+  // --- Power manager (Runtime 이후: 훅이 sense/nfc 태스크에서 불림) ---
+  PowerManager::Config pmCfg;
+  pmCfg.setIdleMs  = cfg->setIdleMs;
+  pmCfg.distIrqPin = PIN_INT;
+  pmCfg.nfcIrqPin  = NFC_IRQ_PIN;
+  // light sleep 동안 Wi-Fi 가 멈추므로: AP 접속자 없고 보낼 이벤트가 없을 때만
+  pmCfg.canSleep   = [] { return WiFi.softAPgetStationNum() == 0 && sender.backlog() == 0 && sender.pending() == 0; };
+  PowerManager::begin(&distanceSensor, pmCfg);
 }
 
 void loop() {
   // --- Serial CLI (Laser) ---
   //handleSerialLaserCommand();
-  delay(1);
 
-  // --- Distance read & touch event (every ~50ms) ---
+  // 샘플링/NFC/업링크는 Runtime 태스크에서 처리. loop 는 상태 리포트만.
   const uint32_t now = millis();
-  if (now - lastPrintMs < PRINT_INTERVAL_MS) return;
-  lastPrintMs = now;
-  const String deviceId = "GymBuddy-Yeongdeungpo-01";
-  const String tagId    = "TestTag-0001";
-  const String isoTs   = String((uint32_t)(time(nullptr)));
-
-  uint16_t d;
-  if (distanceSensor.read(d)) {
-    if (detector.step(d)) {
-      const auto& s = detector.state();
-      Serial.printf("Send! stata: %s", (s.phase == TrendDetector::Phase::Up) ? "Up" : "Down");
-      Serial.print("\n");
-      String json =
-        String("{\"device_id\":\"") + deviceId +
-        "\",\"tag_id\":\"" + tagId +
-        "\",\"minDistance\":\"" + String(s.minv) +
-        "\",\"maxDistance\":\"" + String(s.maxv) +
-        "\",\"ts\":\"" + isoTs +
-        "\"}";
-
-      bool ok = sender.post_plain_http(json);
-      Serial.println(ok ? "POST OK" : "POST FAIL");
-    }
-
-    const auto& s = detector.state();
-    Serial.printf("d=%u phase=%d min=%u max=%u\n", d, (int)s.phase, s.minv, s.maxv);
-  }
-
-  // --- NFC poll ---
-  uint8_t uid[7]; 
-  uint8_t uidLen=0;
-  if (nfcUart.readUID(uid, uidLen)) {
-    Serial.print("[TAG] UID: ");
-    for (uint8_t i=0; i<uidLen; ++i) {
-      if (uid[i] < 0x10) Serial.print('0');
-      Serial.print(uid[i], HEX);
-      Serial.print(' ');
-    }
-    Serial.println();
-    delay(500);
-  } else {
-    delay(50);
+  if (now - lastStatsMs >= STATS_INTERVAL_MS) {
+    lastStatsMs = now;
+    Runtime::printStats(Serial);
   }
+  Config::handle();   // 설정 저장 모아서 NVS 기록
+  Members::handle();  // 업로드된 회원 CSV 가져오기 (AsyncTCP 태스크 밖에서 정렬/기록)
+  Telemetry::handle(); // 끊긴 WebSocket 클라이언트 정리
+  delay(100);
 }
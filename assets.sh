@@ -0,0 +1,53 @@
+#!/usr/bin/env zsh
+set -euo pipefail
+
+# data/ → _fs_data/ (LittleFS 이미지 원본)
+#  - 웹 자산(html/css/js/json/svg)은 gzip -9 -n 으로 *.gz 생성 + 원본도 복사
+#    (원본은 매니페스트가 없거나 gz 를 못 올렸을 때 web.cpp 의 평문 대체용)
+#  - /assets.manifest: "경로 MIME gzip바이트 ETag" 한 줄씩. ETag = 압축본 SHA-256 앞 16자리
+#  - 그 외 파일은 그대로 복사
+# 사용: zsh assets.sh [data_dir] [out_dir]   (zsh 문법 — sh 로 실행하지 말 것)
+
+SRC_DIR="${1:-$(pwd)/data}"
+OUT_DIR="${2:-$(pwd)/_fs_data}"
+MANIFEST="assets.manifest"
+
+[[ -d "$SRC_DIR" ]] || { echo "[assets.sh] data/ 폴더 없음: $SRC_DIR"; exit 1; }
+
+hash16() {
+  if command -v sha256sum >/dev/null 2>&1; then
+    sha256sum "$1" | cut -c1-16
+  else
+    shasum -a 256 "$1" | cut -c1-16
+  fi
+}
+
+mime_of() {
+  case "$1" in
+    *.html) echo "text/html" ;;
+    *.css)  echo "text/css" ;;
+    *.js)   echo "application/javascript" ;;
+    *.json) echo "application/json" ;;
+    *.svg)  echo "image/svg+xml" ;;
+    *)      echo "" ;;
+  esac
+}
+
+rm -rf "$OUT_DIR"
+mkdir -p "$OUT_DIR"
+echo "# path mime gz_bytes etag" > "$OUT_DIR/$MANIFEST"
+
+( cd "$SRC_DIR" && find . -type f ! -name '.*' | sort ) | while read -r f; do
+  rel="${f#./}"
+  mkdir -p "$OUT_DIR/$(dirname "$rel")"
+  mime="$(mime_of "$rel")"
+  if [[ -n "$mime" ]]; then
+    gzip -9 -n -c "$SRC_DIR/$rel" > "$OUT_DIR/$rel.gz"
+    size="$(wc -c < "$OUT_DIR/$rel.gz" | tr -d ' ')"
+    echo "/$rel $mime $size $(hash16 "$OUT_DIR/$rel.gz")" >> "$OUT_DIR/$MANIFEST"
+    echo "[assets.sh] $rel: $(wc -c < "$SRC_DIR/$rel" | tr -d ' ') -> $size B"
+  fi
+  cp "$SRC_DIR/$rel" "$OUT_DIR/$rel"
+done
+
+echo "[assets.sh] manifest: $OUT_DIR/$MANIFEST"
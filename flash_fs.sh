@@ -87,6 +87,8 @@ arduino-cli upload -p "$PORT" --fqbn "$FQBN" --input-file "$APP_BIN" --verify
 # ===== LittleFS 이미지 생성 =====
 DATA_DIR="$SKETCH_DIR/data"
 [[ -d "$DATA_DIR" ]] || { echo "data/ 폴더가 없습니다: $DATA_DIR"; exit 1; }
+FS_DIR="$SKETCH_DIR/_fs_data"
+zsh "$SKETCH_DIR/assets.sh" "$DATA_DIR" "$FS_DIR"   # gzip 자산 + 매니페스트
 
 OFFSET_HEX=$(awk -F, 'tolower($1)~/(littlefs|spiffs)/{o=$4; gsub(/[[:space:]]/,"",o); print o; exit}' "$PARTCSV")
 SIZE_HEX=$(awk   -F, 'tolower($1)~/(littlefs|spiffs)/{s=$5; gsub(/[[:space:]]/,"",s); print s; exit}' "$PARTCSV")
@@ -94,7 +96,7 @@ SIZE_HEX=$(awk   -F, 'tolower($1)~/(littlefs|spiffs)/{s=$5; gsub(/[[:space:]]/,"
 
 SIZE_DEC=$(( SIZE_HEX ))
 echo "[4/5] littlefs.bin 생성(size=$SIZE_DEC, offset=$OFFSET_HEX)"
-"$MKLFS" -c "$DATA_DIR" -s $SIZE_DEC -p 256 -b 4096 littlefs.bin
+"$MKLFS" -c "$FS_DIR" -s $SIZE_DEC -p 256 -b 4096 littlefs.bin
 ls -lh littlefs.bin
 
 # ===== 포트 점유 확인 =====
@@ -0,0 +1,98 @@
+// rep 이벤트 직렬화 벤치마크: 기존 String 연결 방식 vs EventCodec (고정 버퍼)
+//   이벤트당 바이트 / ns / cycles(x86 TSC) / 힙 할당 횟수
+// 호스트 수치라 절대값은 ESP32 와 다르지만 할당 횟수와 상대 비율은 그대로 옮겨감
+#include <Arduino.h>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <stdio.h>
+
+#include "src/app/event/RepEventCodec.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline uint64_t cycles() { return __rdtsc(); }
+#else
+static inline uint64_t cycles() { return 0; }
+#endif
+
+// ---------- 할당 카운터 ----------
+static std::atomic<uint64_t> g_allocs{0};
+
+void* operator new(size_t n) {
+  g_allocs.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = malloc(n ? n : 1)) return p;
+  throw std::bad_alloc();
+}
+void* operator new[](size_t n) { return operator new(n); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+namespace {
+  const char* kDeviceId = "GymBuddy-Yeongdeungpo-01";
+  const char* kTagId    = "TestTag-0001";
+
+  // baseline 의 loop() 코드 그대로 (deviceId/tagId/isoTs 도 매번 String 으로 생성)
+  size_t legacyEncode(const RepEvent& ev, char* sink) {
+    const String deviceId = kDeviceId;
+    const String tagId    = kTagId;
+    const String isoTs    = String((uint32_t)ev.ts);
+    String json =
+      String("{\"device_id\":\"") + deviceId +
+      "\",\"tag_id\":\"" + tagId +
+      "\",\"minDistance\":\"" + String(ev.minv) +
+      "\",\"maxDistance\":\"" + String(ev.maxv) +
+      "\",\"ts\":\"" + isoTs +
+      "\"}";
+    sink[0] = json.c_str()[0];           // 최적화로 사라지지 않도록
+    return json.length();
+  }
+
+  size_t codecEncode(const RepEvent& ev, char* sink) {
+    char buf[EventCodec::maxEncodedSize<RepEvent>()];
+    const size_t n = EventCodec::encode(ev, {kDeviceId, kTagId}, buf, sizeof(buf));
+    sink[0] = buf[0];
+    return n;
+  }
+
+  template <typename F>
+  void run(const char* name, F fn, uint32_t iters) {
+    char sink[1];
+    size_t bytes = 0;
+    RepEvent ev{1700000000u, 0, 0, 0, 180, 1200, 900, 2100, 850, 200, 0, {}};
+
+    const uint64_t a0 = g_allocs.load();
+    const uint64_t c0 = cycles();
+    const auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iters; ++i) {
+      ev.ts++; ev.ms += 50;
+      ev.minv = (uint16_t)(300 + (i % 500));
+      ev.maxv = (uint16_t)(ev.minv + 180);
+      bytes += fn(ev, sink);
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    const uint64_t c1 = cycles();
+    const uint64_t a1 = g_allocs.load();
+
+    const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    printf("%-8s bytes/ev=%6.1f  ns/ev=%7.1f  cycles/ev=%7.1f  allocs/ev=%5.2f\n",
+           name, (double)bytes / iters, ns / iters, (double)(c1 - c0) / iters,
+           (double)(a1 - a0) / iters);
+  }
+}
+
+int main(int argc, char** argv) {
+  const uint32_t iters = (argc > 1) ? (uint32_t)strtoul(argv[1], nullptr, 10) : 1000000u;
+
+  char sample[EventCodec::maxEncodedSize<RepEvent>() + 1];
+  const size_t n = EventCodec::encode(RepEvent{1700000000u, 0, 312, 498, 186, 1210, 880, 2090, 412, 211, 0, {}}, {kDeviceId, kTagId, "M-000123"}, sample, sizeof(sample) - 1);
+  sample[n] = '\0';
+  printf("codec sample: %s\n", sample);
+  printf("codec max bytes (compile-time): %zu\n", EventCodec::maxEncodedSize<RepEvent>());
+
+  run("legacy", legacyEncode, iters);
+  run("codec",  codecEncode,  iters);
+  return 0;
+}
@@ -0,0 +1,89 @@
+// 스트리밍 필터 마이크로벤치마크: 샘플당 ns
+//   legacy = DistanceSensor::read 의 삽입정렬 중앙값(N개 새로 모아 1개 출력) — 출력 1개당 비용도 함께 표시
+#include <Arduino.h>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+#include "src/util/stream_filter.h"
+
+namespace {
+  // 바벨 왕복(≈1.5s 주기) + 잡음 + 가끔 튀는 값
+  std::vector<uint16_t> makeTrace(size_t n) {
+    std::vector<uint16_t> v(n);
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < n; ++i) {
+      seed = seed * 1103515245u + 12345u;
+      const int noise = (int)((seed >> 16) % 21) - 10;
+      const double base = 600 + 250 * sin(i * 2 * M_PI / 45.0);
+      int x = (int)base + noise;
+      if ((seed >> 8) % 97 == 0) x += 800;            // 스파이크
+      v[i] = (uint16_t)(x < 0 ? 0 : x);
+    }
+    return v;
+  }
+
+  uint16_t legacyMedian(const uint16_t* in, uint8_t n) {
+    uint16_t buf[7];
+    for (uint8_t i = 0; i < n; ++i) buf[i] = in[i];
+    for (uint8_t i = 1; i < n; ++i) {
+      uint16_t key = buf[i];
+      int j = i - 1;
+      while (j >= 0 && buf[j] > key) { buf[j + 1] = buf[j]; j--; }
+      buf[j + 1] = key;
+    }
+    return buf[n / 2];
+  }
+
+  volatile uint32_t g_sink;
+
+  template <typename F>
+  void run(const char* name, const std::vector<uint16_t>& trace, F fn) {
+    uint32_t acc = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (uint16_t x : trace) acc += fn(x);
+    const auto t1 = std::chrono::steady_clock::now();
+    g_sink = acc;
+    const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    printf("%-22s %7.2f ns/sample\n", name, ns / trace.size());
+  }
+}
+
+int main(int argc, char** argv) {
+  const size_t n = (argc > 1) ? (size_t)strtoul(argv[1], nullptr, 10) : 4000000u;
+  const auto trace = makeTrace(n);
+
+  for (uint8_t w : {3, 7, 15, 31}) {
+    SlidingMedian m(w);
+    char name[32];
+    snprintf(name, sizeof(name), "median W=%u", w);
+    run(name, trace, [&](uint16_t x) { return m.push(x); });
+  }
+  {
+    HampelFilter h(7, 30);
+    run("hampel W=7 k=3", trace, [&](uint16_t x) { return h.push(x); });
+    printf("%-22s %lu / %zu\n", "  outliers replaced", (unsigned long)h.rejected(), n);
+  }
+  {
+    IntEma e(2);
+    run("ema shift=2", trace, [&](uint16_t x) { return e.push(x); });
+  }
+  {
+    FilterChain c(FilterConfig{7, 30, 3, 2});
+    run("chain H7+M3+EMA2", trace, [&](uint16_t x) { return c.push(x); });
+  }
+
+  // legacy: 입력 샘플당 비용 (출력은 N 샘플마다 1개)
+  for (uint8_t w : {3, 5, 7}) {
+    uint32_t acc = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i + w <= n; i += w) acc += legacyMedian(&trace[i], w);
+    const auto t1 = std::chrono::steady_clock::now();
+    g_sink = acc;
+    const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    printf("legacy median N=%u      %7.2f ns/sample  (%.2f ns/output, output rate 1/%u)\n",
+           w, ns / n, ns / (n / w), w);
+  }
+  return 0;
+}
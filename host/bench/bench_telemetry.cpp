@@ -0,0 +1,95 @@
+// 텔레메트리 경로 벤치마크
+//   publish : SpscRing::push 1회 (센서 태스크가 내는 비용)
+//   pack    : 50ms 묶음 1개를 TelemetryFrame 으로 포장 (decimation 1/2/4/8)
+//   bytes   : 샘플당 전송 바이트 — 바이너리 프레임 vs 기존 "d=%u phase=%d" 텍스트 줄
+// 호스트 수치라 절대값은 ESP32 와 다름. 기기 쪽 publish 사이클은 [RT] telem 줄에 나옴
+#include <Arduino.h>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "src/net/telemetry/TelemetryFrame.h"
+#include "src/util/spsc_ring.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline uint64_t cycles() { return __rdtsc(); }
+#else
+static inline uint64_t cycles() { return 0; }
+#endif
+
+using TraceFormat::TraceRecord;
+
+namespace {
+  constexpr size_t kBatch = 64;
+  uint64_t g_sink = 0;
+
+  TraceRecord sample(uint32_t i) {
+    const uint16_t mm = (uint16_t)(400 + (i * 7) % 300);
+    return TraceRecord{ 33000u * i, (uint16_t)(mm + 3), mm, (uint8_t)(i % 3), (uint8_t)(i % 97 == 0 ? 2 : 0), 0 };
+  }
+
+  void benchPublish(uint32_t iters) {
+    static SpscRing<TraceRecord, 256> ring;
+    TraceRecord out[kBatch];
+    uint32_t full = 0;
+    const uint64_t c0 = cycles();
+    const auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iters; ++i) {
+      if (!ring.push(sample(i))) {
+        full++;
+        g_sink += ring.pop(out, kBatch);   // 펌프 대신 가득 차면 비움
+      }
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    const uint64_t c1 = cycles();
+    const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    printf("publish                ns/push=%6.2f  cycles/push=%7.1f  (incl. drain every %zu)\n",
+           ns / iters, (double)(c1 - c0) / iters, (size_t)(full ? iters / full : 0));
+  }
+
+  void benchPack(uint32_t iters, size_t ns, uint8_t decim) {
+    TraceRecord s[kBatch];
+    for (size_t i = 0; i < ns; ++i) s[i] = sample((uint32_t)i);
+    const RepEvent rep{1700000000u, 0, 312, 498, 186, 1210, 880, 2090, 412, 211, 0, {}};
+    uint8_t buf[TelemetryFrame::maxSize(kBatch, 1)];
+
+    size_t bytes = 0;
+    const uint64_t c0 = cycles();
+    const auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iters; ++i) {
+      s[0].tUs = i;
+      bytes = TelemetryFrame::pack(s, ns, &rep, i % 8 == 0, decim, 0, buf, sizeof(buf));
+      g_sink += buf[bytes - 1];
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    const uint64_t c1 = cycles();
+    const double nsTotal = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    printf("pack    n=%-2zu decim=%u      ns/frame=%7.1f  cycles/frame=%8.1f  bytes=%zu\n",
+           ns, decim, nsTotal / iters, (double)(c1 - c0) / iters, bytes);
+  }
+
+  void compareBytes(size_t ns) {
+    size_t text = 0;
+    char line[64];
+    for (size_t i = 0; i < ns; ++i) {
+      const TraceRecord r = sample((uint32_t)i);
+      text += (size_t)snprintf(line, sizeof(line), "d=%u phase=%d min=%u max=%u\n", r.mm, r.phase, 300u, 700u);
+    }
+    const size_t bin = TelemetryFrame::maxSize(ns, 0);
+    printf("bytes   n=%-2zu             text=%zu (%.1f/sample)  binary=%zu (%.1f/sample)\n",
+           ns, text, (double)text / ns, bin, (double)bin / ns);
+  }
+}
+
+int main(int argc, char** argv) {
+  const uint32_t iters = (argc > 1) ? (uint32_t)strtoul(argv[1], nullptr, 10) : 10000000u;
+
+  benchPublish(iters);
+  for (uint8_t d : {1, 2, 4, 8}) benchPack(iters / 20, 2, d);      // 50ms 묶음 @ 33ms 주기
+  for (uint8_t d : {1, 2, 4, 8}) benchPack(iters / 20, kBatch, d);
+  compareBytes(2);
+  compareBytes(kBatch);
+  printf("(sink %llu)\n", (unsigned long long)g_sink);
+  return 0;
+}
@@ -0,0 +1,171 @@
+#include "trace_io.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace TraceFormat;
+
+namespace {
+  void indexLabels(Trace& t) {
+    t.labels.clear();
+    for (uint32_t i = 0; i < t.recs.size(); ++i)
+      if (t.recs[i].flags & kRepLabel) t.labels.push_back(i);
+  }
+
+  bool loadBin(FILE* f, Trace& out, std::string& err) {
+    TraceHeader h{};
+    if (fread(&h, sizeof h, 1, f) != 1 || h.magic != kMagic) { err = "bad header"; return false; }
+    if (h.version != kVersion || h.recSize < sizeof(TraceRecord)) { err = "unsupported version/recSize"; return false; }
+    std::vector<uint8_t> buf(h.recSize);
+    while (fread(buf.data(), h.recSize, 1, f) == 1) {
+      TraceRecord r;
+      memcpy(&r, buf.data(), sizeof r);
+      out.recs.push_back(r);
+      if (h.count && out.recs.size() == h.count) break;
+    }
+    return true;
+  }
+
+  bool loadCsv(FILE* f, Trace& out, std::string& err) {
+    char line[256];
+    uint32_t lineNo = 0;
+    while (fgets(line, sizeof line, f)) {
+      lineNo++;
+      if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') continue;
+      char* p = line;
+      char* end;
+      const double tMs = strtod(p, &end);
+      if (end == p) {
+        if (out.recs.empty()) continue;                 // 헤더 줄
+        err = "parse error at line " + std::to_string(lineNo);
+        return false;
+      }
+      p = (*end == ',') ? end + 1 : end;
+      const long mm = strtol(p, &end, 10);
+      if (end == p) { err = "missing mm at line " + std::to_string(lineNo); return false; }
+      p = (*end == ',') ? end + 1 : end;
+      const long rep = strtol(p, &end, 10);
+
+      TraceRecord r{};
+      r.tUs   = (uint32_t)llround(tMs * 1000.0);
+      r.raw   = r.mm = (uint16_t)(mm < 0 ? 0 : (mm > 0xFFFF ? 0xFFFF : mm));
+      r.flags = (uint8_t)((end != p && rep) ? kRepLabel : 0);
+      if (r.raw == 0) r.flags |= kInvalid;
+      out.recs.push_back(r);
+    }
+    return true;
+  }
+}
+
+bool loadTrace(const std::string& path, Trace& out, std::string& err) {
+  FILE* f = fopen(path.c_str(), "rb");
+  if (!f) { err = "cannot open"; return false; }
+  out = Trace{};
+  out.name = path;
+  uint32_t magic = 0;
+  const bool bin = fread(&magic, sizeof magic, 1, f) == 1 && magic == kMagic;
+  rewind(f);
+  const bool ok = bin ? loadBin(f, out, err) : loadCsv(f, out, err);
+  fclose(f);
+  if (ok) indexLabels(out);
+  return ok;
+}
+
+bool saveTraceCsv(const std::string& path, const Trace& t) {
+  FILE* f = fopen(path.c_str(), "w");
+  if (!f) return false;
+  fprintf(f, "# %s\nt_ms,mm,rep\n", t.name.c_str());
+  for (const auto& r : t.recs)
+    fprintf(f, "%.3f,%u,%u\n", r.tUs / 1000.0, r.raw, (r.flags & kRepLabel) ? 1u : 0u);
+  return fclose(f) == 0;
+}
+
+bool saveTraceBin(const std::string& path, const Trace& t, uint32_t periodUs) {
+  FILE* f = fopen(path.c_str(), "wb");
+  if (!f) return false;
+  const TraceHeader h{kMagic, kVersion, (uint16_t)sizeof(TraceRecord), (uint32_t)t.recs.size(), periodUs};
+  bool ok = fwrite(&h, sizeof h, 1, f) == 1;
+  if (ok && !t.recs.empty()) ok = fwrite(t.recs.data(), sizeof(TraceRecord), t.recs.size(), f) == t.recs.size();
+  return (fclose(f) == 0) && ok;
+}
+
+// ---------- 합성 코퍼스 ----------
+
+namespace {
+  struct Profile {
+    const char* name;
+    uint16_t topMm;        // 휴지 위치 거리
+    uint16_t romMm;        // 가동 범위
+    uint32_t repMs;        // 반복 1회 (하강+상승)
+    uint32_t pauseMs;      // 반복 사이 정지
+    uint8_t  noiseMm;      // ± 균등 잡음
+    uint16_t spikeOdds;    // 1/N 확률로 한 샘플 튐
+    uint8_t  reps, sets;
+    uint32_t restMs;       // 세트 사이 휴식
+    uint8_t  fidgetMm;     // 휴식 중 미세 움직임 (정답 아님)
+  };
+
+  // 명목 20ms 주기 (GymBuddy.ino SAMPLE_PERIOD_MS)
+  constexpr uint32_t kPeriodUs = 20000;
+
+  const Profile kProfiles[] = {
+    {"synth-stack",  850, 420, 2400, 400, 6, 400, 10, 3, 6000, 10},
+    {"synth-cable", 1100, 600, 1800, 200, 9, 250, 12, 3, 5000, 15},
+    {"synth-plate",  700, 260, 3000, 600, 4, 800,  8, 4, 7000,  8},
+    {"synth-short",  500, 120, 1400, 150, 5, 300, 15, 2, 4000,  6},
+  };
+
+  struct Rng {
+    uint32_t s;
+    uint32_t next() { s = s * 1664525u + 1013904223u; return s >> 8; }
+    int uni(int lo, int hi) { return lo + (int)(next() % (uint32_t)(hi - lo + 1)); }
+  };
+
+  Trace synth(const Profile& p, Rng& rng) {
+    Trace t;
+    t.name = p.name;
+    uint32_t tUs = kPeriodUs;                                  // 지터가 0 아래로 내려가지 않도록
+    auto emit = [&](double mm, bool label) {
+      TraceRecord r{};
+      int v = (int)lround(mm) + rng.uni(-p.noiseMm, p.noiseMm);
+      if (p.spikeOdds && rng.next() % p.spikeOdds == 0) v += rng.uni(-400, 600);
+      r.tUs = tUs + (uint32_t)rng.uni(-300, 300);             // 샘플 지터
+      r.raw = r.mm = (uint16_t)(v < 1 ? 1 : v);
+      r.flags = label ? kRepLabel : 0;
+      t.recs.push_back(r);
+      tUs += kPeriodUs;
+    };
+    auto hold = [&](uint32_t ms, uint8_t fidget) {
+      const uint32_t n = ms * 1000 / kPeriodUs;
+      for (uint32_t i = 0; i < n; ++i)
+        emit(p.topMm - fidget * 0.5 * (1 - cos(2 * M_PI * i / 40.0)), false);
+    };
+
+    hold(2000, p.fidgetMm);
+    for (uint8_t s = 0; s < p.sets; ++s) {
+      for (uint8_t r = 0; r < p.reps; ++r) {
+        // 반복마다 템포/가동범위 ±15%
+        const uint32_t repMs = p.repMs * (uint32_t)rng.uni(85, 115) / 100;
+        const double rom = p.romMm * rng.uni(85, 115) / 100.0;
+        const uint32_t n = repMs * 1000 / kPeriodUs;
+        for (uint32_t i = 0; i < n; ++i)
+          emit(p.topMm - rom * 0.5 * (1 - cos(2 * M_PI * i / n)), i == n / 2);
+        hold(p.pauseMs, 0);
+      }
+      hold(p.restMs, p.fidgetMm);
+    }
+    return t;
+  }
+}
+
+std::vector<Trace> synthCorpus(uint32_t seed) {
+  std::vector<Trace> out;
+  Rng rng{seed};
+  for (const auto& p : kProfiles) {
+    out.push_back(synth(p, rng));
+    indexLabels(out.back());
+  }
+  return out;
+}
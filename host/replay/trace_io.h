@@ -0,0 +1,23 @@
+#pragma once
+// 리플레이용 트레이스 로더/생성기
+//  - .gbtr : src/app/trend/TraceFormat.h 바이너리
+//  - 그 외 : CSV "t_ms,mm[,rep]" ('#' 주석, 헤더 줄 허용). rep=1 이 정답 반복 지점
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "src/app/trend/TraceFormat.h"
+
+struct Trace {
+  std::string name;
+  std::vector<TraceFormat::TraceRecord> recs;
+  std::vector<uint32_t> labels;            // kRepLabel 붙은 레코드 인덱스 (오름차순)
+};
+
+// 실패 시 false, err 에 이유
+bool loadTrace(const std::string& path, Trace& out, std::string& err);
+bool saveTraceCsv(const std::string& path, const Trace& t);
+bool saveTraceBin(const std::string& path, const Trace& t, uint32_t periodUs);
+
+// 기계 유형별 합성 트레이스 (정답 라벨 포함) — 실측 코퍼스가 없을 때의 기준선
+std::vector<Trace> synthCorpus(uint32_t seed);
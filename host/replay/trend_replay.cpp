@@ -0,0 +1,394 @@
+// TrendDetector 트레이스 리플레이 / 정확도 벤치마크
+//
+//   trend_replay [옵션] [trace.gbtr|trace.csv ...]
+//     --noise N            TrendDetector noise_mm (기본 20)
+//     --range N            TrendDetector max_range_mm (기본 2000)
+//     --sweep-noise a:b:s  noise_mm 스윕
+//     --sweep-range a:b:s  max_range_mm 스윕
+//     --input MODE         raw | filtered(기본: 펌웨어 기본 FilterChain 적용) | recorded(기록된 mm 그대로)
+//     --tol-pre N          정답보다 N 샘플 먼저 나온 감지까지 인정 (기본 2)
+//     --tol-post N         정답 뒤 N 샘플 안의 감지까지 인정 (기본 25 = 0.5s@20ms)
+//     --synth              내장 합성 코퍼스 추가 (트레이스를 안 주면 자동)
+//     --dump DIR           합성 코퍼스를 DIR/<name>.csv 로 저장하고 종료
+//     --repeat N           처리량 측정 반복 횟수 (기본 20)
+//     --wake               절전(Idle/Asleep) 주기로 샘플링하다 깨어난 뒤 첫 반복을 잡는지 확인
+//                          (샘플 위상을 바꿔 가며 전부 검사, 하나라도 놓치면 종료 코드 1)
+//
+// 지표: 정답 라벨과 감지를 시간순 탐욕 매칭 → precision / recall / F1,
+//       매칭된 쌍의 지연(감지 인덱스 - 정답 인덱스, 샘플 단위), step()+takeRep() 처리량(samples/s)
+//       단일 파라미터 실행 시 트레이스별 반복 지표 평균(ROM/템포/속도)도 출력
+#include <Arduino.h>
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "src/app/power/MotionDetect.h"
+#include "src/app/trend/TrendDetector.h"
+#include "src/util/stream_filter.h"
+#include "trace_io.h"
+
+namespace {
+
+  enum class Input { Raw, Filtered, Recorded };
+
+  volatile uint32_t g_sink;
+
+  struct Options {
+    uint16_t noise = 20, range = 2000;
+    uint16_t sweepNoise[3] = {0, 0, 0};
+    uint16_t sweepRange[3] = {0, 0, 0};
+    Input    input = Input::Filtered;
+    uint32_t tolPre = 2, tolPost = 25;
+    bool     synth = false;
+    bool     wake = false;
+    const char* dumpDir = nullptr;
+    uint32_t repeat = 20;
+    std::vector<std::string> files;
+  };
+
+  struct Score {
+    uint32_t labels = 0, detections = 0, tp = 0;
+    std::vector<int32_t> latency;                       // 샘플 단위
+    uint64_t samples = 0;
+
+    double precision() const { return detections ? (double)tp / detections : 1.0; }
+    double recall()    const { return labels ? (double)tp / labels : 1.0; }
+    double f1() const {
+      const double p = precision(), r = recall();
+      return (p + r) > 0 ? 2 * p * r / (p + r) : 0.0;
+    }
+    void merge(const Score& o) {
+      labels += o.labels; detections += o.detections; tp += o.tp; samples += o.samples;
+      latency.insert(latency.end(), o.latency.begin(), o.latency.end());
+    }
+    int32_t latencyPct(double q) {
+      if (latency.empty()) return -1;
+      std::sort(latency.begin(), latency.end());
+      return latency[std::min(latency.size() - 1, (size_t)(q * latency.size()))];
+    }
+    double latencyMean() const {
+      if (latency.empty()) return 0;
+      double s = 0;
+      for (int32_t v : latency) s += v;
+      return s / latency.size();
+    }
+  };
+
+  // 감지기 입력 시퀀스 (필터는 트레이스마다 한 번만 적용)
+  struct Samples {
+    std::vector<uint16_t> mm;
+    std::vector<uint32_t> tUs;
+    size_t size() const { return mm.size(); }
+  };
+
+  Samples inputOf(const Trace& t, Input mode) {
+    Samples v;
+    v.mm.resize(t.recs.size());
+    v.tUs.resize(t.recs.size());
+    FilterChain chain;
+    for (size_t i = 0; i < v.size(); ++i) {
+      const auto& r = t.recs[i];
+      v.tUs[i] = r.tUs;
+      switch (mode) {
+        case Input::Raw:      v.mm[i] = r.raw; break;
+        case Input::Recorded: v.mm[i] = r.mm;  break;
+        case Input::Filtered: v.mm[i] = r.raw ? chain.push(r.raw) : 0; break;   // 무효 측정은 펌웨어처럼 필터 밖
+      }
+    }
+    return v;
+  }
+
+  // 반복 지표 평균 (takeRep 으로 확정된 것만)
+  struct MetricSum {
+    uint32_t n = 0;
+    uint64_t rom = 0, ecc = 0, con = 0, peak = 0, mean = 0;
+    void add(const TrendDetector::RepMetrics& m) {
+      n++; rom += m.romMm; ecc += m.eccentricMs; con += m.concentricMs; peak += m.peakVelMms; mean += m.meanVelMms;
+    }
+  };
+
+  std::vector<uint32_t> detect(const Samples& in, const TrendDetector::Params& p, MetricSum* ms = nullptr) {
+    std::vector<uint32_t> hits;
+    TrendDetector det(p);
+    TrendDetector::RepMetrics m;
+    for (uint32_t i = 0; i < in.size(); ++i) {
+      if (det.step(in.mm[i], in.tUs[i])) hits.push_back(i);
+      if (det.takeRep(m) && ms) ms->add(m);
+    }
+    return hits;
+  }
+
+  // 정답마다 [l - pre, l + post] 안의 아직 안 쓴 가장 이른 감지와 짝지음
+  Score score(const std::vector<uint32_t>& labels, const std::vector<uint32_t>& hits,
+              const Options& o) {
+    Score s;
+    s.labels = labels.size();
+    s.detections = hits.size();
+    size_t h = 0;
+    for (uint32_t l : labels) {
+      const uint32_t lo = l > o.tolPre ? l - o.tolPre : 0;
+      while (h < hits.size() && hits[h] < lo) h++;
+      if (h < hits.size() && hits[h] <= l + o.tolPost) {
+        s.tp++;
+        s.latency.push_back((int32_t)hits[h] - (int32_t)l);
+        h++;
+      }
+    }
+    return s;
+  }
+
+  // ---------- 절전 복귀 ----------
+  // 센서 주기는 PowerManager::Config::profiles 와 같게
+  struct WakeCase { const char* name; uint32_t periodUs; };
+  const WakeCase kWakeCases[] = { {"idle", 250000}, {"asleep", 1000000} };
+  constexpr uint32_t kAwakePeriodUs = 50000;   // BetweenSets
+  constexpr uint32_t kSwitchUs      = 40000;   // setTiming → 연속 측정 재시작 후 첫 샘플
+  constexpr uint16_t kWakeDeltaMm   = 60;      // PowerManager::Config::wakeDeltaMm
+
+  struct WakeRun {
+    bool     woke     = false;
+    bool     firstRep = false;   // 첫 정답 반복을 셈 (다음 반복 정답 전까지의 감지)
+    int32_t  wakeMs   = 0;       // 깨어난 시각 - 첫 정답 시각 (음수 = 최저점 전에 깸)
+    int32_t  countMs  = 0;       // 감지 시각 - 첫 정답 시각
+  };
+
+  // phaseUs 부터 절전 주기로 샘플링. MotionDetect 가 Probe/Motion 을 내면 PowerManager 처럼
+  // BetweenSets 주기로 바꾸고 (DistanceSensor::applyTiming_ 처럼) 필터 초기화. 감지기는 계속 같은 것
+  WakeRun replayWake(const Trace& t, uint32_t periodUs, uint32_t phaseUs,
+                     const TrendDetector::Params& p, const Options& o) {
+    WakeRun run;
+    if (t.labels.empty()) return run;
+    FilterChain   chain;
+    MotionDetect  motion(kWakeDeltaMm);
+    TrendDetector det(p);
+    TrendDetector::RepMetrics m;
+    std::vector<uint32_t> hits;
+    bool     sleepy = true;
+    uint32_t nextUs = t.recs.empty() ? 0 : t.recs[0].tUs + phaseUs;
+    for (uint32_t i = 0; i < t.recs.size(); ++i) {
+      const auto& r = t.recs[i];
+      if ((int32_t)(r.tUs - nextUs) < 0) continue;
+      nextUs = r.tUs + (sleepy ? periodUs : kAwakePeriodUs);
+      const uint16_t mm = chain.push(r.raw);
+      if (det.step(mm, r.tUs)) hits.push_back(i);
+      det.takeRep(m);
+      if (motion.push(mm, r.raw, sleepy) != MotionDetect::Result::None && sleepy) {
+        sleepy = false;
+        run.woke = true;
+        chain.reset();
+        nextUs = r.tUs + kSwitchUs;
+        run.wakeMs = ((int32_t)r.tUs - (int32_t)t.recs[t.labels[0]].tUs) / 1000;
+      }
+    }
+    // 지연이 tol-post 보다 길어도 다음 반복 전이면 첫 반복을 센 것 (필터 초기화 직후라 조금 늦을 수 있음)
+    const uint32_t l0 = t.labels[0];
+    const uint32_t lo = l0 > o.tolPre ? l0 - o.tolPre : 0;
+    const uint32_t hi = t.labels.size() > 1 ? t.labels[1] - o.tolPre : (uint32_t)t.recs.size();
+    for (uint32_t h : hits) {
+      if (h < lo || h >= hi) continue;
+      run.firstRep = true;
+      run.countMs  = ((int32_t)t.recs[h].tUs - (int32_t)t.recs[l0].tUs) / 1000;
+      break;
+    }
+    return run;
+  }
+
+  // 트레이스 × 절전 상태마다 20ms 간격 위상 전부
+  //  - 최대 속도로도 첫 반복을 못 세는 트레이스는 감지기 한계라 판정에서 뺌 (skip)
+  bool wakeCheck(const std::vector<Trace>& traces, const TrendDetector::Params& p, const Options& o) {
+    printf("%-24s %-7s %6s %6s %8s %8s %8s\n", "trace", "state", "phases", "first", "wakeAvg", "wakeMax", "countMax");
+    bool ok = true;
+    for (const auto& t : traces) {
+      if (!replayWake(t, 1, 0, p, o).firstRep) {   // 주기 1us = 모든 샘플
+        printf("%-24s %-7s %6s   (first rep not counted at full rate)\n", t.name.c_str(), "-", "skip");
+        continue;
+      }
+      for (const auto& c : kWakeCases) {
+        uint32_t phases = 0, caught = 0;
+        int64_t  sum = 0;
+        int32_t  worst = INT32_MIN, countMax = INT32_MIN;
+        for (uint32_t ph = 0; ph < c.periodUs; ph += 20000) {
+          const WakeRun r = replayWake(t, c.periodUs, ph, p, o);
+          phases++;
+          caught += r.woke && r.firstRep;
+          sum += r.wakeMs;
+          worst = std::max(worst, r.wakeMs);
+          if (r.firstRep) countMax = std::max(countMax, r.countMs);
+        }
+        printf("%-24s %-7s %6u %6u %7.0fms %7dms %7dms\n", t.name.c_str(), c.name, phases, caught,
+               phases ? (double)sum / phases : 0.0, worst, countMax);
+        ok = ok && caught == phases;
+      }
+    }
+    printf("\nfirst rep after wake: %s\n", ok ? "all counted" : "MISSED");
+    return ok;
+  }
+
+  // step() 만 반복 측정 (입력 준비/매칭 제외)
+  double throughput(const std::vector<Samples>& inputs,
+                    const TrendDetector::Params& p, uint32_t repeat) {
+    uint64_t n = 0;
+    uint32_t hits = 0;
+    TrendDetector::RepMetrics m;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t k = 0; k < repeat; ++k) {
+      for (const auto& in : inputs) {
+        TrendDetector det(p);
+        for (size_t i = 0; i < in.size(); ++i) {
+          hits += det.step(in.mm[i], in.tUs[i]);
+          hits += det.takeRep(m);
+        }
+        n += in.size();
+      }
+    }
+    const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    g_sink = hits;
+    return s > 0 ? n / s : 0;
+  }
+
+  bool parseRange(const char* s, uint16_t out[3]) {
+    unsigned a, b, c;
+    if (sscanf(s, "%u:%u:%u", &a, &b, &c) != 3 || c == 0 || b < a) return false;
+    out[0] = (uint16_t)a; out[1] = (uint16_t)b; out[2] = (uint16_t)c;
+    return true;
+  }
+
+  int usage() {
+    fprintf(stderr,
+      "usage: trend_replay [--noise N] [--range N] [--sweep-noise a:b:s] [--sweep-range a:b:s]\n"
+      "                    [--input raw|filtered|recorded] [--tol-pre N] [--tol-post N]\n"
+      "                    [--synth] [--dump DIR] [--repeat N] [--wake] [trace ...]\n");
+    return 2;
+  }
+
+  bool parseArgs(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+      const std::string a = argv[i];
+      const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+      auto num = [&](uint32_t& dst) { if (!v) return false; dst = (uint32_t)strtoul(v, nullptr, 10); ++i; return true; };
+      uint32_t tmp;
+      if      (a == "--noise")       { if (!num(tmp)) return false; o.noise = (uint16_t)tmp; }
+      else if (a == "--range")       { if (!num(tmp)) return false; o.range = (uint16_t)tmp; }
+      else if (a == "--tol-pre")     { if (!num(o.tolPre)) return false; }
+      else if (a == "--tol-post")    { if (!num(o.tolPost)) return false; }
+      else if (a == "--repeat")      { if (!num(o.repeat)) return false; }
+      else if (a == "--sweep-noise") { if (!v || !parseRange(v, o.sweepNoise)) return false; ++i; }
+      else if (a == "--sweep-range") { if (!v || !parseRange(v, o.sweepRange)) return false; ++i; }
+      else if (a == "--synth")       { o.synth = true; }
+      else if (a == "--wake")        { o.wake = true; }
+      else if (a == "--dump")        { if (!v) return false; o.dumpDir = v; ++i; }
+      else if (a == "--input") {
+        if (!v) return false;
+        const std::string m = v; ++i;
+        if      (m == "raw")      o.input = Input::Raw;
+        else if (m == "filtered") o.input = Input::Filtered;
+        else if (m == "recorded") o.input = Input::Recorded;
+        else return false;
+      }
+      else if (a.size() > 1 && a[0] == '-') return false;
+      else o.files.push_back(a);
+    }
+    return true;
+  }
+
+  void printRow(const char* name, uint16_t noise, uint16_t range, Score& s, double sps) {
+    printf("%-24s %5u %6u %6u %6u %6u  %6.3f %6.3f %6.3f  %6.1f %4d %4d %4d  %8.2f\n",
+           name, noise, range, s.labels, s.detections, s.tp,
+           s.precision(), s.recall(), s.f1(),
+           s.latencyMean(), s.latencyPct(0.5), s.latencyPct(0.95), s.latencyPct(1.0),
+           sps / 1e6);
+  }
+
+  void printHeader() {
+    printf("%-24s %5s %6s %6s %6s %6s  %6s %6s %6s  %6s %4s %4s %4s  %8s\n",
+           "trace", "noise", "range", "label", "det", "tp", "prec", "recall", "F1",
+           "latAvg", "p50", "p95", "max", "Msamp/s");
+  }
+}
+
+int main(int argc, char** argv) {
+  Options o;
+  if (!parseArgs(argc, argv, o)) return usage();
+
+  std::vector<Trace> traces;
+  for (const auto& f : o.files) {
+    Trace t;
+    std::string err;
+    if (!loadTrace(f, t, err)) { fprintf(stderr, "%s: %s\n", f.c_str(), err.c_str()); return 1; }
+    traces.push_back(std::move(t));
+  }
+  if (o.synth || traces.empty() || o.dumpDir) {
+    for (auto& t : synthCorpus(0x6B1D)) traces.push_back(std::move(t));
+  }
+
+  if (o.dumpDir) {
+    for (const auto& t : traces) {
+      const std::string path = std::string(o.dumpDir) + "/" + t.name + ".csv";
+      if (!saveTraceCsv(path, t)) { fprintf(stderr, "write failed: %s\n", path.c_str()); return 1; }
+      printf("wrote %s (%zu samples, %zu reps)\n", path.c_str(), t.recs.size(), t.labels.size());
+    }
+    return 0;
+  }
+
+  if (o.wake) return wakeCheck(traces, TrendDetector::Params(o.noise, o.range), o) ? 0 : 1;
+
+  std::vector<Samples> inputs;
+  for (const auto& t : traces) inputs.push_back(inputOf(t, o.input));
+
+  // 단일 파라미터: 트레이스별 + 합계
+  const bool sweep = o.sweepNoise[2] || o.sweepRange[2];
+  if (!sweep) {
+    const TrendDetector::Params p(o.noise, o.range);
+    printHeader();
+    Score total;
+    std::vector<MetricSum> metrics(traces.size());
+    for (size_t i = 0; i < traces.size(); ++i) {
+      Score s = score(traces[i].labels, detect(inputs[i], p, &metrics[i]), o);
+      s.samples = inputs[i].size();
+      printRow(traces[i].name.c_str(), o.noise, o.range, s, throughput({inputs[i]}, p, o.repeat));
+      total.merge(s);
+    }
+    printRow("TOTAL", o.noise, o.range, total, throughput(inputs, p, o.repeat));
+
+    printf("\n%-24s %5s %7s %7s %7s %8s %8s\n", "trace", "reps", "romMm", "eccMs", "conMs", "peakMms", "meanMms");
+    for (size_t i = 0; i < traces.size(); ++i) {
+      const auto& m = metrics[i];
+      const double n = m.n ? m.n : 1;
+      printf("%-24s %5u %7.0f %7.0f %7.0f %8.0f %8.0f\n", traces[i].name.c_str(), m.n,
+             m.rom / n, m.ecc / n, m.con / n, m.peak / n, m.mean / n);
+    }
+    return 0;
+  }
+
+  // 스윕: 파라미터 조합마다 전체 합계, 마지막에 F1 최고(동률이면 평균 지연이 짧은 쪽)
+  const uint16_t n0 = o.sweepNoise[2] ? o.sweepNoise[0] : o.noise;
+  const uint16_t n1 = o.sweepNoise[2] ? o.sweepNoise[1] : o.noise;
+  const uint16_t ns = o.sweepNoise[2] ? o.sweepNoise[2] : 1;
+  const uint16_t r0 = o.sweepRange[2] ? o.sweepRange[0] : o.range;
+  const uint16_t r1 = o.sweepRange[2] ? o.sweepRange[1] : o.range;
+  const uint16_t rs = o.sweepRange[2] ? o.sweepRange[2] : 1;
+
+  printHeader();
+  double bestF1 = -1, bestLat = 0;
+  uint16_t bestN = 0, bestR = 0;
+  for (uint32_t r = r0; r <= r1; r += rs) {
+    for (uint32_t n = n0; n <= n1; n += ns) {
+      const TrendDetector::Params p((uint16_t)n, (uint16_t)r);
+      Score total;
+      for (size_t i = 0; i < traces.size(); ++i) {
+        Score s = score(traces[i].labels, detect(inputs[i], p), o);
+        s.samples = inputs[i].size();
+        total.merge(s);
+      }
+      const double f1 = total.f1(), lat = total.latencyMean();
+      if (f1 > bestF1 + 1e-9 || (f1 > bestF1 - 1e-9 && lat < bestLat)) {
+        bestF1 = f1; bestLat = lat; bestN = (uint16_t)n; bestR = (uint16_t)r;
+      }
+      printRow("sweep", (uint16_t)n, (uint16_t)r, total, throughput(inputs, p, std::max(1u, o.repeat / 4)));
+    }
+  }
+  printf("\nbest: noise_mm=%u max_range_mm=%u  F1=%.3f  latAvg=%.1f samples\n", bestN, bestR, bestF1, bestLat);
+  return 0;
+}
@@ -0,0 +1,21 @@
+#pragma once
+// 호스트(Linux) 빌드용 최소 Arduino 대체 헤더
+// 펌웨어 코드 중 하드웨어에 의존하지 않는 모듈(trend, event codec 등)만 컴파일하기 위한 것
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include "WString.h"
+
+using std::min;
+using std::max;
+
+inline uint32_t micros() {
+  using namespace std::chrono;
+  static const auto t0 = steady_clock::now();
+  return (uint32_t)duration_cast<microseconds>(steady_clock::now() - t0).count();
+}
+inline uint32_t millis() { return micros() / 1000; }
@@ -0,0 +1,69 @@
+#pragma once
+// Arduino(ESP32) String 의 할당 패턴을 흉내 낸 호스트용 구현
+//  - 11 바이트 이하 SSO, 그 이상은 필요한 만큼 정확히 재할당 (WString::changeBuffer 와 동일)
+//  - 할당은 new[] 로 해서 벤치마크가 operator new 를 세면 그대로 잡히도록 함
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+
+class String {
+public:
+  String() { sso_[0] = '\0'; }
+  String(const char* s) { sso_[0] = '\0'; assign_(s, strlen(s)); }
+  String(const String& o) { sso_[0] = '\0'; assign_(o.c_str(), o.len_); }
+  String(String&& o) noexcept : heap_(o.heap_), cap_(o.cap_), len_(o.len_) {
+    memcpy(sso_, o.sso_, sizeof(sso_));
+    o.heap_ = nullptr; o.len_ = 0; o.sso_[0] = '\0';
+  }
+  explicit String(unsigned long v) { char b[12]; int n = snprintf(b, sizeof(b), "%lu", v); sso_[0] = '\0'; assign_(b, n); }
+  explicit String(unsigned int v) : String((unsigned long)v) {}
+  explicit String(int v) { char b[12]; int n = snprintf(b, sizeof(b), "%d", v); sso_[0] = '\0'; assign_(b, n); }
+  ~String() { if (heap_) delete[] heap_; }
+
+  String& operator=(const String& o) { if (this != &o) { len_ = 0; assign_(o.c_str(), o.len_); } return *this; }
+
+  const char* c_str() const { return heap_ ? heap_ : sso_; }
+  size_t length() const { return len_; }
+
+  String& concat(const char* s, size_t n) {
+    reserve_(len_ + n);
+    memcpy(buf_() + len_, s, n);
+    len_ += n;
+    buf_()[len_] = '\0';
+    return *this;
+  }
+  String& operator+=(const char* s)   { return concat(s, strlen(s)); }
+  String& operator+=(const String& s) { return concat(s.c_str(), s.len_); }
+
+  // Arduino 의 StringSumHelper 처럼 왼쪽 임시 객체에 이어 붙임 (복사 없음)
+  friend String operator+(String&& a, const char* b)   { a += b; return static_cast<String&&>(a); }
+  friend String operator+(String&& a, const String& b) { a += b; return static_cast<String&&>(a); }
+  friend String operator+(const String& a, const char* b)   { return String(a) + b; }
+  friend String operator+(const String& a, const String& b) { return String(a) + b; }
+
+private:
+  static constexpr size_t kSso = 11;
+
+  char* buf_() { return heap_ ? heap_ : sso_; }
+  void reserve_(size_t n) {
+    const size_t cap = heap_ ? cap_ : kSso;
+    if (n <= cap) return;
+    char* nb = new char[n + 1];
+    memcpy(nb, c_str(), len_ + 1);
+    if (heap_) delete[] heap_;
+    heap_ = nb;
+    cap_ = n;
+  }
+  void assign_(const char* s, size_t n) {
+    reserve_(n);
+    memcpy(buf_(), s, n);
+    len_ = n;
+    buf_()[n] = '\0';
+  }
+
+  char   sso_[kSso + 1];
+  char*  heap_ = nullptr;
+  size_t cap_ = 0;
+  size_t len_ = 0;
+};
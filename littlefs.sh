@@ -8,9 +8,10 @@ SCHEME_FILE="default.csv"       # partitions CSV 파일명
 SKETCH_DIR="$(pwd)"
 METHOD="ota"                    # ota | serial
 DEVICE_IP=""                    # METHOD=ota 일 때 필요
+AUTH=""                         # METHOD=ota: user:pass (Basic Auth)
 
 # 인자 파싱
-while getopts "p:b:s:d:m:i:" opt; do
+while getopts "p:b:s:d:m:i:u:" opt; do
   case "$opt" in
     p) PORT="$OPTARG" ;;
     b) BAUD="$OPTARG" ;;
@@ -18,6 +19,7 @@ while getopts "p:b:s:d:m:i:" opt; do
     d) SKETCH_DIR="$OPTARG" ;;
     m) METHOD="$OPTARG" ;;         # ota | serial
     i) DEVICE_IP="$OPTARG" ;;
+    u) AUTH="$OPTARG" ;;
   esac
 done
 
@@ -45,6 +47,8 @@ fi
 # 데이터 폴더
 DATA_DIR="$SKETCH_DIR/data"
 [ -d "$DATA_DIR" ] || { echo "[little.sh] data/ 폴더 없음: $DATA_DIR"; exit 1; }
+FS_DIR="$SKETCH_DIR/_fs_data"
+zsh "$SKETCH_DIR/assets.sh" "$DATA_DIR" "$FS_DIR"   # gzip 자산 + 매니페스트
 
 # CSV에서 FS offset/size 추출(공백 제거)
 OFFSET_HEX="$(awk -F, 'tolower($1)~/(littlefs|spiffs)/{o=$4; gsub(/[[:space:]]/,"",o); print o; exit}' "$PARTCSV")"
@@ -64,15 +68,14 @@ TMPDIR="$SKETCH_DIR/_arduino_tmp"
 mkdir -p "$TMPDIR"
 export TMPDIR
 echo "[little.sh] littlefs.bin 생성..."
-"$MKLFS" -c "$DATA_DIR" -s "$SIZE_DEC" -p 256 -b 4096 littlefs.bin
+"$MKLFS" -c "$FS_DIR" -s "$SIZE_DEC" -p 256 -b 4096 littlefs.bin
 ls -lh littlefs.bin
 
 # 업로드 방법 분기
 if [ "$METHOD" = "ota" ] && [ -n "$DEVICE_IP" ]; then
-  # OTA (/fsupdate 엔드포인트 필요)
-  echo "[little.sh] OTA 업로드 → http://$DEVICE_IP/fsupdate"
-  # 인증이 필요하면 여기에 -u user:pass 또는 -H 'Authorization: ...' 추가
-  curl -sf -F "update=@littlefs.bin" "http://$DEVICE_IP/fsupdate"
+  # OTA (/api/ota/*: gzip + sha256 + 이어받기, ota.sh)
+  echo "[little.sh] OTA 업로드 → http://$DEVICE_IP/api/ota"
+  zsh "$SKETCH_DIR/ota.sh" -i "$DEVICE_IP" -t fs -f littlefs.bin ${AUTH:+-u "$AUTH"}
   echo "[little.sh] OTA 완료 (기기 재시작 후 LittleFS.begin(false) 확인)"
   exit 0
 fi
@@ -0,0 +1,86 @@
+#!/usr/bin/env zsh
+set -e
+
+# HTTP OTA (이어받기): 이미지를 gzip 으로 줄여 /api/ota/* 로 조각 업로드
+#   zsh ota.sh -i DEVICE_IP -t fw|fs -f image.bin [-u admin:pass] [-c CHUNK_BYTES]
+#   - sha256 은 원본(.bin) 기준 → 기기가 풀어 쓴 결과와 비교
+#   - 조각 전송이 실패하면 기기의 offset 을 다시 물어 그 자리부터 재전송
+#   - 같은 부팅 안이면 스크립트를 다시 실행해도 이어서 보냄
+
+DEVICE_IP=""
+TARGET="fw"
+IMAGE=""
+AUTH=""
+CHUNK=65536
+RETRIES=20
+
+while getopts "i:t:f:u:c:" opt; do
+  case "$opt" in
+    i) DEVICE_IP="$OPTARG" ;;
+    t) TARGET="$OPTARG" ;;        # fw | fs
+    f) IMAGE="$OPTARG" ;;
+    u) AUTH="$OPTARG" ;;          # user:pass (Basic Auth)
+    c) CHUNK="$OPTARG" ;;
+  esac
+done
+
+if [ -z "$DEVICE_IP" ] || [ ! -f "$IMAGE" ]; then
+  echo "Usage: zsh ota.sh -i DEVICE_IP -t fw|fs -f image.bin [-u user:pass] [-c chunk]"
+  exit 1
+fi
+
+BASE="http://$DEVICE_IP/api/ota"
+CURL=(curl -sS --connect-timeout 5 --max-time 60)
+[ -n "$AUTH" ] && CURL+=(-u "$AUTH")
+
+# 원본 해시 (macOS shasum / Linux sha256sum)
+if command -v sha256sum >/dev/null 2>&1; then
+  SHA="$(sha256sum "$IMAGE" | cut -d' ' -f1)"
+else
+  SHA="$(shasum -a 256 "$IMAGE" | cut -d' ' -f1)"
+fi
+RAW_SIZE=$(wc -c < "$IMAGE" | tr -d ' ')
+
+GZ="${IMAGE}.gz"
+gzip -9 -n -c "$IMAGE" > "$GZ"
+SIZE=$(wc -c < "$GZ" | tr -d ' ')
+echo "[ota.sh] $IMAGE: $RAW_SIZE B → gzip $SIZE B ($(( SIZE * 100 / RAW_SIZE ))%)"
+
+json_num() { sed -n "s/.*\"$1\": *\([0-9]*\).*/\1/p"; }
+
+RESP="$("${CURL[@]}" -f -X POST "$BASE/begin?target=$TARGET&size=$SIZE&rawSize=$RAW_SIZE&sha256=$SHA")"
+OFFSET="$(echo "$RESP" | json_num offset)"
+[ -n "$OFFSET" ] || { echo "[ota.sh] begin 실패: $RESP"; exit 1; }
+[ "$OFFSET" -gt 0 ] && echo "[ota.sh] 이어받기: $OFFSET B 부터"
+
+T0=$(date +%s)
+FAILS=0
+while [ "$OFFSET" -lt "$SIZE" ]; do
+  if RESP="$(tail -c +$(( OFFSET + 1 )) "$GZ" | head -c "$CHUNK" |
+             "${CURL[@]}" -X PUT -H "Content-Type: application/octet-stream" \
+               --data-binary @- "$BASE/chunk?offset=$OFFSET")"; then
+    NEXT="$(echo "$RESP" | json_num offset)"
+  else
+    NEXT=""
+  fi
+  if [ -z "$NEXT" ] || [ "$NEXT" -le "$OFFSET" ]; then
+    FAILS=$(( FAILS + 1 ))
+    [ "$FAILS" -le "$RETRIES" ] || { echo "[ota.sh] 재시도 초과 @$OFFSET"; exit 1; }
+    sleep 1
+    # 끊긴 조각 중 기기가 이미 반영한 만큼은 건너뜀
+    NEXT="$("${CURL[@]}" "$BASE/status" | json_num offset)"
+    [ -n "$NEXT" ] || NEXT=$OFFSET
+    echo "[ota.sh] 재전송 @$NEXT ($FAILS/$RETRIES)"
+  else
+    FAILS=0
+  fi
+  OFFSET=$NEXT
+  printf "\r[ota.sh] %d / %d B" "$OFFSET" "$SIZE"
+done
+echo
+
+RESP="$("${CURL[@]}" -X POST "$BASE/finish" || true)"
+echo "[ota.sh] finish: $RESP ($(( $(date +%s) - T0 ))s)"
+echo "$RESP" | grep -q '"ok":true' || exit 1
+rm -f "$GZ"
+echo "[ota.sh] 완료 (기기 재시작)"
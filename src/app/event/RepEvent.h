@@ -0,0 +1,25 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// 센서 태스크 → 업링크 태스크로 넘기는 1회 반복(rep) 이벤트
+// 큐에 값 복사로 들어가므로 POD 로 유지할 것
+// EventLog 에 바이너리로 남으므로 필드는 뒤에만 추가 (앞 12바이트 = 구버전 레코드)
+struct RepEvent {
+  uint32_t ts;      // epoch seconds (time(nullptr))
+  uint32_t ms;      // millis() 시점
+  uint16_t minv;    // 하강 최저점(mm)
+  uint16_t maxv;    // 반등 최고점(mm)
+  // 반복 지표 (TrendDetector::RepMetrics)
+  uint16_t romMm;
+  uint16_t eccentricMs;
+  uint16_t concentricMs;
+  uint16_t tutMs;
+  uint16_t peakVelMms;
+  uint16_t meanVelMms;
+  // 세션 태그 (업링크 태스크가 SessionManager::stamp 로 채움, 0 = 세션 없음)
+  uint8_t  tagLen;
+  uint8_t  tag[10];
+};
+
+constexpr size_t kRepEventV1Size = 12;   // 지표 추가 전 레코드 크기
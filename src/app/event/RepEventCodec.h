@@ -0,0 +1,95 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "RepEvent.h"
+#include "src/util/json_writer.h"
+
+// 이벤트 → JSON 인코더 (고정 버퍼, 힙 할당 없음)
+//  - 필드 목록은 EventSchema<T> 특수화로 컴파일 타임에 고정
+//  - 숫자 필드는 숫자로 내보냄 ("minDistance":123)
+//  - 최대 본문 크기도 스키마에서 constexpr 로 계산 → 버퍼 크기를 static_assert 로 검증 가능
+
+namespace EventCodec {
+
+  enum class FieldType : uint8_t { U16, U32 };
+
+  struct FieldDesc {
+    const char* key;
+    FieldType   type;
+    uint16_t    offset;
+  };
+
+  // 모든 이벤트 공통으로 앞에 붙는 문맥 필드
+  struct Context {
+    const char* deviceId;
+    const char* tagId;
+    const char* memberId = nullptr;     // nullptr 이면 member_id 생략
+  };
+  constexpr size_t kDeviceIdMax = 32;   // 이스케이프 전 길이 상한
+  constexpr size_t kTagIdMax    = 24;
+  constexpr size_t kMemberIdMax = 20;
+
+  template <typename T> struct EventSchema;
+
+  template <> struct EventSchema<RepEvent> {
+    static constexpr FieldDesc kFields[] = {
+      {"minDistance", FieldType::U16, offsetof(RepEvent, minv)},
+      {"maxDistance", FieldType::U16, offsetof(RepEvent, maxv)},
+      {"ts",          FieldType::U32, offsetof(RepEvent, ts)},
+      {"romMm",       FieldType::U16, offsetof(RepEvent, romMm)},
+      {"eccentricMs", FieldType::U16, offsetof(RepEvent, eccentricMs)},
+      {"concentricMs",FieldType::U16, offsetof(RepEvent, concentricMs)},
+      {"tutMs",       FieldType::U16, offsetof(RepEvent, tutMs)},
+      {"peakVelMms",  FieldType::U16, offsetof(RepEvent, peakVelMms)},
+      {"meanVelMms",  FieldType::U16, offsetof(RepEvent, meanVelMms)},
+    };
+  };
+
+  // ---------- 컴파일 타임 크기 계산 ----------
+
+  constexpr size_t cstrlen(const char* s) { return *s ? 1 + cstrlen(s + 1) : 0; }
+
+  constexpr size_t maxDigits(FieldType t) { return t == FieldType::U16 ? 5 : 10; }
+
+  // ,"key":value  (첫 필드도 ',' 자리 포함해 여유 있게)
+  constexpr size_t fieldBytes(const FieldDesc& f) { return 1 + cstrlen(f.key) + 3 + maxDigits(f.type); }
+
+  template <size_t N>
+  constexpr size_t fieldsBytes(const FieldDesc (&f)[N], size_t i = 0) {
+    return i < N ? fieldBytes(f[i]) + fieldsBytes(f, i + 1) : 0;
+  }
+
+  // 문자열은 최악의 경우 모든 문자가 \u00XX (6배)
+  constexpr size_t strFieldBytes(const char* key, size_t maxLen) { return 1 + cstrlen(key) + 3 + 2 + maxLen * 6; }
+
+  template <typename T>
+  constexpr size_t maxEncodedSize() {
+    return 2 /* {} */ + strFieldBytes("device_id", kDeviceIdMax) + strFieldBytes("tag_id", kTagIdMax) +
+           strFieldBytes("member_id", kMemberIdMax) + fieldsBytes(EventSchema<T>::kFields);
+  }
+
+  // ---------- 인코딩 ----------
+
+  inline void writeField(JsonWriter& w, const FieldDesc& f, const uint8_t* base) {
+    switch (f.type) {
+      case FieldType::U16: { uint16_t v; memcpy(&v, base + f.offset, sizeof(v)); w.field(f.key, (uint32_t)v); break; }
+      case FieldType::U32: { uint32_t v; memcpy(&v, base + f.offset, sizeof(v)); w.field(f.key, v); break; }
+    }
+  }
+
+  // out 에 JSON 객체를 쓰고 길이 반환. 버퍼 부족 시 0
+  template <typename T>
+  size_t encode(const T& ev, const Context& ctx, char* out, size_t cap) {
+    JsonWriter w(out, cap);
+    w.beginObject();
+    w.field("device_id", ctx.deviceId);
+    w.field("tag_id", ctx.tagId);
+    if (ctx.memberId) w.field("member_id", ctx.memberId);
+    const uint8_t* base = reinterpret_cast<const uint8_t*>(&ev);
+    for (const auto& f : EventSchema<T>::kFields) writeField(w, f, base);
+    w.endObject();
+    return w.ok() ? w.size() : 0;
+  }
+
+} // namespace EventCodec
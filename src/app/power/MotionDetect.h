@@ -0,0 +1,44 @@
+#pragma once
+#include <stdint.h>
+
+// 거리 기준선(EMA) 대비 움직임 판정 — PowerManager 가 샘플마다 호출 (호스트 리플레이도 같은 코드)
+//  - Motion : 필터 출력이 기준선에서 deltaMm 이상 벗어난 샘플이 kNeeded 개 연속 (이상치 1개로는 안 깸)
+//  - Probe  : 절전 상태(샘플이 드묾)에서 원값 1개가 벗어남 → 곧바로 최대 속도로 확인
+//      드문 샘플에서는 필터(Hampel 창 7개 = 수 초)가 첫 움직임을 이상치로 깎아 Motion 이 늦음
+//  - 힙/부동소수 없음, 단일 태스크 전용
+class MotionDetect {
+public:
+  enum class Result : uint8_t { None, Probe, Motion };
+
+  static constexpr uint8_t kNeeded    = 2;
+  static constexpr uint8_t kBaseShift = 4;   // 기준선 EMA (1/16)
+
+  explicit MotionDetect(uint16_t deltaMm = 60) : delta_(deltaMm) {}
+
+  void setDelta(uint16_t mm) { delta_ = mm; }
+  void reset() { baseX16_ = -1; over_ = 0; }
+
+  // mm: 필터 출력, raw: 센서 원값, sleepy: Idle/Asleep
+  Result push(uint16_t mm, uint16_t raw, bool sleepy) {
+    if (baseX16_ < 0) { baseX16_ = (int32_t)mm << kBaseShift; return Result::None; }
+    const int32_t base = baseX16_ >> kBaseShift;
+    baseX16_ += (((int32_t)mm << kBaseShift) - baseX16_) >> kBaseShift;   // 멈춘 새 위치에는 천천히 적응
+
+    if (out_(mm, base)) {
+      if (++over_ >= kNeeded) { over_ = 0; return Result::Motion; }
+    } else {
+      over_ = 0;
+    }
+    return sleepy && out_(raw, base) ? Result::Probe : Result::None;
+  }
+
+private:
+  bool out_(uint16_t v, int32_t base) const {
+    const int32_t d = (int32_t)v - base;
+    return (d < 0 ? -d : d) >= delta_;
+  }
+
+  uint16_t delta_;
+  int32_t  baseX16_ = -1;   // 기준선 * 16, -1 = 아직 없음
+  uint8_t  over_    = 0;
+};
@@ -0,0 +1,263 @@
+#include "PowerManager.h"
+#include "MotionDetect.h"
+#include <atomic>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#include <driver/gpio.h>
+#include <freertos/task.h>
+
+#include "src/app/runtime/Runtime.h"
+#include "src/devices/distance/DistanceSensor.h"
+#include "src/devices/laser/laser.h"
+#include "src/devices/power/power.h"
+#include "src/util/log/Log.h"
+#include "src/util/metrics/Metrics.h"
+
+namespace {
+  using PowerManager::State;
+  constexpr int kStates = (int)State::Count;
+
+  constexpr uint32_t kEvalMs       = 100;   // 상태 판정 주기 (알림이 오면 바로)
+  constexpr uint32_t kProbeMs      = 2000;  // Probe 로 깬 뒤 최대 속도로 움직임을 확인하는 시간
+
+  PowerManager::Config g_cfg;
+  DistanceSensor*      g_dist = nullptr;
+  TaskHandle_t         g_task = nullptr;
+
+  // 활동 시각 (millis). 여러 태스크에서 쓰고 pm 태스크가 읽음
+  std::atomic<uint32_t> g_lastRepMs{0};
+  std::atomic<uint32_t> g_lastMotionMs{0};
+  std::atomic<uint32_t> g_lastTagMs{0};
+  std::atomic<uint32_t> g_probeMs{0};       // 절전 중 원값 1개가 벗어난 시각
+  std::atomic<uint16_t> g_sensePeriodMs{0};
+  std::atomic<uint8_t>  g_state{(uint8_t)State::BetweenSets};
+
+  // 움직임 판정 (sense 태스크에서만)
+  MotionDetect g_motion;
+
+  // 통계 (pm 태스크에서만 갱신)
+  uint32_t g_enteredMs = 0;
+  uint32_t g_residencyMs[kStates] = {};
+  uint32_t g_transitions = 0;
+  uint32_t g_sleeps = 0, g_sleptMs = 0, g_sleptInStateMs = 0;
+  uint32_t g_wakeTimer = 0, g_wakeDist = 0, g_wakeNfc = 0;
+  float    g_estMah = 0.0f;
+
+  const char* const kNames[kStates] = { "active", "between", "idle", "asleep" };
+
+  Metrics::Gauge g_stateGauge("gymbuddy_power_state", "Power state (0=active 1=between 2=idle 3=asleep)",
+                              [] { return (float)g_state.load(std::memory_order_relaxed); });
+  Metrics::Gauge g_estMahGauge("gymbuddy_power_estimated_mah", "Estimated charge drawn since boot",
+                               [] { return PowerManager::stats().estMah; });
+  Metrics::Counter g_transitionsTotal("gymbuddy_power_transitions_total", "Power state transitions");
+  Metrics::Counter g_sleepsTotal("gymbuddy_light_sleeps_total", "Light sleep cycles");
+
+  // Asleep 은 잠든 비율만큼 sleepCurrentMa 로 가중
+  float estCurrentMa_(State s, uint32_t residencyMs, uint32_t sleptMs) {
+    const float awake = g_cfg.profiles[(int)s].estCurrentMa;
+    if (s != State::Asleep || !residencyMs) return awake;
+    const float f = sleptMs >= residencyMs ? 1.0f : (float)sleptMs / residencyMs;
+    return awake * (1.0f - f) + g_cfg.sleepCurrentMa * f;
+  }
+
+  // ms 구간 → mAh
+  void account_(State s, uint32_t ms, uint32_t sleptMs) {
+    g_residencyMs[(int)s] += ms;
+    g_estMah += estCurrentMa_(s, ms, sleptMs) * ms / 3600000.0f;
+  }
+
+  bool sleepAllowed_() {
+    if (!g_cfg.lightSleep || g_cfg.nfcIrqPin < 0) return false;   // 태그로 깨울 수 없으면 안 잠
+    return !g_cfg.canSleep || g_cfg.canSleep();
+  }
+
+  // 시각은 다른 태스크가 now 보다 조금 뒤에 찍었을 수 있음 → 음수면 0
+  uint32_t since_(uint32_t now, uint32_t t) {
+    const int32_t d = (int32_t)(now - t);
+    return d > 0 ? (uint32_t)d : 0;
+  }
+
+  State decide_(uint32_t now) {
+    const uint32_t rep = g_lastRepMs.load(std::memory_order_relaxed);
+    if (rep && since_(now, rep) < g_cfg.setIdleMs) return State::ActiveSet;
+    uint32_t quiet = rep ? since_(now, rep) : UINT32_MAX;
+    const uint32_t motion = since_(now, g_lastMotionMs.load(std::memory_order_relaxed));
+    const uint32_t tag    = g_lastTagMs.load(std::memory_order_relaxed);
+    if (motion < quiet) quiet = motion;
+    if (tag && since_(now, tag) < quiet) quiet = since_(now, tag);
+    if (quiet < g_cfg.restMs) return State::BetweenSets;
+    // 확인 중: 최대 속도로 샘플링. 움직임이 확인되지 않으면 kProbeMs 뒤 원래 상태로
+    const uint32_t probe = g_probeMs.load(std::memory_order_relaxed);
+    if (probe && since_(now, probe) < kProbeMs) return State::BetweenSets;
+    if (quiet < g_cfg.sleepAfterMs) return State::Idle;
+    return sleepAllowed_() ? State::Asleep : State::Idle;
+  }
+
+  void apply_(State s) {
+    const auto& p = g_cfg.profiles[(int)s];
+    if (g_dist) g_dist->setTiming(p.timingBudgetUs, p.periodMs);
+    g_sensePeriodMs.store(p.sensePeriodMs, std::memory_order_relaxed);
+    Laser::dim(p.laserScale);
+  }
+
+  void enter_(State next, uint32_t now) {
+    const State prev = (State)g_state.load(std::memory_order_relaxed);
+    const uint32_t stayed = now - g_enteredMs;
+    account_(prev, stayed, g_sleptInStateMs);
+    LOGI("PM", "%s -> %s after %lus (est %.0fmA) | total est %.1fmAh vbat %.2fV",
+         kNames[(int)prev], kNames[(int)next], (unsigned long)(stayed / 1000),
+         estCurrentMa_(prev, stayed, g_sleptInStateMs), g_estMah, Power::vbat());
+    g_enteredMs = now;
+    g_sleptInStateMs = 0;
+    g_transitions++;
+    g_transitionsTotal.inc();
+    g_state.store((uint8_t)next, std::memory_order_relaxed);
+    apply_(next);
+  }
+
+  // LOW 레벨 깨움. 대기 중 레벨 인터럽트가 계속 들어오지 않도록 인터럽트는 잠시 끔
+  bool armPin_(int pin) {
+    if (pin < 0 || gpio_get_level((gpio_num_t)pin) == 0) return false;   // 이미 LOW 면 바로 깨므로 생략
+    gpio_intr_disable((gpio_num_t)pin);
+    gpio_wakeup_enable((gpio_num_t)pin, GPIO_INTR_LOW_LEVEL);
+    return true;
+  }
+
+  void disarmPin_(int pin) {
+    gpio_wakeup_disable((gpio_num_t)pin);
+    gpio_set_intr_type((gpio_num_t)pin, GPIO_INTR_NEGEDGE);   // attachInterrupt(FALLING) 복원
+    gpio_intr_enable((gpio_num_t)pin);
+  }
+
+  // light sleep 1회. 잠든 동안 놓친 하강 에지는 깨어난 쪽에서 대신 알림
+  void sleepOnce_() {
+    const bool dist = armPin_(g_cfg.distIrqPin);
+    const bool nfc  = armPin_(g_cfg.nfcIrqPin);
+    if (dist || nfc) esp_sleep_enable_gpio_wakeup();
+    esp_sleep_enable_timer_wakeup((uint64_t)g_cfg.asleepWakeMs * 1000);
+
+    Log::flush();
+    Serial.flush();
+    const int64_t t0 = esp_timer_get_time();
+    const esp_err_t err = esp_light_sleep_start();
+    const uint32_t slept = (uint32_t)((esp_timer_get_time() - t0) / 1000);
+
+    if (dist) disarmPin_(g_cfg.distIrqPin);
+    if (nfc)  disarmPin_(g_cfg.nfcIrqPin);
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+    if (err != ESP_OK) {
+      LOGW("PM", "light sleep failed: %s", esp_err_to_name(err));
+      vTaskDelay(pdMS_TO_TICKS(g_cfg.asleepWakeMs));
+      return;
+    }
+    g_sleeps++;
+    g_sleepsTotal.inc();
+    g_sleptMs += slept;
+    g_sleptInStateMs += slept;
+
+    if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO) {
+      if (nfc && gpio_get_level((gpio_num_t)g_cfg.nfcIrqPin) == 0) {
+        g_wakeNfc++;
+        Runtime::kickNfc();
+      } else {
+        g_wakeDist++;
+      }
+    } else {
+      g_wakeTimer++;
+    }
+  }
+
+  void pmTask(void*) {
+    for (;;) {
+      const State cur = (State)g_state.load(std::memory_order_relaxed);
+      if (cur == State::Asleep) {
+        sleepOnce_();
+        // 센서 결과를 sense 태스크가 처리할 때까지 (onSample 이 알림) 깨어 있음
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(g_cfg.asleepAwakeMs));
+      } else {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(kEvalMs));
+      }
+      const uint32_t now = millis();
+      const State next = decide_(now);
+      if (next != (State)g_state.load(std::memory_order_relaxed)) enter_(next, now);
+    }
+  }
+}
+
+bool PowerManager::begin(DistanceSensor* distance, const Config& cfg) {
+  if (g_task) return true;
+  g_cfg  = cfg;
+  g_dist = distance;
+  g_motion.setDelta(cfg.wakeDeltaMm);
+  const uint32_t now = millis();
+  g_enteredMs = now;
+  g_lastMotionMs.store(now, std::memory_order_relaxed);   // 부팅 직후는 BetweenSets 에서 시작
+  g_state.store((uint8_t)State::BetweenSets, std::memory_order_relaxed);
+  apply_(State::BetweenSets);
+
+  if (xTaskCreatePinnedToCore(pmTask, "pm", cfg.stack, nullptr, cfg.prio, &g_task, cfg.core) != pdPASS) {
+    LOGE("PM", "task create failed");
+    g_task = nullptr;
+    apply_(State::ActiveSet);
+    return false;
+  }
+  LOGI("PM", "started (light sleep %s)", sleepAllowed_() ? "enabled" : "off: no wake pin/condition");
+  return true;
+}
+
+void PowerManager::onSample(uint16_t mm, uint16_t raw, uint32_t) {
+  const bool sleepy = g_state.load(std::memory_order_relaxed) >= (uint8_t)State::Idle;
+  switch (g_motion.push(mm, raw, sleepy)) {
+    case MotionDetect::Result::Motion:
+      g_lastMotionMs.store(millis(), std::memory_order_relaxed);
+      if (sleepy && g_task) xTaskNotifyGive(g_task);   // 바로 프로파일 복귀
+      break;
+    case MotionDetect::Result::Probe:
+      // 첫 샘플에서 바로 최대 속도로 (드문 샘플로 두 번 확인하면 첫 rep 를 놓침)
+      g_probeMs.store(millis() | 1, std::memory_order_relaxed);
+      if (g_task) xTaskNotifyGive(g_task);
+      break;
+    case MotionDetect::Result::None:
+      break;
+  }
+  // Asleep: 이번 깨움의 샘플을 처리했음 → 다시 잠들어도 됨
+  if (g_task && g_state.load(std::memory_order_relaxed) == (uint8_t)State::Asleep) xTaskNotifyGive(g_task);
+}
+
+void PowerManager::onRep() {
+  g_lastRepMs.store(millis() | 1, std::memory_order_relaxed);
+  if (g_task && g_state.load(std::memory_order_relaxed) != (uint8_t)State::ActiveSet) xTaskNotifyGive(g_task);
+}
+
+void PowerManager::onTag() {
+  g_lastTagMs.store(millis() | 1, std::memory_order_relaxed);
+  if (g_task && g_state.load(std::memory_order_relaxed) >= (uint8_t)State::Idle) xTaskNotifyGive(g_task);
+}
+
+uint32_t PowerManager::sensePeriodMs() {
+  return g_sensePeriodMs.load(std::memory_order_relaxed);
+}
+
+PowerManager::State PowerManager::state() {
+  return (State)g_state.load(std::memory_order_relaxed);
+}
+
+const char* PowerManager::stateName(State s) {
+  return (int)s < kStates ? kNames[(int)s] : "?";
+}
+
+PowerManager::Stats PowerManager::stats() {
+  Stats st{};
+  st.state = state();
+  memcpy(st.residencyMs, g_residencyMs, sizeof(st.residencyMs));
+  const uint32_t cur = g_task ? millis() - g_enteredMs : 0;
+  st.residencyMs[(int)st.state] += cur;
+  st.transitions = g_transitions;
+  st.sleeps      = g_sleeps;
+  st.sleptMs     = g_sleptMs;
+  st.wakeTimer   = g_wakeTimer;
+  st.wakeDist    = g_wakeDist;
+  st.wakeNfc     = g_wakeNfc;
+  st.estMah      = g_estMah + estCurrentMa_(st.state, cur, g_sleptInStateMs) * cur / 3600000.0f;
+  return st;
+}
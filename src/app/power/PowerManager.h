@@ -0,0 +1,77 @@
+#pragma once
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+
+class DistanceSensor;
+
+// 활동 상태별 절전 (기구는 하루 대부분 비어 있음)
+//   ActiveSet   : 마지막 rep 후 setIdleMs 이내 → 측정 최대 속도, 레이저 100%
+//   BetweenSets : 움직임/rep/태깅 후 restMs 이내 → 측정은 그대로(다음 세트 첫 rep), 레이저 어둡게
+//   Idle        : 그 이후 → 측정 예산/주기를 늘리고 레이저 끔, sense 주기도 늘림
+//   Asleep      : sleepAfterMs 이후 → 샘플 사이에 light sleep (타이머 / 거리 data-ready / NFC IRQ 로 깨어남)
+//  - 깨어나는 조건 (MotionDetect.h): 필터 출력이 거리 기준선(EMA)에서 wakeDeltaMm 이상 벗어난
+//    샘플 2개 연속, rep, 태그 → 곧바로 BetweenSets 프로파일로 복귀 (필터 초기화 포함)
+//    Idle/Asleep 에서는 원값 1개만 벗어나도 kProbeMs 동안 BetweenSets 로 올려 확인
+//    → 첫 rep 부터 정상 검출 (host trend_replay --wake 로 확인)
+//  - 상태별 전류는 측정이 아니라 프로파일의 추정값(estCurrentMa). Asleep 은 실제 잠든 비율로 가중
+//  - onSample/onRep/onTag 는 begin 전에도 안전 (Runtime 태스크에서 호출)
+namespace PowerManager {
+  enum class State : uint8_t { ActiveSet, BetweenSets, Idle, Asleep, Count };
+
+  struct Profile {
+    uint32_t timingBudgetUs;   // VL53L0X 측정 1회 시간
+    uint16_t periodMs;         // VL53L0X 측정 간격 (0 = back-to-back)
+    uint16_t sensePeriodMs;    // Runtime sense 주기 (0 = Runtime 기본값)
+    uint8_t  laserScale;       // Laser::dim (%), 0 = 끔
+    uint16_t estCurrentMa;     // 이 상태 평균 전류 추정 (보드 전체)
+  };
+
+  struct Config {
+    uint32_t setIdleMs     = 8000;     // Runtime::Config::setIdleMs 와 같게
+    uint32_t restMs        = 180000;   // 세트 사이 휴식으로 보는 시간
+    uint32_t sleepAfterMs  = 600000;   // 이후 Asleep
+    uint16_t wakeDeltaMm   = 60;       // 기준선 대비 이만큼 바뀌면 움직임
+    uint16_t asleepWakeMs  = 1000;     // Asleep 타이머 깨움 간격
+    uint16_t asleepAwakeMs = 300;      // 깨어난 뒤 샘플을 기다리는 최대 시간
+    uint16_t sleepCurrentMa = 3;       // light sleep 중 전류 추정 (센서 포함)
+    int      distIrqPin    = -1;       // VL53L0X GPIO1 (LOW = data-ready), -1 = 타이머만
+    int      nfcIrqPin     = -1;       // PN532 IRQ (LOW = 응답 준비), -1 이면 Asleep 안 감
+    bool     lightSleep    = true;
+    bool     (*canSleep)() = nullptr;  // 추가 조건 (예: 보낼 이벤트 없음, AP 접속자 없음)
+    Profile  profiles[(int)State::Count] = {
+      {33000,    0,   0, 100, 140},    // ActiveSet
+      {33000,   50,   0,  60, 120},    // BetweenSets
+      {20000,  250, 100,   0,  70},    // Idle
+      {20000, 1000, 100,   0,  70},    // Asleep (깨어 있는 동안)
+    };
+    uint8_t     core  = 0;
+    UBaseType_t prio  = 2;
+    uint32_t    stack = 3072;
+  };
+
+  struct Stats {
+    State    state;
+    uint32_t residencyMs[(int)State::Count];   // 누적 (현재 상태 포함)
+    uint32_t transitions;
+    uint32_t sleeps;             // light sleep 횟수
+    uint32_t sleptMs;            // light sleep 누적
+    uint32_t wakeTimer, wakeDist, wakeNfc;
+    float    estMah;             // 부팅 이후 추정 소모량
+  };
+
+  bool begin(DistanceSensor* distance, const Config& cfg = Config{});
+
+  // sense 태스크: 샘플마다 (mm = 필터 출력, raw = 센서 원값)
+  void onSample(uint16_t mm, uint16_t raw, uint32_t tUs);
+  // sense 태스크: rep 확정 시
+  void onRep();
+  // nfc 태스크: 태그 도착 시
+  void onTag();
+
+  // Runtime sense 주기 (ms). 0 = Runtime 기본값 사용
+  uint32_t sensePeriodMs();
+
+  State       state();
+  const char* stateName(State s);
+  Stats       stats();
+}
@@ -0,0 +1,117 @@
+#include "TraceRecorder.h"
+#include <atomic>
+#include <esp_heap_caps.h>
+#include "src/util/log/Log.h"
+
+using TraceFormat::TraceRecord;
+
+namespace {
+  TraceRecord* g_buf = nullptr;
+  uint32_t     g_cap = 0;
+  bool         g_psram = false;
+  uint32_t     g_periodUs = 0;
+
+  // g_wr: 다음에 쓸 일련번호 (생산자만 증가). 레코드 seq 는 g_buf[seq % g_cap]
+  std::atomic<uint32_t> g_wr{0};
+  std::atomic<uint32_t> g_start{0};
+  std::atomic<uint32_t> g_stop{0};
+  std::atomic<uint32_t> g_preMs{0};
+  std::atomic<uint8_t>  g_state{(uint8_t)TraceRecorder::State::Idle};
+
+  inline uint32_t oldest_(uint32_t wr) { return wr > g_cap ? wr - g_cap : 0; }
+
+  // 선택 구간 [from, to)
+  void range_(uint32_t wr, uint32_t& from, uint32_t& to) {
+    const auto st = (TraceRecorder::State)g_state.load();
+    from = (st == TraceRecorder::State::Idle) ? oldest_(wr) : g_start.load();
+    to   = (st == TraceRecorder::State::Stopped) ? g_stop.load() : wr;
+  }
+}
+
+bool TraceRecorder::begin(const Config& cfg) {
+  if (g_buf) return true;
+  g_periodUs = cfg.periodUs;
+  if (psramFound() && cfg.psramRecords) {
+    g_buf = (TraceRecord*)heap_caps_malloc(cfg.psramRecords * sizeof(TraceRecord), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (g_buf) { g_cap = cfg.psramRecords; g_psram = true; }
+  }
+  if (!g_buf && cfg.internalRecords) {
+    g_buf = (TraceRecord*)heap_caps_malloc(cfg.internalRecords * sizeof(TraceRecord), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (g_buf) g_cap = cfg.internalRecords;
+  }
+  if (!g_buf) {
+    LOGE("TRACE", "buffer alloc failed");
+    return false;
+  }
+  LOGI("TRACE", "ring %lu records (%s)", (unsigned long)g_cap, g_psram ? "PSRAM" : "internal");
+  return true;
+}
+
+bool TraceRecorder::ready() { return g_buf != nullptr; }
+
+void TraceRecorder::record(const TraceRecord& r) {
+  if (!g_buf) return;
+  const uint32_t wr = g_wr.load(std::memory_order_relaxed);
+  g_buf[wr % g_cap] = r;
+  g_wr.store(wr + 1, std::memory_order_release);
+}
+
+void TraceRecorder::start(uint32_t preMs) {
+  const uint32_t wr = g_wr.load();
+  // 명목 주기를 모르면 pre-trigger 는 링 전체
+  const uint32_t pre = g_periodUs ? (uint32_t)((uint64_t)preMs * 1000 / g_periodUs) : g_cap;
+  const uint32_t from = wr - (pre < wr ? pre : wr);
+  g_start.store(from > oldest_(wr) ? from : oldest_(wr));
+  g_preMs.store(preMs);
+  g_state.store((uint8_t)State::Recording);
+}
+
+void TraceRecorder::stop() {
+  if ((State)g_state.load() != State::Recording) return;
+  g_stop.store(g_wr.load());
+  g_state.store((uint8_t)State::Stopped);
+}
+
+TraceRecorder::Status TraceRecorder::status() {
+  const uint32_t wr = g_wr.load();
+  uint32_t from, to;
+  range_(wr, from, to);
+  const uint32_t old = oldest_(wr);
+  const uint32_t lost = from < old ? old - from : 0;
+  const uint32_t first = from < old ? old : from;
+  return Status{ (State)g_state.load(), g_cap, wr, to > first ? to - first : 0, lost, g_preMs.load(), g_psram };
+}
+
+TraceRecorder::Cursor TraceRecorder::select() {
+  uint32_t from, to;
+  range_(g_wr.load(), from, to);
+  return Cursor{ from, to, 0 };
+}
+
+size_t TraceRecorder::readNext(Cursor& c, TraceRecord* out, size_t maxRecs) {
+  if (!g_buf) return 0;
+  for (;;) {
+    const uint32_t old = oldest_(g_wr.load(std::memory_order_acquire));
+    if (c.next < old) { c.skipped += old - c.next; c.next = old; }
+    if (c.next >= c.end) return 0;
+
+    size_t n = c.end - c.next;
+    if (n > maxRecs) n = maxRecs;
+    for (size_t i = 0; i < n; ++i) out[i] = g_buf[(c.next + i) % g_cap];
+
+    // 복사하는 동안 생산자가 따라잡았으면 앞부분이 깨졌을 수 있음 → 안전한 부분만 사용
+    // (쓰기 중인 slot wr 은 seq wr - cap 과 같은 자리이므로 +1)
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint32_t wr = g_wr.load(std::memory_order_relaxed);
+    const uint32_t safe = wr >= g_cap ? wr - g_cap + 1 : 0;
+    if (c.next >= safe) { c.next += n; return n; }
+    const uint32_t bad = safe - c.next;
+    if (bad >= n) { c.skipped += n; c.next += n; continue; }
+    memmove(out, out + bad, (n - bad) * sizeof(TraceRecord));
+    c.skipped += bad;
+    c.next += n;
+    return n - bad;
+  }
+}
+
+uint32_t TraceRecorder::periodUs() { return g_periodUs; }
@@ -0,0 +1,48 @@
+#pragma once
+#include <Arduino.h>
+#include "src/app/trend/TraceFormat.h"
+
+// 원시/필터 거리 샘플 + 감지기 상태 트레이스 기록기
+//  - begin() 에서 링 버퍼를 한 번만 할당 (PSRAM 있으면 PSRAM), 이후 할당 없음
+//  - 링은 항상 돌고 있음 → start(preMs) 는 preMs 만큼 과거부터 구간 시작 (pre-trigger)
+//  - 생산자(sense 태스크) 1개, 소비자(웹 다운로드) 여럿: 소비자는 복사 후 덮어쓰기 여부를 재확인
+//  - 다운로드 형식은 TraceFormat (host/replay 로 그대로 리플레이)
+namespace TraceRecorder {
+  struct Config {
+    uint32_t psramRecords    = 90000;   // 12B × 90k ≈ 1MB, 30Hz 기준 50분
+    uint32_t internalRecords = 2048;    // PSRAM 없을 때 (24KB, 약 1분)
+    uint32_t periodUs        = 0;       // 헤더에 기록할 명목 샘플 주기
+  };
+
+  enum class State : uint8_t { Idle, Recording, Stopped };
+
+  struct Status {
+    State    state;
+    uint32_t capacity;      // 링 레코드 수
+    uint32_t written;       // 부팅 이후 기록한 레코드 수
+    uint32_t selected;      // 지금 다운로드하면 받을 레코드 수
+    uint32_t lost;          // 구간 시작점이 링에서 밀려나 잃은 레코드 수
+    uint32_t preMs;
+    bool     psram;
+  };
+
+  bool begin(const Config& cfg = Config{});
+  bool ready();
+
+  // sense 태스크 전용 (O(1), 블로킹/할당 없음)
+  void record(const TraceFormat::TraceRecord& r);
+
+  void start(uint32_t preMs);
+  void stop();
+  Status status();
+
+  // 다운로드 커서: [next, end) 를 순서대로 읽음. 이미 덮어쓴 레코드는 건너뛰고 skipped 에 누적
+  struct Cursor {
+    uint32_t next;
+    uint32_t end;
+    uint32_t skipped;
+  };
+  Cursor select();
+  size_t  readNext(Cursor& c, TraceFormat::TraceRecord* out, size_t maxRecs);
+  uint32_t periodUs();
+}
@@ -0,0 +1,357 @@
+#include "Runtime.h"
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+
+#include "src/app/trend/TrendDetector.h"
+#include "src/devices/distance/DistanceSensor.h"
+#include "src/devices/nfc/NfcReader.h"
+#include "src/devices/power/power.h"
+#include "src/devices/status_led/status_led.h"
+#include "src/net/rest/RestSender.h"
+#include "src/net/wifi/radio_scheduler.h"
+#include "src/fs/event_log/EventLog.h"
+#include "src/app/event/RepEventCodec.h"
+#include "src/app/recorder/TraceRecorder.h"
+#include "src/app/session/SessionManager.h"
+#include "src/app/power/PowerManager.h"
+#include "src/net/telemetry/Telemetry.h"
+#include "src/util/log/Log.h"
+#include "src/util/metrics/Metrics.h"
+#include "src/util/tracer/Tracer.h"
+
+namespace {
+  enum TaskId : uint8_t { T_SENSE = 0, T_NFC, T_UPLINK, T_COUNT };
+
+  struct TaskSlot {
+    const char*   name;
+    TaskHandle_t  handle   = nullptr;
+    volatile uint32_t busyUs   = 0;
+    volatile uint32_t runs     = 0;
+    volatile uint32_t overruns = 0;
+    uint32_t      lastBusyUs = 0;     // printStats 직전 값
+  };
+
+  Runtime::Deps   g_deps{};
+  Runtime::Config g_cfg{};
+  QueueHandle_t   g_events = nullptr;
+  volatile uint32_t g_dropped = 0;
+  TaskSlot g_tasks[T_COUNT] = { {"sense"}, {"nfc"}, {"uplink"} };
+  int64_t  g_lastStatsUs = 0;
+
+  Metrics::Histogram g_loopUs[T_COUNT] = {
+    {"gymbuddy_task_loop_seconds", "Runtime task loop iteration time", Metrics::kLatencyUs, 10, 1e-6f, "task=\"sense\""},
+    {"gymbuddy_task_loop_seconds", "Runtime task loop iteration time", Metrics::kLatencyUs, 10, 1e-6f, "task=\"nfc\""},
+    {"gymbuddy_task_loop_seconds", "Runtime task loop iteration time", Metrics::kLatencyUs, 10, 1e-6f, "task=\"uplink\""},
+  };
+  Metrics::Counter g_repsTotal("gymbuddy_reps_total", "Reps detected by TrendDetector");
+  Metrics::Counter g_repsDropped("gymbuddy_reps_dropped_total", "Reps lost because the event queue was full");
+
+  // 태스크 본체 실행 시간 누적용
+  struct BusyScope {
+    TaskSlot& t; int64_t t0;
+    explicit BusyScope(TaskSlot& s) : t(s), t0(esp_timer_get_time()) {}
+    ~BusyScope() {
+      const uint32_t dt = (uint32_t)(esp_timer_get_time() - t0);
+      t.busyUs += dt;
+      t.runs++;
+      g_loopUs[&t - g_tasks].observe(dt);
+    }
+  };
+
+  // 이벤트는 반복 지표가 확정되는 시점(최고점 확정)에 보냄
+  void emitRep_() {
+    TrendDetector::RepMetrics m;
+    if (!g_deps.detector->takeRep(m)) return;
+    RepEvent ev{ (uint32_t)time(nullptr), millis(), m.minv, m.maxv,
+                 m.romMm, m.eccentricMs, m.concentricMs, m.tutMs, m.peakVelMms, m.meanVelMms, 0, {} };
+    // 업링크가 밀려도 샘플링은 멈추지 않음 → 대기 없이 넣고, 실패하면 카운트만
+    g_repsTotal.inc();
+    PowerManager::onRep();
+    if (xQueueSend(g_events, &ev, 0) != pdTRUE) { g_dropped++; g_repsDropped.inc(); }
+    Telemetry::publishRep(ev);
+  }
+
+  // ---------- sense: 고정 주기 샘플링 ----------
+  void senseTask(void*) {
+    TaskSlot& self = g_tasks[T_SENSE];
+    TickType_t wake = xTaskGetTickCount();
+
+    for (;;) {
+      // 절전 상태에서는 PowerManager 가 주기를 늘림
+      const uint32_t pmMs = PowerManager::sensePeriodMs();
+      const TickType_t period = pdMS_TO_TICKS(pmMs ? pmMs : g_cfg.samplePeriodMs);
+      {
+        BusyScope scope(self);
+        TRACE_SCOPE("rt.sense");
+        // 연속 측정 모드에서는 지난 주기 동안 쌓인 샘플을 모두 처리 (read 는 블로킹 없음)
+        DistanceSensor::Sample smp;
+        while (g_deps.distance->read(smp)) {
+          const bool rep = g_deps.detector->step(smp.mm, smp.tUs);
+          PowerManager::onSample(smp.mm, smp.raw, smp.tUs);
+          const auto& s = g_deps.detector->state();
+          emitRep_();
+          // 샘플마다 Serial 출력 대신 트레이스 링(/api/trace/download)과 실시간 스트림(/ws/telemetry)으로
+          const TraceFormat::TraceRecord tr{ smp.tUs, smp.raw, smp.mm, (uint8_t)s.phase,
+                                             (uint8_t)(rep ? TraceFormat::kRepDetected : 0), 0 };
+          TraceRecorder::record(tr);
+          Telemetry::publishSample(tr);
+        }
+        // 샘플이 끊겨도(범위 밖 → 센서가 버림) 세트 마지막 반복은 settle_ms 뒤 확정
+        g_deps.detector->tick((uint32_t)esp_timer_get_time());
+        emitRep_();
+      }
+      // 다음 주기까지 대기. 이미 지났으면 overrun 으로 기록하고 기준점 재설정
+      const TickType_t now = xTaskGetTickCount();
+      if ((TickType_t)(now - wake) >= period) {
+        self.overruns++;
+        wake = now;
+      } else {
+        vTaskDelayUntil(&wake, period);
+      }
+    }
+  }
+
+  // ---------- nfc: PN532 상태 머신 ----------
+  // 응답/태그는 UART RX 콜백(또는 SPI IRQ)이 태스크를 깨움. 그 외엔 드라이버가 알려준 다음 기한까지 잠듦
+  void nfcTask(void*) {
+    TaskSlot& self = g_tasks[T_NFC];
+    g_deps.nfc->attachTask(xTaskGetCurrentTaskHandle());
+    for (;;) {
+      uint32_t waitMs;
+      {
+        BusyScope scope(self);
+        TRACE_SCOPE("rt.nfc");
+        waitMs = g_deps.nfc->poll();
+      }
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs));
+    }
+  }
+
+  void onTag_(const Nfc::Event& ev) {
+    char uid[sizeof(ev.uid) * 3 + 1] = "";
+    for (uint8_t i = 0; i < ev.uidLen && i < sizeof(ev.uid); ++i) snprintf(uid + i * 3, 4, "%02X ", ev.uid[i]);
+    LOGI("NFC", "%s UID: %s", ev.type == Nfc::TagEvent::Arrived ? "IN " : "OUT", uid);
+    if (ev.type == Nfc::TagEvent::Arrived) PowerManager::onTag();
+    // 세션은 태깅(입장) 기준. 카드를 떼는 것은 세션과 무관
+    if (ev.type == Nfc::TagEvent::Arrived && g_deps.session)
+      g_deps.session->onTag(ev.uid, ev.uidLen, ev.ms);
+  }
+
+  // ---------- uplink: rep 이벤트 → REST ----------
+  constexpr size_t kRepJsonMax = EventCodec::maxEncodedSize<RepEvent>();
+  static_assert(sizeof(RepEvent) <= EventLog::kPayloadMax, "RepEvent must fit in an EventLog record");
+
+  // tag_id = UID 16진 문자열 (세션 없던 rep 는 ""), member_id 는 회원 테이블에 있을 때만
+  size_t encodeJson_(const RepEvent& ev, char* out, size_t cap) {
+    char tagHex[sizeof(ev.tag) * 2 + 1];
+    char member[Members::kMemberIdMax + 1];
+    const uint8_t tagLen = ev.tagLen <= sizeof(ev.tag) ? ev.tagLen : 0;
+    for (uint8_t i = 0; i < tagLen; ++i) snprintf(tagHex + i * 2, 3, "%02X", ev.tag[i]);
+    tagHex[tagLen * 2] = '\0';
+    const bool known = tagLen && Members::lookup(ev.tag, tagLen, member, sizeof(member));
+    return EventCodec::encode(ev, {g_deps.deviceId, tagHex, known ? member : nullptr}, out, cap);
+  }
+
+  // EventLog 레코드(RepEvent 바이너리) → JSON 본문
+  // 업데이트 전에 쌓인 구버전 레코드(min/max 만)는 지표 0 으로 채워 보냄
+  size_t encodeRecord_(const uint8_t* rec, size_t len, uint32_t, char* out, size_t cap) {
+    if (len < kRepEventV1Size || len > sizeof(RepEvent)) return 0;
+    RepEvent ev{};
+    memcpy(&ev, rec, len);
+    return encodeJson_(ev, out, cap);
+  }
+
+  // 전달 지연 측정: 로그에 넣은 rep 의 (seq, 발생 시각). 업링크 태스크에서만 (append / onComplete)
+  struct Pending { uint32_t seq; uint32_t ms; };
+  constexpr uint8_t kPendingMax = 64;   // 넘치면 가장 오래된 것은 측정에서 빠짐
+  Pending  g_pending[kPendingMax];
+  uint32_t g_pendHead = 0, g_pendTail = 0;
+
+  void trackAppended_(uint32_t seq, uint32_t ms) {
+    if (g_pendTail - g_pendHead == kPendingMax) g_pendHead++;
+    g_pending[g_pendTail++ % kPendingMax] = {seq, ms};
+  }
+
+  // ackSeq 까지 서버가 받음
+  void trackDelivered_(uint32_t ackSeq) {
+    const uint32_t now = millis();
+    while (g_pendHead != g_pendTail) {
+      const Pending& p = g_pending[g_pendHead % kPendingMax];
+      if ((int32_t)(p.seq - ackSeq) > 0) break;
+      RadioScheduler::recordDelivery(now - p.ms);
+      g_pendHead++;
+    }
+  }
+
+  constexpr size_t kBacklogLedEvents = 50;   // 미전송이 이만큼 쌓이면 상태 LED 표시
+
+  // RestSender 소켓과 EventLog 는 이 태스크만 건드림. 큐 대기 시간이 곧 poll 주기.
+  void uplinkTask(void*) {
+    TaskSlot& self = g_tasks[T_UPLINK];
+    const StatusLED::Indicator backlogLed = StatusLED::find("uplink_backlog");
+    bool backlogShown = false;
+    RepEvent ev;
+    uint32_t lastRepMs = 0;
+    for (;;) {
+      const bool got = xQueueReceive(g_events, &ev, pdMS_TO_TICKS(g_cfg.uplinkPollMs)) == pdTRUE;
+      BusyScope scope(self);
+      TRACE_SCOPE("rt.uplink");
+
+      if (got) {
+        lastRepMs = ev.ms | 1;
+        if (g_deps.session) g_deps.session->stamp(ev);
+        // 먼저 플래시에 기록(크래시/오프라인 대비) → 전송은 RestSender 드레인이 담당
+        if (g_deps.log) {
+          if (g_deps.log->append(&ev, sizeof(ev), ev.ts)) trackAppended_(g_deps.log->tail() - 1, ev.ms);
+          else LOGE("RT", "event log append failed");
+        } else {
+          char json[kRepJsonMax];
+          const size_t n = encodeJson_(ev, json, sizeof(json));
+          if (!n || !g_deps.sender->submit(json, n, ev.ms)) LOGW("RT", "POST FAIL (sender queue full)");
+        }
+      } else if (lastRepMs && millis() - lastRepMs >= g_cfg.setIdleMs) {
+        // 세트 종료: 배치 대기시간을 기다리지 않고 바로 보냄
+        g_deps.sender->requestFlush();
+        lastRepMs = 0;
+      }
+      if (g_deps.session) g_deps.session->poll(millis());
+      RadioScheduler::poll();
+      g_deps.sender->poll();
+      const bool backlog = g_deps.sender->backlog() >= kBacklogLedEvents;
+      if (backlog != backlogShown) {
+        StatusLED::set(backlogLed, backlog);
+        backlogShown = backlog;
+      }
+    }
+  }
+
+  void onPostComplete_(const RestSender::Result& r) {
+    // tag: 로그 드레인이면 본문의 마지막 seq, 직접 전송이면 rep 발생 시각(ms)
+    if (r.ok()) {
+      if (g_deps.log) trackDelivered_(r.tag);
+      else            RadioScheduler::recordDelivery(millis() - r.tag);
+    }
+    if (r.ok()) LOGD("RT", "POST OK status=%d tries=%u latency=%lums", r.status, r.attempts, (unsigned long)r.latencyMs);
+    else        LOGW("RT", "POST FAIL status=%d tries=%u latency=%lums", r.status, r.attempts, (unsigned long)r.latencyMs);
+  }
+
+  bool spawn_(TaskFunction_t fn, TaskId id, uint32_t stack, UBaseType_t prio, uint8_t core) {
+    TaskSlot& t = g_tasks[id];
+    BaseType_t rc = xTaskCreatePinnedToCore(fn, t.name, stack, nullptr, prio, &t.handle, core);
+    if (rc != pdPASS) {
+      LOGE("RT", "task %s create failed", t.name);
+      return false;
+    }
+    return true;
+  }
+} // namespace
+
+bool Runtime::begin(const Deps& deps, const Config& cfg) {
+  if (!deps.distance || !deps.detector || !deps.nfc || !deps.sender) return false;
+  g_deps = deps;
+  g_cfg  = cfg;
+
+  g_events = xQueueCreate(cfg.eventQueueLen, sizeof(RepEvent));
+  if (!g_events) {
+    LOGE("RT", "event queue alloc failed");
+    return false;
+  }
+
+  g_deps.sender->onComplete(onPostComplete_);
+  g_deps.nfc->onEvent(onTag_);
+  if (g_deps.log) g_deps.sender->drainFrom(g_deps.log, encodeRecord_);
+
+  g_lastStatsUs = esp_timer_get_time();
+  bool ok = spawn_(senseTask,  T_SENSE,  cfg.senseStack,  cfg.sensePrio,  cfg.senseCore);
+  ok = ok && spawn_(uplinkTask, T_UPLINK, cfg.uplinkStack, cfg.uplinkPrio, cfg.uplinkCore);
+  ok = ok && spawn_(nfcTask,    T_NFC,    cfg.nfcStack,    cfg.nfcPrio,    cfg.nfcCore);
+  return ok;
+}
+
+void Runtime::printStats(Print& out) {
+  const int64_t now = esp_timer_get_time();
+  const uint32_t windowUs = (uint32_t)(now - g_lastStatsUs);
+  g_lastStatsUs = now;
+
+  out.printf("[RT] window=%lums dropped=%lu\n", (unsigned long)(windowUs / 1000), (unsigned long)g_dropped);
+  const auto& rs = g_deps.sender->stats();
+  out.printf("[RT] uplink ok=%lu fail=%lu retry=%lu drop=%lu connects=%lu pending=%u lastLatency=%lums radioConn=%lums\n",
+             (unsigned long)rs.ok, (unsigned long)rs.failed, (unsigned long)rs.retries, (unsigned long)rs.dropped,
+             (unsigned long)rs.connects, (unsigned)g_deps.sender->pending(),
+             (unsigned long)rs.lastLatencyMs, (unsigned long)rs.connectedMs);
+  const auto rad = RadioScheduler::stats();
+  out.printf("[RT] radio %s window=%d ap=%d windows=%lu (flush=%lu hw=%lu timer=%lu)\n",
+             RadioScheduler::policyName(rad.policy), (int)rad.windowOpen, (int)rad.apOn,
+             (unsigned long)rad.windows, (unsigned long)rad.windowsFlush,
+             (unsigned long)rad.windowsHighWater, (unsigned long)rad.windowsTimer);
+  for (int i = 0; i < (int)RadioScheduler::Policy::Count; ++i) {
+    const auto& pp = rad.perPolicy[i];
+    if (!pp.totalMs) continue;
+    out.printf("[RT]   %-11s %lus awake=%.0f%% est=%.1fmA delivered=%lu latency avg=%lums max=%lums\n",
+               RadioScheduler::policyName((RadioScheduler::Policy)i), (unsigned long)(pp.totalMs / 1000),
+               100.0f * pp.awakeMs / pp.totalMs, pp.estMa, (unsigned long)pp.delivered,
+               (unsigned long)pp.latencyAvgMs, (unsigned long)pp.latencyMaxMs);
+  }
+  const auto ds = g_deps.distance->stats();
+  out.printf("[RT] dist rate=%.1fHz interval=%.0fus jitter=%.0fus max=%luus invalid=%lu overflow=%lu outlier=%lu\n",
+             ds.rateHz, ds.meanIntervalUs, ds.jitterUs, (unsigned long)ds.maxIntervalUs,
+             (unsigned long)ds.invalid, (unsigned long)ds.overflows, (unsigned long)ds.outliers);
+  const auto& ns = g_deps.nfc->stats();
+  out.printf("[RT] nfc(%s) in=%lu out=%lu frames=%lu bad=%lu timeout=%lu rtt=%lums present=%d\n",
+             Nfc::kLink, (unsigned long)ns.arrivals, (unsigned long)ns.departures, (unsigned long)ns.frames,
+             (unsigned long)ns.badFrames, (unsigned long)ns.timeouts, (unsigned long)ns.lastRttMs,
+             (int)g_deps.nfc->present());
+  const auto ts = Telemetry::stats();
+  out.printf("[RT] telem ws=%u sse=%u frames=%lu bytes=%lu drop ring=%lu client=%lu publish avg=%lucyc max=%lucyc\n",
+             (unsigned)ts.wsClients, (unsigned)ts.sseClients, (unsigned long)ts.frames, (unsigned long)ts.bytes,
+             (unsigned long)ts.ringDrops, (unsigned long)ts.clientDrops,
+             (unsigned long)ts.publishAvgCycles, (unsigned long)ts.publishMaxCycles);
+  const auto lg = Log::stats();
+  out.printf("[RT] log written=%lu dropped=%lu truncated=%lu file=%luB callMax=%luus\n",
+             (unsigned long)lg.written, (unsigned long)lg.dropped, (unsigned long)lg.truncated,
+             (unsigned long)lg.fileBytes, (unsigned long)lg.maxFormatUs);
+  const auto ps = Power::stats();
+  out.printf("[RT] vbat %.3fV soc=%.0f%% frame=%.3fV (%s) frames=%lu err=%lu\n",
+             Power::vbat(), Power::soc(), ps.lastFrameV, ps.continuous ? "dma" : "oneshot",
+             (unsigned long)ps.frames, (unsigned long)ps.errors);
+  const auto pm = PowerManager::stats();
+  out.printf("[RT] pm %s active=%lus between=%lus idle=%lus asleep=%lus sleeps=%lu slept=%lus wake t/d/n=%lu/%lu/%lu est=%.1fmAh\n",
+             PowerManager::stateName(pm.state),
+             (unsigned long)(pm.residencyMs[0] / 1000), (unsigned long)(pm.residencyMs[1] / 1000),
+             (unsigned long)(pm.residencyMs[2] / 1000), (unsigned long)(pm.residencyMs[3] / 1000),
+             (unsigned long)pm.sleeps, (unsigned long)(pm.sleptMs / 1000),
+             (unsigned long)pm.wakeTimer, (unsigned long)pm.wakeDist, (unsigned long)pm.wakeNfc, pm.estMah);
+  if (g_deps.session) {
+    const auto ss = g_deps.session->current();
+    const auto ms = Members::stats();
+    out.printf("[RT] session active=%d id=%lu member=%s reps=%lu | members=%lu hit=%lu miss=%lu\n",
+               (int)ss.active, (unsigned long)ss.id, ss.known ? ss.member : "-", (unsigned long)ss.reps,
+               (unsigned long)ms.entries, (unsigned long)ms.hits, (unsigned long)ms.misses);
+  }
+  if (g_deps.log) {
+    const auto ls = g_deps.log->stats();
+    out.printf("[RT] backlog depth=%lu bytes=%lu oldest=%lus dropped=%lu corrupt=%lu\n",
+               (unsigned long)ls.depth, (unsigned long)ls.bytesPending, (unsigned long)ls.oldestAgeS,
+               (unsigned long)ls.dropped, (unsigned long)ls.corrupt);
+  }
+  for (auto& t : g_tasks) {
+    if (!t.handle) continue;
+    const uint32_t busy  = t.busyUs;
+    const uint32_t delta = busy - t.lastBusyUs;
+    t.lastBusyUs = busy;
+    // ESP32 의 uxTaskGetStackHighWaterMark 는 byte 단위
+    const uint32_t freeMin = uxTaskGetStackHighWaterMark(t.handle);
+    const float cpu = windowUs ? (100.0f * delta / windowUs) : 0.0f;
+    out.printf("[RT] %-6s core=%d stackFree=%lu cpu=%.1f%% runs=%lu overrun=%lu\n",
+               t.name, (int)xTaskGetAffinity(t.handle), (unsigned long)freeMin, cpu,
+               (unsigned long)t.runs, (unsigned long)t.overruns);
+  }
+}
+
+uint32_t Runtime::droppedEvents() { return g_dropped; }
+
+void Runtime::kickNfc() {
+  if (g_tasks[T_NFC].handle) xTaskNotifyGive(g_tasks[T_NFC].handle);
+}
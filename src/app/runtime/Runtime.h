@@ -0,0 +1,52 @@
+#pragma once
+#include <Arduino.h>
+#include "src/app/event/RepEvent.h"
+#include "src/devices/nfc/NfcBackend.h"
+
+class DistanceSensor;
+class TrendDetector;
+class RestSender;
+class EventLog;
+class SessionManager;
+
+// loop() 하나로 돌던 작업을 FreeRTOS 태스크로 분리
+//  - sense  : 고정 주기 거리 샘플링 + TrendDetector (APP_CPU, 최고 우선순위)
+//  - nfc    : PN532 비동기 상태 머신 (PRO_CPU, RX 수신 시에만 깨어남)
+//  - uplink : rep 이벤트 큐 소비 → EventLog 에 기록 → RestSender 가 드레인 (PRO_CPU)
+namespace Runtime {
+  struct Deps {
+    DistanceSensor* distance;
+    TrendDetector*  detector;
+    Nfc*            nfc;
+    RestSender*     sender;
+    EventLog*       log;        // nullptr 이면 저장 없이 바로 전송
+    const char*     deviceId;
+    SessionManager* session;    // nullptr 이면 태그 없이 전송
+  };
+
+  struct Config {
+    uint32_t samplePeriodMs = 50;   // 샘플링 주기 (네트워크 상태와 무관하게 고정)
+    uint8_t  senseCore      = 1;    // APP_CPU
+    uint8_t  nfcCore        = 0;    // PRO_CPU (Wi-Fi 와 같은 코어)
+    uint8_t  uplinkCore     = 0;
+    UBaseType_t sensePrio   = 5;
+    UBaseType_t nfcPrio     = 2;
+    UBaseType_t uplinkPrio  = 3;
+    uint32_t senseStack     = 4096;
+    uint32_t nfcStack       = 4096;
+    uint32_t uplinkStack    = 8192;
+    uint8_t  eventQueueLen  = 16;
+    uint32_t uplinkPollMs   = 20;   // RestSender::poll 주기 (이벤트 없을 때)
+    uint32_t setIdleMs      = 8000; // 마지막 rep 이후 이 시간이 지나면 세트 종료 → 배치 즉시 flush
+  };
+
+  bool begin(const Deps& deps, const Config& cfg);
+
+  // 각 태스크의 스택/CPU 사용량 출력 (CPU% 는 직전 호출 이후 구간 기준)
+  void printStats(Print& out);
+
+  uint32_t droppedEvents();       // 큐 가득 차서 버린 rep 이벤트 수
+
+  // nfc 태스크를 바로 깨움 (light sleep 중 놓친 IRQ 대신)
+  void kickNfc();
+}
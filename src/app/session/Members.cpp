@@ -0,0 +1,263 @@
+#include "Members.h"
+#include <LittleFS.h>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "src/util/log/Log.h"
+
+namespace {
+  constexpr uint32_t kMagic   = 0x424D4247;   // "GBMB"
+  constexpr uint16_t kVersion = 1;
+  constexpr size_t   kKeyLen  = 1 + Members::kUidMax;
+
+  struct FileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recSize;
+    uint32_t count;
+  };
+
+  // 정렬 키 = (uidLen, uid 0 패딩) 앞 11바이트 memcmp
+  struct Record {
+    uint8_t uidLen;
+    uint8_t uid[Members::kUidMax];
+    char    member[Members::kMemberIdMax + 1];
+  };
+  static_assert(sizeof(Record) == 32, "Record layout");
+
+  struct CacheEntry {
+    uint8_t  key[kKeyLen];
+    bool     known;
+    char     member[Members::kMemberIdMax + 1];
+    uint32_t tick;           // 0 = 빈 슬롯
+  };
+
+  const char*       g_path = nullptr;
+  File              g_file;
+  uint32_t          g_count = 0;
+  CacheEntry        g_cache[Members::kCacheSize];
+  uint32_t          g_tick = 0;
+  Members::Stats    g_stats{};
+  SemaphoreHandle_t g_mtx = nullptr;
+
+  // 가져오기 예약 (웹 → loop)
+  std::atomic<const char*> g_importPath{nullptr};
+  Members::Import          g_import = Members::Import::Idle;   // g_mtx 안에서
+  char                     g_importErr[sizeof(Members::Stats::importErr)] = "";
+
+  struct Lock {
+    Lock()  { xSemaphoreTake(g_mtx, portMAX_DELAY); }
+    ~Lock() { xSemaphoreGive(g_mtx); }
+  };
+
+  void makeKey_(const uint8_t* uid, uint8_t len, uint8_t* key) {
+    memset(key, 0, kKeyLen);
+    key[0] = len;
+    memcpy(key + 1, uid, len);
+  }
+
+  bool openTable_() {
+    if (g_file) g_file.close();
+    g_count = 0;
+    g_file = LittleFS.open(g_path, "r");
+    if (!g_file) return false;
+    FileHeader h;
+    if (g_file.read((uint8_t*)&h, sizeof(h)) != sizeof(h) || h.magic != kMagic ||
+        h.version != kVersion || h.recSize != sizeof(Record) ||
+        g_file.size() < sizeof(h) + (size_t)h.count * sizeof(Record)) {
+      LOGW("MEMBERS", "%s invalid, ignoring", g_path);
+      g_file.close();
+      return false;
+    }
+    g_count = h.count;
+    return true;
+  }
+
+  // 파일 이진 탐색 (g_mtx 보유 상태)
+  bool searchFile_(const uint8_t* key, char* member) {
+    if (!g_file) return false;
+    uint32_t lo = 0, hi = g_count;
+    Record r;
+    while (lo < hi) {
+      const uint32_t mid = lo + (hi - lo) / 2;
+      g_file.seek(sizeof(FileHeader) + (size_t)mid * sizeof(Record));
+      if (g_file.read((uint8_t*)&r, sizeof(r)) != sizeof(r)) return false;
+      g_stats.fileReads++;
+      const int c = memcmp(&r, key, kKeyLen);
+      if (c == 0) {
+        memcpy(member, r.member, sizeof(r.member));
+        member[Members::kMemberIdMax] = '\0';
+        return true;
+      }
+      if (c < 0) lo = mid + 1; else hi = mid;
+    }
+    return false;
+  }
+
+  int hexNibble_(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+  }
+
+  // "04A1B2C3", "04:A1:B2:C3", "04 A1 B2 C3" 모두 허용
+  bool parseUid_(const String& s, Record& r) {
+    uint8_t n = 0;
+    int hi = -1;
+    for (size_t i = 0; i < s.length(); ++i) {
+      const char c = s[i];
+      if (c == ':' || c == ' ' || c == '-') continue;
+      const int v = hexNibble_(c);
+      if (v < 0) return false;
+      if (hi < 0) { hi = v; continue; }
+      if (n >= Members::kUidMax) return false;
+      r.uid[n++] = (uint8_t)(hi << 4 | v);
+      hi = -1;
+    }
+    if (hi >= 0 || n == 0) return false;
+    r.uidLen = n;
+    return true;
+  }
+}
+
+bool Members::begin(const char* path) {
+  if (!g_mtx) g_mtx = xSemaphoreCreateMutex();
+  if (!g_mtx) return false;
+  Lock lk;
+  g_path = path;
+  const bool ok = openTable_();
+  LOGI("MEMBERS", "%lu entries", (unsigned long)g_count);
+  return ok;
+}
+
+bool Members::lookup(const uint8_t* uid, uint8_t uidLen, char* out, size_t cap) {
+  if (!g_mtx || uidLen == 0 || uidLen > kUidMax || cap == 0) return false;
+  uint8_t key[kKeyLen];
+  makeKey_(uid, uidLen, key);
+
+  Lock lk;
+  CacheEntry* victim = &g_cache[0];
+  for (auto& e : g_cache) {
+    if (e.tick && memcmp(e.key, key, kKeyLen) == 0) {
+      e.tick = ++g_tick;
+      g_stats.hits++;
+      if (e.known) strlcpy(out, e.member, cap);
+      return e.known;
+    }
+    if (e.tick < victim->tick) victim = &e;   // 빈 슬롯(0) 또는 가장 오래 안 쓴 항목
+  }
+
+  g_stats.misses++;
+  memcpy(victim->key, key, kKeyLen);
+  victim->known = searchFile_(key, victim->member);
+  victim->tick  = ++g_tick;
+  if (victim->known) strlcpy(out, victim->member, cap);
+  return victim->known;
+}
+
+bool Members::importCsv(const char* csvPath, String& err) {
+  if (!g_mtx || !g_path) { err = "not initialized"; return false; }
+  File in = LittleFS.open(csvPath, "r");
+  if (!in) { err = "cannot open upload"; return false; }
+
+  // 업로드 시에만 쓰는 임시 버퍼 (정렬용)
+  std::vector<Record> recs;
+  uint32_t lineNo = 0;
+  while (in.available()) {
+    String line = in.readStringUntil('\n');
+    lineNo++;
+    line.trim();
+    if (line.length() == 0 || line[0] == '#') continue;
+    const int comma = line.indexOf(',');
+    Record r{};
+    if (comma <= 0 || !parseUid_(line.substring(0, comma), r)) {
+      if (lineNo == 1) continue;                         // 헤더 줄
+      err = "bad uid at line " + String(lineNo);
+      in.close();
+      return false;
+    }
+    String member = line.substring(comma + 1);
+    member.trim();
+    if (member.length() == 0 || member.length() > kMemberIdMax) {
+      err = "bad member id at line " + String(lineNo);
+      in.close();
+      return false;
+    }
+    strlcpy(r.member, member.c_str(), sizeof(r.member));
+    if (recs.size() >= kMaxEntries) {
+      err = "too many entries (max " + String(kMaxEntries) + ")";
+      in.close();
+      return false;
+    }
+    recs.push_back(r);
+  }
+  in.close();
+
+  std::sort(recs.begin(), recs.end(), [](const Record& a, const Record& b) {
+    return memcmp(&a, &b, kKeyLen) < 0;
+  });
+  // 같은 UID 가 여러 줄이면 하나만 남김
+  recs.erase(std::unique(recs.begin(), recs.end(), [](const Record& a, const Record& b) {
+    return memcmp(&a, &b, kKeyLen) == 0;
+  }), recs.end());
+
+  const String tmp = String(g_path) + ".tmp";
+  File out = LittleFS.open(tmp, "w");
+  if (!out) { err = "cannot create table"; return false; }
+  const FileHeader h{kMagic, kVersion, (uint16_t)sizeof(Record), (uint32_t)recs.size()};
+  bool ok = out.write((const uint8_t*)&h, sizeof(h)) == sizeof(h);
+  if (ok && !recs.empty())
+    ok = out.write((const uint8_t*)recs.data(), recs.size() * sizeof(Record)) == recs.size() * sizeof(Record);
+  out.close();
+  if (!ok) { LittleFS.remove(tmp); err = "write failed (FS full?)"; return false; }
+
+  Lock lk;
+  if (g_file) g_file.close();
+  // rename 은 기존 테이블을 원자적으로 교체 → 도중에 리셋돼도 옛 테이블 또는 새 테이블
+  if (!LittleFS.rename(tmp, g_path)) { openTable_(); err = "rename failed"; return false; }
+  memset(g_cache, 0, sizeof(g_cache));
+  openTable_();
+  LOGI("MEMBERS", "imported %lu entries", (unsigned long)g_count);
+  return true;
+}
+
+bool Members::requestImport(const char* csvPath) {
+  const char* none = nullptr;
+  if (!g_mtx || !g_importPath.compare_exchange_strong(none, csvPath)) return false;
+  Lock lk;
+  g_import = Import::Pending;
+  g_importErr[0] = '\0';
+  return true;
+}
+
+bool Members::importPending() {
+  return g_importPath.load() != nullptr;
+}
+
+void Members::handle() {
+  const char* path = g_importPath.load();
+  if (!path) return;
+  String err;
+  const bool ok = importCsv(path, err);
+  LittleFS.remove(path);
+  if (!ok) LOGW("MEMBERS", "import failed: %s", err.c_str());
+  {
+    Lock lk;
+    g_import = ok ? Import::Ok : Import::Failed;
+    strlcpy(g_importErr, err.c_str(), sizeof(g_importErr));
+  }
+  g_importPath.store(nullptr);
+}
+
+Members::Stats Members::stats() {
+  if (!g_mtx) return Stats{};
+  Lock lk;
+  Stats s = g_stats;
+  s.entries = g_count;
+  s.import  = g_import;
+  strlcpy(s.importErr, g_importErr, sizeof(s.importErr));
+  return s;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <Arduino.h>
+
+// 태그 UID → 회원 ID 조회
+//  - RAM: 고정 크기 LRU (미등록 UID 도 음성 캐시) → 재체크인은 수 us
+//  - LittleFS: UID 정렬 고정 길이 레코드 테이블 → 캐시 미스 시 이진 탐색 (log2 N 회 read)
+//  - 테이블은 CSV("uid_hex,member_id" 줄 단위) 업로드로 교체 (POST /api/members)
+//      웹 핸들러는 파일만 받고 requestImport, 변환(정렬/기록)은 loop() 의 handle() 에서
+namespace Members {
+  constexpr uint8_t  kUidMax      = 10;
+  constexpr uint8_t  kMemberIdMax = 20;     // NUL 제외
+  constexpr uint8_t  kCacheSize   = 32;
+  constexpr uint16_t kMaxEntries  = 2048;   // 가져오기 정렬 버퍼 상한 (레코드 32B → 64KB)
+
+  enum class Import : uint8_t { Idle, Pending, Ok, Failed };
+
+  struct Stats {
+    uint32_t entries;    // 테이블 레코드 수
+    uint32_t hits;
+    uint32_t misses;     // 캐시 미스 (파일 탐색)
+    uint32_t fileReads;  // 이진 탐색 중 레코드 read 횟수
+    Import   import;     // 마지막 가져오기 상태
+    char     importErr[40];
+  };
+
+  bool begin(const char* path = "/members.bin");
+
+  // 등록된 UID 면 true, out 에 회원 ID (NUL 종료). 여러 태스크에서 호출 가능
+  bool lookup(const uint8_t* uid, uint8_t uidLen, char* out, size_t cap);
+
+  // CSV 파일 → 정렬 테이블 재생성 (임시 파일에 쓰고 rename). 캐시 비움
+  bool importCsv(const char* csvPath, String& err);
+
+  // 가져오기 예약 (어느 태스크에서나, 대기 없음). 이미 대기 중이면 false
+  //  csvPath 는 문자열 상수여야 함. 가져온 뒤 지움
+  bool requestImport(const char* csvPath);
+  bool importPending();
+  // loop() 에서: 예약된 가져오기 실행
+  void handle();
+
+  Stats stats();
+}
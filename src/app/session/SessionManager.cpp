@@ -0,0 +1,74 @@
+#include "SessionManager.h"
+#include "src/util/log/Log.h"
+
+void SessionManager::onTag(const uint8_t* uid, uint8_t uidLen, uint32_t nowMs) {
+  if (uidLen == 0 || uidLen > Members::kUidMax) return;
+
+  // 파일 탐색이 있을 수 있으므로 임계 구역 밖에서 조회
+  char member[Members::kMemberIdMax + 1] = "";
+  const bool known = Members::lookup(uid, uidLen, member, sizeof(member));
+
+  const Session c = current();
+  const bool same = c.active && c.uidLen == uidLen && memcmp(c.uid, uid, uidLen) == 0;
+  if (same) {
+    if (nowMs - c.startMs < cfg_.retapGuardMs) return;
+    end_("re-tap", nowMs);
+    return;
+  }
+  if (c.active) end_("new tag", nowMs);
+  start_(uid, uidLen, known, member, nowMs);
+}
+
+void SessionManager::start_(const uint8_t* uid, uint8_t uidLen, bool known, const char* member, uint32_t nowMs) {
+  Session s{};
+  s.active  = true;
+  s.id      = nextId_++;
+  memcpy(s.uid, uid, uidLen);
+  s.uidLen  = uidLen;
+  s.known   = known;
+  strlcpy(s.member, member, sizeof(s.member));
+  s.startMs = s.lastMs = nowMs;
+
+  portENTER_CRITICAL(&mux_);
+  cur_ = s;
+  portEXIT_CRITICAL(&mux_);
+  LOGI("SESSION", "#%lu start member=%s", (unsigned long)s.id, known ? s.member : "(unknown)");
+}
+
+void SessionManager::end_(const char* why, uint32_t nowMs) {
+  portENTER_CRITICAL(&mux_);
+  const Session s = cur_;
+  cur_.active = false;
+  portEXIT_CRITICAL(&mux_);
+  if (!s.active) return;
+  LOGI("SESSION", "#%lu end (%s) reps=%lu duration=%lus", (unsigned long)s.id, why,
+       (unsigned long)s.reps, (unsigned long)((nowMs - s.startMs) / 1000));
+}
+
+bool SessionManager::stamp(RepEvent& ev) {
+  portENTER_CRITICAL(&mux_);
+  const bool active = cur_.active;
+  if (active) {
+    memcpy(ev.tag, cur_.uid, cur_.uidLen);
+    ev.tagLen = cur_.uidLen;
+    cur_.reps++;
+    cur_.lastMs = ev.ms;
+  }
+  portEXIT_CRITICAL(&mux_);
+  if (!active) ev.tagLen = 0;
+  return active;
+}
+
+void SessionManager::poll(uint32_t nowMs) {
+  portENTER_CRITICAL(&mux_);
+  const bool idle = cur_.active && (nowMs - cur_.lastMs) >= cfg_.idleMs;
+  portEXIT_CRITICAL(&mux_);
+  if (idle) end_("idle", nowMs);
+}
+
+SessionManager::Session SessionManager::current() const {
+  portENTER_CRITICAL(&mux_);
+  const Session s = cur_;
+  portEXIT_CRITICAL(&mux_);
+  return s;
+}
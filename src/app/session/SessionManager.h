@@ -0,0 +1,49 @@
+#pragma once
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include "src/app/event/RepEvent.h"
+#include "Members.h"
+
+// 운동 세션: 태그를 찍으면 시작, 같은 태그 재태깅 또는 idleMs 동안 rep 없으면 종료
+//  - onTag()  : nfc 태스크 (회원 조회는 여기서, 락 밖에서)
+//  - stamp()  : uplink 태스크, 큐에서 꺼낸 rep 이벤트에 현재 세션 태그를 붙임
+//  - poll()   : uplink 태스크, idle 종료 판정
+class SessionManager {
+public:
+  struct Config {
+    uint32_t idleMs      = 300000;  // 마지막 rep/태깅 이후 세션 유지 시간
+    uint32_t retapGuardMs = 3000;   // 시작 직후 같은 태그 재인식은 종료로 보지 않음
+  };
+
+  struct Session {
+    bool     active;
+    uint32_t id;                    // 부팅 이후 일련번호
+    uint8_t  uid[Members::kUidMax];
+    uint8_t  uidLen;
+    bool     known;                 // 회원 테이블에 있는 UID
+    char     member[Members::kMemberIdMax + 1];
+    uint32_t startMs;
+    uint32_t lastMs;                // 마지막 활동 (rep/태깅)
+    uint32_t reps;
+  };
+
+  explicit SessionManager(const Config& cfg = Config{}) : cfg_(cfg) {}
+
+  void setIdleMs(uint32_t ms) { cfg_.idleMs = ms; }
+
+  void onTag(const uint8_t* uid, uint8_t uidLen, uint32_t nowMs);
+  // 세션 중이면 ev 에 태그를 붙이고 true
+  bool stamp(RepEvent& ev);
+  void poll(uint32_t nowMs);
+
+  Session current() const;
+
+private:
+  void start_(const uint8_t* uid, uint8_t uidLen, bool known, const char* member, uint32_t nowMs);
+  void end_(const char* why, uint32_t nowMs);
+
+  Config  cfg_;
+  Session cur_{};
+  uint32_t nextId_ = 1;
+  mutable portMUX_TYPE mux_ = portMUX_INITIALIZER_UNLOCKED;
+};
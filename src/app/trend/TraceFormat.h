@@ -0,0 +1,41 @@
+#pragma once
+#include <stdint.h>
+
+// 거리 트레이스 바이너리 포맷 (리틀엔디언)
+//   [TraceHeader 16B][TraceRecord 12B × N]
+//  - 호스트 리플레이 도구(host/replay)가 읽고, 기기 쪽 기록기가 같은 레이아웃으로 내보냄
+//  - count == 0 이면 EOF 까지 레코드 (스트리밍으로 받은 파일)
+//  - kRepLabel 은 사람이 붙인 정답(반복 최저점), kRepDetected 는 기록 당시 감지기 출력
+
+namespace TraceFormat {
+
+  constexpr uint32_t kMagic   = 0x52544247;   // "GBTR"
+  constexpr uint16_t kVersion = 1;
+
+  enum Flags : uint8_t {
+    kRepLabel    = 0x01,
+    kRepDetected = 0x02,
+    kInvalid     = 0x04,   // 센서 무효 측정(mm 는 0)
+  };
+
+  struct TraceHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recSize;       // sizeof(TraceRecord) — 필드 추가 시 앞쪽 호환
+    uint32_t count;
+    uint32_t periodUs;      // 명목 샘플 주기 (0 = 모름)
+  };
+
+  struct TraceRecord {
+    uint32_t tUs;           // micros()
+    uint16_t raw;           // 센서 원시값(mm)
+    uint16_t mm;            // 필터 출력(mm)
+    uint8_t  phase;         // TrendDetector::Phase
+    uint8_t  flags;         // Flags
+    uint16_t rsv;
+  };
+
+  static_assert(sizeof(TraceHeader) == 16, "TraceHeader layout");
+  static_assert(sizeof(TraceRecord) == 12, "TraceRecord layout");
+
+} // namespace TraceFormat
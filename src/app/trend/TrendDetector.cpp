@@ -1,37 +1,97 @@
 #include "TrendDetector.h"
+#include "src/util/tracer/Tracer.h"
 
 TrendDetector::TrendDetector() : params_(Params{}) {}
 TrendDetector::TrendDetector(const Params& p) : params_(p) {}
 
+namespace {
+  inline uint16_t clampU16_(uint32_t v) { return v > 0xFFFF ? 0xFFFF : (uint16_t)v; }
+  constexpr uint32_t kMaxDtUs = 1000000;   // 이보다 긴 공백(센서 끊김 등)은 속도 계산에서 제외
+}
+
 void TrendDetector::reset() {
   snap_ = Snapshot{};
+  velQ4_ = peakVel_ = 0;
+  open_ = ready_ = false;
+}
+
+void TrendDetector::finishRep_() {
+  const uint32_t ecc = (minUs_ - topUs_) / 1000;
+  const uint32_t con = (maxUs_ - minUs_) / 1000;
+  const uint16_t rom = snap_.maxv > bot_ ? snap_.maxv - bot_ : 0;
+  rep_.minv         = bot_;
+  rep_.maxv         = snap_.maxv;
+  rep_.romMm        = rom;
+  rep_.eccentricMs  = clampU16_(ecc);
+  rep_.concentricMs = clampU16_(con);
+  rep_.tutMs        = clampU16_(ecc + con);
+  rep_.peakVelMms   = clampU16_(peakVel_ > 0 ? (uint32_t)peakVel_ : 0);
+  rep_.meanVelMms   = con ? clampU16_((uint32_t)rom * 1000u / con) : 0;
+  open_  = false;
+  ready_ = true;
 }
 
-bool TrendDetector::step(uint16_t d) {
-  if (d == 0 || d > params_.max_range_mm) return false;
+bool TrendDetector::takeRep(RepMetrics& out) {
+  if (!ready_) return false;
+  out = rep_;
+  ready_ = false;
+  return true;
+}
+
+void TrendDetector::tick(uint32_t tUs) {
+  if (open_ && (uint32_t)(tUs - maxUs_) >= (uint32_t)params_.settle_ms * 1000u) finishRep_();
+}
+
+bool TrendDetector::step(uint16_t d, uint32_t tUs) {
+  TRACE_SCOPE("trend.step");
+  if (d == 0 || d > params_.max_range_mm) {
+    // 세트 마지막 반복 뒤 사용자가 범위를 벗어남 → 다음 사람의 첫 샘플까지 미루지 않음
+    if (open_) finishRep_();
+    return false;
+  }
 
   if (snap_.last == 0) {
     snap_.last  = snap_.minv = snap_.maxv = d;
     snap_.phase = Phase::Idle;
+    lastUs_ = topUs_ = tUs;
     return false;
   }
 
+  // 1차 차분 → 1/2 IIR 평활. mm/s, 4bit 소수부
+  // Δmm·10^6/dt 를 32bit 로: 10^6/64 = 15625, dt 는 64us 단위 (max_range 2000mm 에서도 넘치지 않음)
+  const uint32_t prevUs = lastUs_;
+  const uint32_t dt64 = (tUs - prevUs) >> 6;
+  lastUs_ = tUs;
+  if (dt64 && dt64 < (kMaxDtUs >> 6)) {
+    int32_t v = ((int32_t)d - (int32_t)snap_.last) * 15625 / (int32_t)dt64;
+    if (v > 32767) v = 32767; else if (v < -32767) v = -32767;
+    velQ4_ += (v * 16 - velQ4_) >> 1;
+    snap_.velMms = (int16_t)(velQ4_ >> 4);
+  }
+
   switch (snap_.phase) {
     case Phase::Idle:
       if (snap_.last >= d && (snap_.last - d) >= params_.noise_mm) {
         snap_.phase = Phase::Down;
         snap_.minv  = d;
         snap_.maxv  = d;
+        topUs_ = prevUs;
+        bot_ = d; minUs_ = tUs;
       }
       break;
 
     case Phase::Down:
+      if (d < bot_) { bot_ = d; minUs_ = tUs; }
       if (d + params_.noise_mm < snap_.minv) {
         snap_.minv = d;
       } else if (d >= static_cast<uint16_t>(snap_.minv + params_.noise_mm)) {
         snap_.phase = Phase::Up;
         snap_.maxv  = d;
         snap_.last  = d;
+        snap_.reps++;
+        maxUs_   = leaveUs_ = tUs;
+        peakVel_ = snap_.velMms;
+        open_    = true;
         return true; // ← Send 타이밍
       }
       break;
@@ -39,9 +99,21 @@ bool TrendDetector::step(uint16_t d) {
     case Phase::Up:
       if (d > snap_.maxv) {
         snap_.maxv = d;
+        maxUs_ = leaveUs_ = tUs;
       } else if (snap_.maxv >= d && (snap_.maxv - d) >= params_.noise_mm) {
+        // 다음 하강 시작 = 직전 반복의 최고점 확정
+        if (open_) finishRep_();
         snap_.phase = Phase::Down;
         snap_.minv  = d;
+        topUs_ = leaveUs_;
+        bot_ = d; minUs_ = tUs;
+        break;
+      }
+      if (d + params_.noise_mm / 2 >= snap_.maxv) leaveUs_ = tUs;   // 최고점 부근 정지 구간은 이심성에서 제외
+      if (open_) {
+        if (snap_.velMms > peakVel_) peakVel_ = snap_.velMms;
+        // 최고점에서 멈춘 채 settle_ms 경과 (세트 마지막 반복)
+        if ((uint32_t)(tUs - maxUs_) >= (uint32_t)params_.settle_ms * 1000u) finishRep_();
       }
       break;
   }
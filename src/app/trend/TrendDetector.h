@@ -8,9 +8,22 @@ public:
   struct Params {
     uint16_t noise_mm;
     uint16_t max_range_mm;
+    uint16_t settle_ms;      // 최고점 이후 이 시간 동안 새 최고점이 없으면 반복 완료
     // 기본값은 생성자에서 지정
-    constexpr Params(uint16_t noise = 20, uint16_t maxr = 2000)
-      : noise_mm(noise), max_range_mm(maxr) {}
+    constexpr Params(uint16_t noise = 20, uint16_t maxr = 2000, uint16_t settle = 400)
+      : noise_mm(noise), max_range_mm(maxr), settle_ms(settle) {}
+  };
+
+  // 반복 1회 지표. Down(거리 감소) = 이심성(eccentric), Up(거리 증가) = 구심성(concentric)
+  struct RepMetrics {
+    uint16_t minv;           // 최저점(mm)
+    uint16_t maxv;           // 반복을 마친 최고점(mm)
+    uint16_t romMm;          // 가동 범위 = maxv - minv
+    uint16_t eccentricMs;    // 시작 최고점 → 최저점
+    uint16_t concentricMs;   // 최저점 → 끝 최고점
+    uint16_t tutMs;          // time under tension = eccentric + concentric
+    uint16_t peakVelMms;     // 구심 구간 최고 속도(mm/s)
+    uint16_t meanVelMms;     // 구심 구간 평균 속도 = rom / concentric
   };
 
   struct Snapshot {
@@ -18,16 +31,40 @@ public:
     uint16_t last  = 0;
     uint16_t minv  = 0;
     uint16_t maxv  = 0;
+    int16_t  velMms = 0;     // 평활 속도(mm/s, +: 멀어짐)
+    uint32_t reps  = 0;      // 반등(카운트) 횟수
   };
 
   TrendDetector();                       // ← 디폴트 생성자 추가
   explicit TrendDetector(const Params& p);
 
   void reset();
-  bool step(uint16_t d);                 // 최저점에서 +noise 이상 반등 시 true
+  // 샘플 1개 처리 (O(1), 정수 연산만). tUs 는 샘플 시각(micros, 랩어라운드 허용)
+  // 반환: 최저점에서 +noise 이상 반등 시 true (카운트 시점)
+  bool step(uint16_t d, uint32_t tUs);
+  // 샘플이 없어도 주기적으로 (센서는 범위 밖/무효 측정을 버림 → step 이 안 불림)
+  // 반등 후 최고점에서 settle_ms 가 지났으면 반복 확정
+  void tick(uint32_t tUs);
+  // 반등 이후 최고점이 확정되면(다음 하강 시작 / settle_ms 정지 / 범위 밖) 한 번 true
+  bool takeRep(RepMetrics& out);
   const Snapshot& state() const { return snap_; }
 
 private:
+  void finishRep_();
+
   Params   params_{20, 2000};            // ← 기본 파라미터
   Snapshot snap_;
+
+  // 지표 계산용 (모두 샘플 시각 기준)
+  uint32_t lastUs_  = 0;
+  uint32_t topUs_   = 0;                 // 하강 시작 최고점 시각
+  uint16_t bot_     = 0;                 // 실제 최저점 (minv 는 noise 단위로만 갱신됨)
+  uint32_t minUs_   = 0;                 // 최저점 시각
+  uint32_t maxUs_   = 0;                 // 상승 중 최고점 시각 (구심성 끝)
+  uint32_t leaveUs_ = 0;                 // 최고점 부근을 마지막으로 지난 시각 (다음 이심성 시작)
+  int32_t  velQ4_   = 0;                 // 평활 속도 (mm/s, 4bit 소수부)
+  int32_t  peakVel_ = 0;
+  bool     open_    = false;             // 반등했고 아직 최고점 미확정
+  bool     ready_   = false;
+  RepMetrics rep_{};
 };
@@ -1,38 +1,160 @@
 #include "config.h"
+#include <nvs.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "src/util/log/Log.h"
 
 namespace {
-  Preferences prefs;
-  AppConfig cached;
   const char* NS = "cfg";
+  nvs_handle_t nvsHandle = 0;
+
+  // NVS 키 ↔ 필드 (타입은 예전 Preferences 와 같음: str / u16 / u32 → 기존 값 그대로 읽힘)
+  struct StrKey { const char* key; String   AppConfig::* m; };
+  struct U16Key { const char* key; uint16_t AppConfig::* m; };
+  struct U32Key { const char* key; uint32_t AppConfig::* m; };
+
+  const StrKey kStrKeys[] = {
+    {"apSsid",  &AppConfig::apSsid},
+    {"apPass",  &AppConfig::apPass},
+    {"staSsid", &AppConfig::staSsid},
+    {"staPass", &AppConfig::staPass},
+    {"admU",    &AppConfig::adminUser},
+    {"admP",    &AppConfig::adminPass},
+    {"srvUrl",  &AppConfig::serverUrl},
+    {"port",    &AppConfig::port},
+    {"devId",   &AppConfig::deviceId},
+  };
+  const U16Key kU16Keys[] = {
+    {"bMaxEv",  &AppConfig::batchMaxEvents},
+    {"bMaxB",   &AppConfig::batchMaxBytes},
+    {"radioPol", &AppConfig::radioPolicy},
+    {"listenInt", &AppConfig::listenInterval},
+    {"upHiWater", &AppConfig::uplinkHighWater},
+  };
+  const U32Key kU32Keys[] = {
+    {"ver",      &AppConfig::version},
+    {"bAgeMs",   &AppConfig::batchMaxAgeMs},
+    {"setIdle",  &AppConfig::setIdleMs},
+    {"sessIdle", &AppConfig::sessionIdleMs},
+    {"upWinMs",  &AppConfig::uplinkWindowMs},
+    {"apIdleOff", &AppConfig::apIdleOffMs},
+  };
+
+  portMUX_TYPE      mux = portMUX_INITIALIZER_UNLOCKED;   // 아래 4개 (포인터 교체만, 짧게)
+  Config::Snapshot  current;
+  uint32_t          rev     = 0;
+  uint32_t          savedMs = 0;
+  bool              pending = false;
+
+  Config::Snapshot  persisted;            // NVS 에 있는 값 (writeLock 안에서만)
+  SemaphoreHandle_t writeLock = nullptr;  // handle() ↔ flush()
+
+  String getStr_(const char* key, const String& def) {
+    size_t len = 0;
+    if (nvs_get_str(nvsHandle, key, nullptr, &len) != ESP_OK || !len) return def;
+    std::unique_ptr<char[]> buf(new char[len]);
+    if (nvs_get_str(nvsHandle, key, buf.get(), &len) != ESP_OK) return def;
+    return String(buf.get());
+  }
+
+  // old 와 다른 키만 set, 하나라도 있으면 commit 1회. 반환: 쓴 키 수 (-1 = 실패)
+  int writeDiff_(const AppConfig& now, const AppConfig& old) {
+    int n = 0;
+    esp_err_t err = ESP_OK;
+    auto check = [&](esp_err_t e) { if (e != ESP_OK && err == ESP_OK) err = e; n++; };
+    for (const auto& k : kStrKeys) if (now.*k.m != old.*k.m) check(nvs_set_str(nvsHandle, k.key, (now.*k.m).c_str()));
+    for (const auto& k : kU16Keys) if (now.*k.m != old.*k.m) check(nvs_set_u16(nvsHandle, k.key, now.*k.m));
+    for (const auto& k : kU32Keys) if (now.*k.m != old.*k.m) check(nvs_set_u32(nvsHandle, k.key, now.*k.m));
+    if (n && err == ESP_OK) err = nvs_commit(nvsHandle);
+    if (err != ESP_OK) {
+      LOGE("CFG", "NVS write failed: %s", esp_err_to_name(err));
+      return -1;
+    }
+    return n;
+  }
+
+  // writeLock 안에서
+  void commit_() {
+    portENTER_CRITICAL(&mux);
+    Config::Snapshot now = current;
+    const uint32_t r = rev;
+    pending = false;
+    portEXIT_CRITICAL(&mux);
+
+    const int n = writeDiff_(*now, *persisted);
+    if (n < 0) {
+      // 다음 handle() 에서 다시 (실패한 키는 persisted 와 계속 다르므로 다시 씀)
+      portENTER_CRITICAL(&mux);
+      pending = true;
+      savedMs = millis();
+      portEXIT_CRITICAL(&mux);
+      return;
+    }
+    persisted = now;
+    if (n) LOGI("CFG", "rev %lu saved (%d key%s)", (unsigned long)r, n, n == 1 ? "" : "s");
+  }
 }
 
 void Config::begin() {
-  prefs.begin(NS, false);
+  if (writeLock) return;
+  writeLock = xSemaphoreCreateMutex();
+  if (nvs_open(NS, NVS_READWRITE, &nvsHandle) != ESP_OK) {
+    LOGE("CFG", "nvs_open(%s) failed, using defaults", NS);
+    nvsHandle = 0;
+  }
+
   // 존재하면 로드
-  cached.apSsid  = prefs.getString("apSsid",  cached.apSsid);
-  cached.apPass  = prefs.getString("apPass",  cached.apPass);
-  cached.staSsid = prefs.getString("staSsid", cached.staSsid);
-  cached.staPass = prefs.getString("staPass", cached.staPass);
-  cached.adminUser = prefs.getString("admU",  cached.adminUser);
-  cached.adminPass = prefs.getString("admP",  cached.adminPass);
-  cached.serverUrl = prefs.getString("srvUrl", cached.serverUrl);
-  cached.port      = prefs.getString("port",    cached.port);
-  cached.version = prefs.getULong("ver", cached.version);
-  cached.deviceId = prefs.getString("devId", cached.deviceId);
+  auto cfg = std::make_shared<AppConfig>();
+  if (nvsHandle) {
+    for (const auto& k : kStrKeys) (*cfg).*k.m = getStr_(k.key, (*cfg).*k.m);
+    for (const auto& k : kU16Keys) nvs_get_u16(nvsHandle, k.key, &((*cfg).*k.m));   // 없으면 기본값 유지
+    for (const auto& k : kU32Keys) nvs_get_u32(nvsHandle, k.key, &((*cfg).*k.m));
+  }
+  current   = cfg;
+  persisted = cfg;
+}
+
+Config::Snapshot Config::get() {
+  portENTER_CRITICAL(&mux);
+  Snapshot s = current;
+  portEXIT_CRITICAL(&mux);
+  return s;
 }
 
-AppConfig Config::get() { return cached; }
+uint32_t Config::revision() {
+  portENTER_CRITICAL(&mux);
+  const uint32_t r = rev;
+  portEXIT_CRITICAL(&mux);
+  return r;
+}
 
 void Config::save(const AppConfig& cfg) {
-  cached = cfg;
-  prefs.putString("apSsid",  cached.apSsid);
-  prefs.putString("apPass",  cached.apPass);
-  prefs.putString("staSsid", cached.staSsid);
-  prefs.putString("staPass", cached.staPass);
-  prefs.putString("admU",    cached.adminUser);
-  prefs.putString("admP",    cached.adminPass);
-  prefs.putString("srvUrl",  cached.serverUrl);
-  prefs.putString("port",     cached.port);
-  prefs.putULong ("ver",     cached.version);
-  prefs.putString("devId",   cached.deviceId);
+  Snapshot next = std::make_shared<const AppConfig>(cfg);   // 할당/복사는 락 밖에서
+  portENTER_CRITICAL(&mux);
+  current.swap(next);
+  rev++;
+  savedMs = millis();
+  pending = true;
+  portEXIT_CRITICAL(&mux);
+  // next = 이전 스냅샷. 빌려 간 곳이 없으면 여기서 해제
+}
+
+void Config::handle() {
+  portENTER_CRITICAL(&mux);
+  const bool due = pending && (millis() - savedMs >= kCommitDelayMs);
+  portEXIT_CRITICAL(&mux);
+  if (!due || !nvsHandle) return;
+  xSemaphoreTake(writeLock, portMAX_DELAY);
+  commit_();
+  xSemaphoreGive(writeLock);
+}
+
+void Config::flush() {
+  if (!writeLock || !nvsHandle) return;
+  xSemaphoreTake(writeLock, portMAX_DELAY);
+  portENTER_CRITICAL(&mux);
+  const bool p = pending;
+  portEXIT_CRITICAL(&mux);
+  if (p) commit_();
+  xSemaphoreGive(writeLock);
 }
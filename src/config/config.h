@@ -1,6 +1,6 @@
 #pragma once
 #include <Arduino.h>
-#include <Preferences.h>
+#include <memory>
 
 struct AppConfig {
   // AP
@@ -18,10 +18,34 @@ struct AppConfig {
   // 버전/기타
   uint32_t version  = 0.1;
   String deviceId   = "GymBuddy-Yeongdeungpo-01";
+  // Uplink 배치 (batchMaxEvents <= 1 이면 이벤트 1건당 POST 1회)
+  uint16_t batchMaxEvents = 20;     // 배치당 최대 이벤트 수
+  uint16_t batchMaxBytes  = 900;    // 배치 본문 최대 크기 (RestSender maxBodyBytes 이하)
+  uint32_t batchMaxAgeMs  = 30000;  // 가장 오래된 미전송 이벤트가 이만큼 기다리면 flush
+  uint32_t setIdleMs      = 8000;   // rep 없이 이 시간이 지나면 세트 종료로 보고 즉시 flush
+  // 운동 세션 (태그 체크인)
+  uint32_t sessionIdleMs  = 300000; // rep 없이 이 시간이 지나면 세션 종료
+  // 라디오 절전 (RadioScheduler::Policy: 0=always_on 1=modem_sleep 2=scheduled)
+  uint16_t radioPolicy     = 2;
+  uint16_t listenInterval  = 3;      // MAX_MODEM 비콘 간격
+  uint32_t uplinkWindowMs  = 60000;  // scheduled: 업링크 창 주기
+  uint16_t uplinkHighWater = 10;     // scheduled: 미전송 이벤트가 이만큼이면 바로 창
+  uint32_t apIdleOffMs     = 0;      // STA 연결 중 AP 접속자가 없으면 이 시간 뒤 AP 끔 (0 = 항상 유지)
 };
 
+// 설정은 불변 스냅샷으로 공유
+//  - get(): 현재 스냅샷을 빌림 (String 복사 없음, 참조 카운트 +1). 들고 있는 동안 save() 가 와도 그대로 유효
+//  - save(): 새 스냅샷으로 즉시 교체 (revision +1). NVS 기록은 미룸
+//  - handle(): 마지막 save() 후 kCommitDelayMs 가 지나면 NVS 에 있는 값과 달라진 키만 쓰고 commit 1회
+//      → 연달아 여러 번 저장해도 기록/commit 은 한 번, 바뀌지 않은 키는 안 씀 (플래시 마모 ↓)
 namespace Config {
-  void begin();
-  AppConfig get();
-  void save(const AppConfig& cfg);
+  using Snapshot = std::shared_ptr<const AppConfig>;
+  constexpr uint32_t kCommitDelayMs = 1500;
+
+  void     begin();
+  Snapshot get();
+  uint32_t revision();
+  void     save(const AppConfig& cfg);
+  void     handle();   // loop 에서 주기적으로
+  void     flush();    // 재시작 전: 대기 중인 기록을 지금
 }
@@ -1,7 +1,17 @@
 #include "DistanceSensor.h"
+#include <esp_timer.h>
+#include "src/util/log/Log.h"
+#include "src/util/metrics/Metrics.h"
+#include "src/util/tracer/Tracer.h"
+
+namespace {
+  Metrics::Histogram g_readUs("gymbuddy_distance_read_seconds", "VL53L0X result read (I2C) latency",
+                              Metrics::kLatencyUs, 10, 1e-6f);
+  Metrics::Counter   g_readFail("gymbuddy_distance_read_failures_total", "Invalid or out-of-range distance results");
+}
 
 DistanceSensor::DistanceSensor(const Pins& pins, const Config& cfg, TwoWire& bus)
-: pins_(pins), cfg_(cfg), bus_(&bus) {}
+: pins_(pins), cfg_(cfg), bus_(&bus), filter_(cfg.filter) {}
 
 bool DistanceSensor::begin() {
   // 0) XSHUT 하드리셋
@@ -13,12 +23,12 @@ bool DistanceSensor::begin() {
     delay(10);
   }
 
-  Serial.printf("[DIST] SDA=%d SCL=%d\n", pins_.sda, pins_.scl);
+  LOGI("DIST", "SDA=%d SCL=%d", pins_.sda, pins_.scl);
 
   // 1) I2C 시작 — 먼저 100kHz로
   const uint32_t startHz = 100000;
   if (!bus_->begin(pins_.sda, pins_.scl, startHz)) {
-    Serial.println("[DIST] I2C begin failed");
+    LOGE("DIST", "I2C begin failed");
     return false;
   }
   delay(2);
@@ -27,7 +37,7 @@ bool DistanceSensor::begin() {
   bus_->beginTransmission(0x29);
   uint8_t rc = bus_->endTransmission();
   if (rc != 0) {
-    Serial.printf("[DIST] Ping 0x29 failed rc=%u (0=OK,2=addrNACK,3=dataNACK)\n", rc);
+    LOGE("DIST", "Ping 0x29 failed rc=%u (0=OK,2=addrNACK,3=dataNACK)", rc);
     return false;
   }
 
@@ -42,7 +52,7 @@ bool DistanceSensor::begin() {
   //     ok = lox_.begin();
 
   if (!ok) {
-    Serial.println("[DIST] VL53L0X begin() failed");
+    LOGE("DIST", "VL53L0X begin() failed");
     initialized_ = false;
     return false;
   }
@@ -53,25 +63,189 @@ bool DistanceSensor::begin() {
   }
 
   initialized_ = true;
-  Serial.println("[DIST] init OK");
+  if (cfg_.continuous && !startContinuous_()) {
+    LOGW("DIST", "continuous mode failed, fallback to single-shot");
+    cfg_.continuous = false;
+  }
+  LOGI("DIST", "init OK (%s)", cfg_.continuous ? (pins_.irq >= 0 ? "continuous/irq" : "continuous/poll") : "single-shot");
+  return true;
+}
+
+// ---------- 연속 측정 ----------
+
+bool DistanceSensor::startContinuous_() {
+  if (!lox_.setMeasurementTimingBudgetMicroSeconds(cfg_.timingBudgetUs)) {
+    LOGW("DIST", "timing budget %lu rejected", (unsigned long)cfg_.timingBudgetUs);
+  }
+  // GPIO1: 새 측정 완료 시 LOW (오픈드레인)
+  lox_.setGpioConfig(VL53L0X_DEVICEMODE_CONTINUOUS_RANGING,
+                     VL53L0X_GPIOFUNCTIONALITY_NEW_MEASURE_READY,
+                     VL53L0X_INTERRUPTPOLARITY_LOW);
+
+  if (xTaskCreatePinnedToCore(readerTask_, "dist", 3072, this, cfg_.readerPrio, &reader_, cfg_.readerCore) != pdPASS) {
+    return false;
+  }
+  if (pins_.irq >= 0) {
+    pinMode(pins_.irq, INPUT_PULLUP);
+    attachInterruptArg(pins_.irq, onDataReady_, this, FALLING);
+  }
+  winStartUs_ = (uint32_t)esp_timer_get_time();
+  lox_.startRangeContinuous(cfg_.periodMs);
   return true;
 }
 
+void IRAM_ATTR DistanceSensor::onDataReady_(void* arg) {
+  auto* self = static_cast<DistanceSensor*>(arg);
+  self->irqUs_ = (uint32_t)esp_timer_get_time();
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(self->reader_, &woken);
+  if (woken) portYIELD_FROM_ISR();
+}
+
+void DistanceSensor::setTiming(uint32_t timingBudgetUs, uint16_t periodMs) {
+  if (!cfg_.continuous || !reader_) return;
+  reqPeriodMs_.store(periodMs, std::memory_order_relaxed);
+  reqBudgetUs_.store(timingBudgetUs, std::memory_order_release);
+  xTaskNotifyGive(reader_);      // irq 대기 중이면 바로 깨움
+}
+
+// reader 태스크에서만
+void DistanceSensor::applyTiming_() {
+  const uint32_t budget = reqBudgetUs_.exchange(0, std::memory_order_acquire);
+  if (!budget) return;
+  const uint16_t period = reqPeriodMs_.load(std::memory_order_relaxed);
+  if (budget == cfg_.timingBudgetUs && period == cfg_.periodMs) return;
+  lox_.stopRangeContinuous();
+  if (!lox_.setMeasurementTimingBudgetMicroSeconds(budget)) {
+    LOGW("DIST", "timing budget %lu rejected", (unsigned long)budget);
+  }
+  cfg_.timingBudgetUs = budget;
+  cfg_.periodMs       = period;
+  lox_.startRangeContinuous(period);
+  filterReset_.store(true, std::memory_order_release);
+  LOGD("DIST", "timing %luus period %ums", (unsigned long)budget, period);
+}
+
+// I2C 는 ISR 에서 못 쓰므로 data-ready 통지를 받은 전용 태스크가 결과를 읽어 링에 넣음
+void DistanceSensor::readerTask_(void* arg) {
+  auto* self = static_cast<DistanceSensor*>(arg);
+  const bool useIrq = self->pins_.irq >= 0;
+  for (;;) {
+    self->applyTiming_();
+    if (useIrq) {
+      // 인터럽트가 빠져도 멈추지 않도록 타임아웃 후 상태 확인
+      const bool notified = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(200)) != 0;
+      if (self->reqBudgetUs_.load(std::memory_order_relaxed)) continue;   // setTiming() 이 깨움
+      if (!notified && !self->lox_.isRangeComplete()) continue;
+    } else {
+      // 측정 주기가 길면(절전 상태) 덜 자주 확인. 깨어난 직후 결과를 늦게 보지 않도록 최대 50ms
+      const uint16_t slow   = self->cfg_.periodMs / 4 < 50 ? self->cfg_.periodMs / 4 : 50;
+      const uint16_t pollMs = slow > self->cfg_.pollMs ? slow : self->cfg_.pollMs;
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(pollMs));
+      if (self->reqBudgetUs_.load(std::memory_order_relaxed)) continue;
+      if (!self->lox_.isRangeComplete()) continue;
+    }
+    const uint32_t t = useIrq ? self->irqUs_ : (uint32_t)esp_timer_get_time();
+    const uint32_t r0 = (uint32_t)esp_timer_get_time();
+    const uint16_t mm = self->lox_.readRangeResult();   // 결과 읽고 인터럽트 클리어
+    g_readUs.observe((uint32_t)esp_timer_get_time() - r0);
+    if (mm == 0xFFFF || self->lox_.readRangeStatus() == 4) {
+      g_readFail.inc();
+      portENTER_CRITICAL(&self->statMux_);
+      self->invalid_++;
+      portEXIT_CRITICAL(&self->statMux_);
+      continue;
+    }
+    self->push_(t, mm);
+  }
+}
+
+void DistanceSensor::push_(uint32_t tUs, uint16_t mm) {
+  const uint8_t w = wr_.load(std::memory_order_relaxed);
+  const bool full = (uint8_t)(w - rd_.load(std::memory_order_acquire)) >= kRingSize;
+
+  portENTER_CRITICAL(&statMux_);
+  if (lastUs_) {
+    const uint32_t dt = tUs - lastUs_;
+    nInt_++;
+    const float delta = dt - meanInt_;
+    meanInt_ += delta / nInt_;
+    m2Int_   += delta * (dt - meanInt_);
+    if (dt > maxInt_) maxInt_ = dt;
+  }
+  lastUs_ = tUs;
+  if (full) overflows_++;
+  else { samples_++; winSamples_++; }
+  portEXIT_CRITICAL(&statMux_);
+
+  if (full) return;                   // 소비자가 밀리면 새 샘플을 버림 (오래된 건 소비자가 가져감)
+  ring_[w % kRingSize] = Sample{tUs, mm, mm};
+  wr_.store((uint8_t)(w + 1), std::memory_order_release);
+}
+
+DistanceSensor::Stats DistanceSensor::stats() {
+  Stats s{};
+  const uint32_t now = (uint32_t)esp_timer_get_time();
+  portENTER_CRITICAL(&statMux_);
+  const uint32_t winUs = now - winStartUs_;
+  s.samples        = samples_;
+  s.invalid        = invalid_;
+  s.overflows      = overflows_;
+  s.rateHz         = winUs ? (winSamples_ * 1e6f / winUs) : 0.0f;
+  s.meanIntervalUs = meanInt_;
+  s.jitterUs       = (nInt_ > 1) ? sqrtf(m2Int_ / (nInt_ - 1)) : 0.0f;
+  s.maxIntervalUs  = maxInt_;
+  s.outliers       = filter_.outliers();
+  winSamples_ = 0;
+  winStartUs_ = now;
+  nInt_ = 0; meanInt_ = 0; m2Int_ = 0; maxInt_ = 0;
+  portEXIT_CRITICAL(&statMux_);
+  return s;
+}
+
 
 bool DistanceSensor::singleRead_(uint16_t& mm) {
   if (!initialized_) return false;
 
   VL53L0X_RangingMeasurementData_t measure;
+  const uint32_t r0 = (uint32_t)esp_timer_get_time();
   lox_.rangingTest(&measure, false); // debug=false
+  g_readUs.observe((uint32_t)esp_timer_get_time() - r0);
 
   if (measure.RangeStatus != 4) {    // 4 = out of range
     mm = measure.RangeMilliMeter;
     return true;
   }
+  g_readFail.inc();
   return false;
 }
 
+bool DistanceSensor::read(Sample& out) {
+  TRACE_SCOPE("dist.read");
+  if (!cfg_.continuous) {
+    if (!readSingle_(out.raw)) return false;
+    out.tUs = (uint32_t)esp_timer_get_time();
+  } else {
+    const uint8_t r = rd_.load(std::memory_order_relaxed);
+    if (r == wr_.load(std::memory_order_acquire)) return false;
+    out = ring_[r % kRingSize];
+    rd_.store((uint8_t)(r + 1), std::memory_order_release);
+  }
+  // 측정 주기가 바뀐 직후: 이전 주기로 채워진 창을 버림 (깨어난 뒤 첫 움직임을 이상치로 깎지 않도록)
+  if (filterReset_.exchange(false, std::memory_order_acquire)) filter_.reset();
+  // 샘플 1개당 필터 1스텝 — 출력 레이트 = 센서 레이트
+  out.mm = filter_.push(out.raw);
+  return true;
+}
+
 bool DistanceSensor::read(uint16_t& mm) {
+  Sample s;
+  if (!read(s)) return false;
+  mm = s.mm;
+  return true;
+}
+
+bool DistanceSensor::readSingle_(uint16_t& mm) {
   // 간단한 중앙값 필터 (medianN이 홀수일 때)
   uint8_t n = cfg_.medianN;
   if (n <= 1 || (n % 2) == 0) {
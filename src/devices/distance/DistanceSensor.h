@@ -2,6 +2,10 @@
 #include <Arduino.h>
 #include <Wire.h>
 #include <Adafruit_VL53L0X.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "src/util/stream_filter.h"
 
 class DistanceSensor {
 public:
@@ -16,15 +20,61 @@ public:
     uint32_t i2cHz = 400000;         // I2C 클럭
     uint16_t measureTimeoutMs = 200; // (참고용) Adafruit 라이브러리는 setTimeout 미제공
     uint16_t touchThresholdMm = 40;  // “터치” 판단 임계값
-    uint8_t  medianN = 3;            // 1/3/5 권장
+    uint8_t  medianN = 3;            // 1/3/5 권장 (단발 모드에서만 사용)
+    // 연속 측정 모드: GPIO1 data-ready 인터럽트(없으면 폴링) → 링버퍼, read() 는 즉시 반환
+    bool     continuous = true;
+    uint32_t timingBudgetUs = 33000; // 측정 1회 시간 (20000~200000)
+    uint16_t periodMs = 0;           // 0 = back-to-back
+    uint8_t  pollMs = 5;             // irq 핀 없을 때 완료 확인 주기
+    uint8_t  readerCore = 1;
+    UBaseType_t readerPrio = 6;      // 샘플 유실 방지: sense 태스크보다 높게
+    // read() 에서 샘플마다 적용하는 스트리밍 필터 (Hampel → Median → EMA)
+    FilterConfig filter{};
+  };
+
+  struct Sample {
+    uint32_t tUs;     // data-ready 시각 (esp_timer, 하위 32bit)
+    uint16_t mm;      // 필터 출력
+    uint16_t raw;     // 센서 원값
+  };
+
+  struct Stats {
+    uint32_t samples;       // 링에 들어간 샘플 수
+    uint32_t invalid;       // out-of-range 등으로 버린 측정
+    uint32_t overflows;     // 링 가득 차서 버린 샘플
+    float    rateHz;        // 직전 stats() 이후 평균 샘플레이트
+    float    meanIntervalUs;
+    float    jitterUs;      // 샘플 간격 표준편차
+    uint32_t maxIntervalUs;
+    uint32_t outliers;      // Hampel 이 치환한 샘플 수 (누적)
   };
   
   DistanceSensor(const Pins& pins, const Config& cfg, TwoWire& bus = Wire);
 
   bool begin();
-  bool read(uint16_t& mm);
+  bool read(uint16_t& mm);       // 연속 모드: 링에서 하나 꺼냄(없으면 false), 단발 모드: 중앙값 측정
+  bool read(Sample& s);
+  size_t available() const { return (uint8_t)(wr_.load() - rd_.load()); }
+
+  // 연속 모드 통계 (호출 시 구간 통계 초기화)
+  Stats stats();
+
+  // 측정 시간/주기 변경 (PowerManager 상태 전환). I2C 는 reader 태스크만 쓰므로 요청만 남기고
+  // reader 가 다음 루프에서 정지 → 적용 → 재시작. 샘플 간격이 바뀌므로 필터도 초기화
+  void setTiming(uint32_t timingBudgetUs, uint16_t periodMs);
+  uint32_t timingBudgetUs() const { return cfg_.timingBudgetUs; }
+  uint16_t periodMs() const { return cfg_.periodMs; }
 
 private:
+  static constexpr uint8_t kRingSize = 32;   // 2의 거듭제곱
+
+  static void IRAM_ATTR onDataReady_(void* arg);
+  static void readerTask_(void* arg);
+  bool startContinuous_();
+  void push_(uint32_t tUs, uint16_t mm);
+  bool readSingle_(uint16_t& mm);
+  void applyTiming_();
+
   Pins   pins_;
   TwoWire* bus_;
   Config cfg_;
@@ -32,4 +82,28 @@ private:
   bool initialized_ = false;
 
   bool singleRead_(uint16_t& mm);
+
+  // 연속 모드 (SPSC 링: reader 태스크 → read())
+  TaskHandle_t reader_ = nullptr;
+  volatile uint32_t irqUs_ = 0;
+  Sample ring_[kRingSize];
+  std::atomic<uint8_t> wr_{0};
+  std::atomic<uint8_t> rd_{0};
+
+  // setTiming() 요청 (budget 0 = 없음) → reader 태스크가 적용, 적용 후 read() 가 필터 초기화
+  std::atomic<uint32_t> reqBudgetUs_{0};
+  std::atomic<uint16_t> reqPeriodMs_{0};
+  std::atomic<bool>     filterReset_{false};
+
+  // 간격 통계 (reader 태스크에서만 갱신, Welford)
+  uint32_t lastUs_ = 0;
+  uint32_t nInt_ = 0;
+  float    meanInt_ = 0, m2Int_ = 0;
+  uint32_t maxInt_ = 0;
+  uint32_t samples_ = 0, invalid_ = 0, overflows_ = 0;
+  uint32_t winSamples_ = 0;
+  uint32_t winStartUs_ = 0;
+  portMUX_TYPE statMux_ = portMUX_INITIALIZER_UNLOCKED;
+
+  FilterChain filter_;               // read() 호출 태스크에서만 사용
 };
@@ -5,6 +5,8 @@
 static int        g_pin      = 10;
 static uint32_t   g_freqHz   = Laser::DEFAULT_FREQ; // 예: 2000
 static uint8_t    g_dutyPct  = Laser::DEFAULT_DUTY; // 예: 70
+static uint8_t    g_scalePct = 100;                 // dim() 배율
+static bool       g_on       = true;
 static const int  RES_BITS   = 10;                  // 0~1023 (LEDC_TIMER_10_BIT)
 
 // ESP32-S3는 LOW_SPEED 모드 사용
@@ -20,7 +22,7 @@ static inline uint32_t dutyFromPct(uint8_t pct) {
 }
 
 static void applyDuty() {
-  const uint32_t duty = dutyFromPct(g_dutyPct);
+  const uint32_t duty = dutyFromPct((uint8_t)((uint16_t)g_dutyPct * g_scalePct / 100u));
   ledc_set_duty(MODE, CH, duty);
   ledc_update_duty(MODE, CH);
 }
@@ -56,6 +58,7 @@ void Laser::begin(int pin, uint32_t freqHz, uint8_t dutyPct) {
 
 void Laser::setDuty(uint8_t dutyPct) {
   g_dutyPct = (dutyPct > 100) ? 100 : dutyPct;
+  g_on = true;
   applyDuty();
 }
 
@@ -68,13 +71,20 @@ void Laser::setFreq(uint32_t hz) {
 }
 
 void Laser::on() {
+  g_on = true;
   applyDuty(); // 마지막 듀티 재적용
 }
 
 void Laser::off() {
+  g_on = false;
   ledc_set_duty(MODE, CH, 0);
   ledc_update_duty(MODE, CH);
 }
 
+void Laser::dim(uint8_t scalePct) {
+  g_scalePct = (scalePct > 100) ? 100 : scalePct;
+  if (g_on) applyDuty();
+}
+
 uint8_t  Laser::duty() { return g_dutyPct; }
 uint32_t Laser::freq() { return g_freqHz; }
@@ -16,6 +16,8 @@ namespace Laser {
   void setFreq(uint32_t hz);       // 권장 2~5kHz
   void on();
   void off();
+  // 절전용 밝기 배율 (설정 duty 의 0~100%). duty() 값은 그대로, 켜져 있을 때만 반영
+  void dim(uint8_t scalePct);
   uint8_t  duty();
   uint32_t freq();
 }
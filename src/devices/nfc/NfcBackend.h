@@ -0,0 +1,17 @@
+#pragma once
+
+// PN532 전송 계층은 빌드 시 선택 (가상 호출 없음)
+//   0 = HSU(UART), 1 = SPI(DMA). 빌드 옵션 -DGYMBUDDY_NFC_SPI=1 또는 여기서 변경
+#ifndef GYMBUDDY_NFC_SPI
+#define GYMBUDDY_NFC_SPI 0
+#endif
+
+template <class Transport> class NfcReader;
+class Pn532Hsu;
+class Pn532Spi;
+
+#if GYMBUDDY_NFC_SPI
+using Nfc = NfcReader<Pn532Spi>;
+#else
+using Nfc = NfcReader<Pn532Hsu>;
+#endif
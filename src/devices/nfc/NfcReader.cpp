@@ -0,0 +1,310 @@
+#include "NfcReader.h"
+#include "src/util/metrics/Metrics.h"
+#include "src/util/tracer/Tracer.h"
+
+namespace {
+  using namespace Pn532;
+
+  constexpr uint8_t kAutoPollMifare   = 0x10;   // Mifare (106kbps A)
+  constexpr uint8_t kAutoPollIso14443 = 0x20;   // ISO/IEC14443-4A
+  constexpr uint8_t kUidMax           = 10;
+
+  // 106kbps A 타깃 데이터: Tg, SENS_RES(2), SEL_RES, NFCIDLength, NFCID1...
+  bool parseTarget106A_(const uint8_t* td, uint8_t avail, const uint8_t*& uid, uint8_t& uidLen) {
+    if (avail < 5) return false;
+    uidLen = td[4];
+    if (uidLen == 0 || uidLen > kUidMax || 5 + uidLen > avail) return false;
+    uid = td + 5;
+    return true;
+  }
+
+  Metrics::Counter g_reads("gymbuddy_nfc_reads_total", "Tag arrivals read by PN532");
+  Metrics::Counter g_errTimeout("gymbuddy_nfc_errors_total", "PN532 command errors", "kind=\"timeout\"");
+  Metrics::Counter g_errFrame("gymbuddy_nfc_errors_total", "PN532 command errors", "kind=\"bad_frame\"");
+}
+
+template <class T>
+bool NfcReader<T>::begin() {
+  static_assert(kUidMax == ::kUidMax, "UID size");
+  ready_ = false;
+  // 전송 계층 설정 후보(HSU: 보레이트)를 차례로 시도
+  for (uint8_t attempt = 0; link_.open(attempt); ++attempt) {
+    link_.wake();
+    parser_.reset();
+    uint32_t ver;
+    if (!firmware_(ver)) continue;
+
+    // SAMConfiguration: Normal mode, 타임아웃 1s, IRQ 핀 사용
+    const uint8_t sam[] = {kCmdSamConfiguration, 0x01, 0x14, 0x01};
+    // RFConfiguration MaxRetries: ATR_REQ, PSL_REQ, 패시브 활성화 재시도
+    const uint8_t rf[]  = {kCmdRfConfiguration, 0x05, 0xFF, 0x01, cfg_.passiveRetries};
+    if (transact_(sam, sizeof(sam), cfg_.respTimeoutMs) &&
+        transact_(rf, sizeof(rf), cfg_.respTimeoutMs)) {
+      st_ = St::Idle;
+      ready_ = true;
+      return true;
+    }
+  }
+  return false;
+}
+
+template <class T>
+bool NfcReader<T>::getFirmware(uint32_t& ver) {
+  return ready_ && firmware_(ver);
+}
+
+template <class T>
+bool NfcReader<T>::firmware_(uint32_t& ver) {
+  const uint8_t body[] = {kCmdGetFirmwareVersion};
+  // D5 03 IC Ver Rev Support
+  if (!transact_(body, sizeof(body), cfg_.respTimeoutMs) || rspLen_ < 6) return false;
+  ver = (uint32_t)rsp_[2] << 24 | (uint32_t)rsp_[3] << 16 | (uint32_t)rsp_[4] << 8 | rsp_[5];
+  return ver != 0;
+}
+
+template <class T>
+bool NfcReader<T>::readUID(uint8_t* uid, uint8_t& uidLen) {
+  TRACE_SCOPE("nfc.readUID");
+  if (!ready_) return false;
+  uidLen = 0;
+  const uint8_t body[] = {kCmdInListPassiveTarget, 0x01, 0x00};   // MaxTg=1, 106kbps A
+  if (!transact_(body, sizeof(body), cfg_.pollMs)) return false;
+  // D5 4B NbTg [TargetData...]
+  const uint8_t* p; uint8_t n;
+  if (rspLen_ < 3 || rsp_[2] < 1 || !parseTarget106A_(rsp_ + 3, rspLen_ - 3, p, n)) return false;
+  memcpy(uid, p, n);
+  uidLen = n;
+  return true;
+}
+
+template <class T>
+typename NfcReader<T>::Bench NfcReader<T>::benchExchange(uint16_t n) {
+  Bench b{0, 0, 0, 0, 0};
+  if (!ready_) { b.failed = n; return b; }
+  const uint8_t body[] = {kCmdGetFirmwareVersion};
+  uint64_t sum = 0;
+  for (uint16_t i = 0; i < n; ++i) {
+    const uint32_t t0 = micros();
+    const bool ok = transact_(body, sizeof(body), cfg_.respTimeoutMs);
+    const uint32_t dt = micros() - t0;
+    if (!ok) { b.failed++; continue; }
+    if (b.ok == 0 || dt < b.minUs) b.minUs = dt;
+    if (dt > b.maxUs) b.maxUs = dt;
+    sum += dt;
+    b.ok++;
+  }
+  if (b.ok) b.meanUs = (uint32_t)(sum / b.ok);
+  return b;
+}
+
+// ---------- 프레임 송수신 ----------
+
+template <class T>
+void NfcReader<T>::sendCmd_(const uint8_t* body, uint8_t len) {
+  uint8_t f[8 + kFrameMax];
+  link_.write(f, buildFrame(body, len, f));
+  sentMs_ = millis();
+  acked_  = false;
+}
+
+// 진행 중인 명령 취소 (호스트가 ACK 프레임을 보내면 PN532 는 현재 명령을 버림)
+template <class T>
+void NfcReader<T>::sendAbort_() {
+  link_.write(kAck, sizeof(kAck));
+  parser_.reset();
+}
+
+// 동기 명령: 응답 프레임이 rsp_ 에 올 때까지 대기 (begin/진단/벤치 전용)
+template <class T>
+bool NfcReader<T>::transact_(const uint8_t* body, uint8_t len, uint16_t timeoutMs) {
+  sendCmd_(body, len);
+  rspLen_ = 0;
+  bool done = false;
+  const uint32_t t0 = micros();
+  const uint32_t limitUs = (uint32_t)timeoutMs * 1000;
+  for (;;) {
+    link_.drain([&](uint8_t b) {
+      switch (parser_.feed(b)) {
+        case Rx::None:  return false;
+        case Rx::Ack:   acked_ = true; return true;
+        case Rx::Frame:
+          if (!done) {
+            rspLen_ = parser_.len();
+            memcpy(rsp_, parser_.data(), rspLen_);
+            done = true;
+          }
+          return true;
+        default:        stats_.badFrames++; g_errFrame.inc(); return true;
+      }
+    });
+    if (done) break;
+    const uint32_t el = micros() - t0;
+    if (el >= limitUs) {
+      stats_.timeouts++;
+      g_errTimeout.inc();
+      sendAbort_();
+      return false;
+    }
+    // 응답은 보통 수 ms 안에 옴: 처음 5ms 는 짧게 돌고(벤치 해상도) 그 뒤엔 틱 단위로 양보
+    if (el < 5000) delayMicroseconds(50); else delay(1);
+  }
+  if (rspLen_ < 2 || rsp_[0] != kPnToHost || rsp_[1] != (uint8_t)(body[0] + 1)) {   // 0x7F 에러 프레임 포함
+    stats_.badFrames++;
+    g_errFrame.inc();
+    return false;
+  }
+  stats_.frames++;
+  return true;
+}
+
+// ---------- 비동기 상태 머신 ----------
+
+template <class T>
+bool NfcReader<T>::onByte_(uint8_t b) {
+  switch (parser_.feed(b)) {
+    case Rx::None:  return false;
+    case Rx::Ack:   acked_ = true; return true;
+    case Rx::Frame: onFrame_(); return true;
+    default:        stats_.badFrames++; g_errFrame.inc(); return true;   // NACK/체크섬 오류
+  }
+}
+
+template <class T>
+void NfcReader<T>::onFrame_() {
+  const uint8_t* rx = parser_.data();
+  const uint8_t  len = parser_.len();
+  if (len < 2 || rx[0] != kPnToHost) { stats_.badFrames++; g_errFrame.inc(); return; }   // 0x7F 에러 프레임 포함
+  stats_.frames++;
+  const uint8_t cmd = rx[1];
+
+  if (cmd == kCmdInAutoPoll + 1 && st_ == St::WaitAutoPoll) {
+    // D5 61 NbTg [Type, Len, TargetData...]
+    const uint8_t* uid; uint8_t uidLen;
+    if (len >= 5 && rx[2] >= 1 &&
+        parseTarget106A_(rx + 5, rx[4] < len - 5 ? rx[4] : len - 5, uid, uidLen)) {
+      memcpy(uid_, uid, uidLen);
+      uidLen_ = uidLen;
+      misses_ = 0;
+      st_ = St::Present;
+      nextMs_ = millis() + cfg_.presenceMs;
+      emit_(TagEvent::Arrived);
+    } else {
+      st_ = St::Idle;                        // 타깃 없음/모르는 타입 → 다시 대기
+    }
+  } else if (cmd == kCmdInListPassiveTarget + 1 && st_ == St::WaitPresence) {
+    // D5 4B NbTg [TargetData...]
+    const uint8_t* uid = nullptr; uint8_t uidLen = 0;
+    const bool hit = len >= 3 && rx[2] >= 1 &&
+                     parseTarget106A_(rx + 3, len - 3, uid, uidLen);
+    stats_.lastRttMs = millis() - sentMs_;
+    presenceResult_(hit, uid, uidLen);
+  }
+}
+
+template <class T>
+void NfcReader<T>::startAutoPoll_() {
+  // PollNr=0xFF: 태그가 나타날 때까지 PN532 가 스스로 폴링 → 그동안 호스트는 할 일 없음
+  const uint8_t body[] = {kCmdInAutoPoll, 0xFF, cfg_.autoPollPeriod, kAutoPollMifare, kAutoPollIso14443};
+  sendCmd_(body, sizeof(body));
+  st_ = St::WaitAutoPoll;
+}
+
+template <class T>
+void NfcReader<T>::startPresence_() {
+  const uint8_t body[] = {kCmdInListPassiveTarget, 0x01, 0x00};   // MaxTg=1, 106kbps A
+  sendCmd_(body, sizeof(body));
+  st_ = St::WaitPresence;
+}
+
+template <class T>
+void NfcReader<T>::presenceResult_(bool hit, const uint8_t* uid, uint8_t uidLen) {
+  const bool same = hit && uidLen == uidLen_ && memcmp(uid, uid_, uidLen) == 0;
+  if (hit && !same) {
+    // 태그가 바뀜: 이전 태그 퇴장 후 새 태그 입장
+    emit_(TagEvent::Departed);
+    memcpy(uid_, uid, uidLen);
+    uidLen_ = uidLen;
+    emit_(TagEvent::Arrived);
+  }
+  misses_ = hit ? 0 : misses_ + 1;
+  if (misses_ >= cfg_.departMisses) {
+    emit_(TagEvent::Departed);
+    uidLen_ = 0;
+    misses_ = 0;
+    st_ = St::Idle;
+    return;
+  }
+  st_ = St::Present;
+  nextMs_ = millis() + cfg_.presenceMs;
+}
+
+template <class T>
+void NfcReader<T>::emit_(TagEvent t) {
+  if (t == TagEvent::Arrived) { stats_.arrivals++; g_reads.inc(); } else stats_.departures++;
+  if (!cb_) return;
+  Event ev;
+  ev.type = t;
+  memcpy(ev.uid, uid_, uidLen_);
+  ev.uidLen = uidLen_;
+  ev.ms = millis();
+  cb_(ev);
+}
+
+// 응답 대기 중: 수신 통지가 없는 전송 계층(IRQ 없는 SPI)은 상태 확인 주기로 깨어남
+template <class T>
+uint32_t NfcReader<T>::wait_(uint32_t ms) const {
+  const uint32_t iv = link_.pollIntervalMs();
+  return (iv && iv < ms) ? iv : ms;
+}
+
+template <class T>
+uint32_t NfcReader<T>::poll() {
+  TRACE_SCOPE("nfc.poll");
+  if (!ready_) return 1000;
+
+  link_.drain([this](uint8_t b) { return onByte_(b); });
+
+  const uint32_t now = millis();
+  switch (st_) {
+    case St::Idle:
+      startAutoPoll_();
+      return wait_(cfg_.respTimeoutMs);
+
+    case St::WaitAutoPoll: {
+      // ACK 조차 없으면 명령이 유실된 것 → 바로 재전송, ACK 받았으면 태그 올 때까지 대기
+      const uint32_t el = now - sentMs_;
+      const uint32_t limit = acked_ ? cfg_.rearmMs : cfg_.respTimeoutMs;
+      if (el >= limit) {
+        if (!acked_) { stats_.timeouts++; g_errTimeout.inc(); }
+        sendAbort_();
+        startAutoPoll_();
+        return wait_(cfg_.respTimeoutMs);
+      }
+      return wait_(limit - el);
+    }
+
+    case St::Present:
+      if ((int32_t)(now - nextMs_) >= 0) {
+        startPresence_();
+        return wait_(cfg_.respTimeoutMs);
+      }
+      return nextMs_ - now;
+
+    case St::WaitPresence: {
+      const uint32_t el = now - sentMs_;
+      if (el >= cfg_.respTimeoutMs) {
+        stats_.timeouts++;
+        g_errTimeout.inc();
+        sendAbort_();
+        presenceResult_(false, nullptr, 0);
+        return st_ == St::Idle ? 0 : cfg_.presenceMs;
+      }
+      return wait_(cfg_.respTimeoutMs - el);
+    }
+  }
+  return cfg_.presenceMs;
+}
+
+// 백엔드 둘 다 항상 컴파일 (선택되지 않은 쪽은 링크 시 제거)
+template class NfcReader<Pn532Hsu>;
+template class NfcReader<Pn532Spi>;
@@ -0,0 +1,127 @@
+#pragma once
+#include <Arduino.h>
+#include <functional>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "NfcBackend.h"
+#include "Pn532Frame.h"
+#include "Pn532Hsu.h"
+#include "Pn532Spi.h"
+
+// PN532 리더 (전송 계층은 템플릿 인자, 어떤 백엔드를 쓸지는 NfcBackend.h 의 Nfc)
+//  - 명령/응답 프레임, 초기화, 태그 상태 머신은 공통. 전송 계층은 바이트 송수신만 담당
+//      Transport::Pins / Config, open(attempt), wake(), write(), drain(sink),
+//      attachTask(), pollIntervalMs(), hwReset()
+//  - poll() 상태 머신
+//      Idle → InAutoPoll 전송 → 태그 들어오면 PN532 가 응답 → Arrived
+//      Present → presenceMs 마다 InListPassiveTarget(짧은 재시도) → departMisses 연속 실패 시 Departed
+//  - 수신(UART RX 콜백 / SPI IRQ)이 attachTask() 로 등록한 태스크를 깨움 → 응답 대기 중 CPU 0
+template <class Transport>
+class NfcReader {
+public:
+  using Pins = typename Transport::Pins;
+  struct Config {
+    typename Transport::Config link{};
+    uint16_t pollMs         = 50;     // readUID() (동기) 타임아웃
+    uint8_t  passiveRetries = 0x02;   // InListPassiveTarget 재시도 — 존재 확인이 짧게 끝나도록 (0xFF = 무한)
+    uint8_t  autoPollPeriod = 1;      // InAutoPoll 주기 (×150ms)
+    uint16_t presenceMs     = 200;    // 태그 있는 동안 존재 확인 주기
+    uint8_t  departMisses   = 2;      // 연속 미검출 횟수 → Departed
+    uint16_t respTimeoutMs  = 100;    // 명령 응답 타임아웃 (InAutoPoll 제외)
+    uint32_t rearmMs        = 30000;  // InAutoPoll 무응답 시 재전송 주기 (PN532 리셋 대비)
+  };
+
+  static constexpr const char* kLink = Transport::kName;
+  static constexpr uint8_t kUidMax = 10;
+
+  enum class TagEvent : uint8_t { Arrived, Departed };
+  struct Event {
+    TagEvent type;
+    uint8_t  uid[kUidMax];
+    uint8_t  uidLen;
+    uint32_t ms;          // millis()
+  };
+  using EventCallback = std::function<void(const Event&)>;
+
+  struct Stats {
+    uint32_t arrivals;
+    uint32_t departures;
+    uint32_t frames;      // 정상 응답 프레임
+    uint32_t badFrames;   // 체크섬 오류/NACK/에러 프레임
+    uint32_t timeouts;
+    uint32_t lastRttMs;   // 마지막 존재 확인 왕복 시간
+  };
+
+  // 명령 1회 왕복(전송 → ACK → 응답) 시간
+  struct Bench {
+    uint16_t ok;
+    uint16_t failed;
+    uint32_t meanUs;
+    uint32_t minUs;
+    uint32_t maxUs;
+  };
+
+  NfcReader(const Pins& pins, const Config& cfg) : cfg_(cfg), link_(pins, cfg.link) {}
+
+  // PN532 초기화 (전송 계층 설정 후보를 차례로 시도, 예: HSU 보레이트)
+  bool begin();
+
+  // 펌웨어 버전 조회 (성공 시 ver=0xICVVRRSS). poll() 시작 전에만 사용
+  bool getFirmware(uint32_t& ver);
+
+  // ISO14443A 태그 1회 폴링 (블로킹, 진단용 — poll() 과 같이 쓰지 말 것)
+  bool readUID(uint8_t* uid, uint8_t& uidLen);
+
+  // GetFirmwareVersion 을 n 회 주고받아 왕복 시간 측정 (블로킹, poll() 시작 전에만)
+  Bench benchExchange(uint16_t n);
+
+  // ---------- 비동기 ----------
+  void onEvent(EventCallback cb) { cb_ = std::move(cb); }
+  void attachTask(TaskHandle_t task) { link_.attachTask(task); }
+  // 받은 바이트 처리 + 상태 전이. 다음 호출까지 기다려도 되는 시간(ms) 반환
+  uint32_t poll();
+  bool present() const { return st_ == St::Present || st_ == St::WaitPresence; }
+  const Stats& stats() const { return stats_; }
+
+  // 수동 리셋(핀 제공 시)
+  void hwReset(uint16_t lowMs = 10, uint16_t waitMs = 50) { link_.hwReset(lowMs, waitMs); }
+
+private:
+  enum class St : uint8_t { Idle, WaitAutoPoll, Present, WaitPresence };
+  using Rx = Pn532::FrameParser::Result;
+
+  void sendCmd_(const uint8_t* body, uint8_t len);
+  void sendAbort_();
+  bool firmware_(uint32_t& ver);
+  bool transact_(const uint8_t* body, uint8_t len, uint16_t timeoutMs);
+  bool onByte_(uint8_t b);
+  void onFrame_();
+  void startAutoPoll_();
+  void startPresence_();
+  void presenceResult_(bool hit, const uint8_t* uid, uint8_t uidLen);
+  void emit_(TagEvent t);
+  uint32_t wait_(uint32_t ms) const;
+
+  Config    cfg_;
+  Transport link_;
+  bool      ready_ = false;
+
+  // 비동기 상태
+  St       st_ = St::Idle;
+  uint32_t sentMs_ = 0;       // 마지막 명령 전송 시각
+  uint32_t nextMs_ = 0;       // Present: 다음 존재 확인 시각
+  uint8_t  misses_ = 0;
+  bool     acked_  = false;
+  uint8_t  uid_[kUidMax];
+  uint8_t  uidLen_ = 0;
+
+  Pn532::FrameParser parser_;
+  uint8_t  rsp_[Pn532::kFrameMax];   // 동기 명령 응답 (TFI 부터)
+  uint8_t  rspLen_ = 0;
+
+  EventCallback cb_;
+  Stats         stats_{};
+};
+
+extern template class NfcReader<Pn532Hsu>;
+extern template class NfcReader<Pn532Spi>;
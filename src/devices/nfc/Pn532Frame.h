@@ -0,0 +1,88 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// PN532 정보 프레임 (HSU/SPI 공통)
+//   00 00 FF LEN LCS TFI DATA... DCS 00
+//   ACK  = 00 00 FF 00 FF 00,  NACK = 00 00 FF FF 00 00
+namespace Pn532 {
+  constexpr uint8_t kHostToPn = 0xD4;
+  constexpr uint8_t kPnToHost = 0xD5;
+  constexpr uint8_t kFrameMax = 64;                 // TFI 포함 최대 LEN (응답 기준)
+  constexpr size_t  kWireMax  = 7 + kFrameMax;      // 프리앰블~포스트앰블 포함
+
+  constexpr uint8_t kCmdGetFirmwareVersion  = 0x02;
+  constexpr uint8_t kCmdSamConfiguration    = 0x14;
+  constexpr uint8_t kCmdRfConfiguration     = 0x32;
+  constexpr uint8_t kCmdInListPassiveTarget = 0x4A;
+  constexpr uint8_t kCmdInAutoPoll          = 0x60;
+
+  constexpr uint8_t kAck[] = {0x00, 0x00, 0xFF, 0x00, 0xFF, 0x00};
+
+  // 명령 body(TFI 제외) → 전송 프레임. 반환: 바이트 수 (out 은 len + 8 이상)
+  inline size_t buildFrame(const uint8_t* body, uint8_t len, uint8_t* out) {
+    const uint8_t n = len + 1;                 // TFI 포함
+    size_t i = 0;
+    uint8_t sum = kHostToPn;
+    out[i++] = 0x00; out[i++] = 0x00; out[i++] = 0xFF;
+    out[i++] = n;    out[i++] = (uint8_t)(0x100 - n);
+    out[i++] = kHostToPn;
+    for (uint8_t k = 0; k < len; ++k) { out[i++] = body[k]; sum += body[k]; }
+    out[i++] = (uint8_t)(0x100 - sum);
+    out[i++] = 0x00;
+    return i;
+  }
+
+  // 바이트 단위 증분 파서. 전송 계층이 어떻게 잘라 주든 같은 결과
+  class FrameParser {
+  public:
+    enum class Result : uint8_t { None, Ack, Nack, Frame, Bad };
+
+    Result feed(uint8_t b) {
+      switch (st_) {
+        case St::Sync:
+          if (prev_ == 0x00 && b == 0xFF) st_ = St::Len;
+          prev_ = b;
+          return Result::None;
+
+        case St::Len:
+          len_ = b;
+          st_ = St::Lcs;
+          return Result::None;
+
+        case St::Lcs:
+          reset();
+          if (len_ == 0x00 && b == 0xFF) return Result::Ack;
+          if (len_ == 0xFF && b == 0x00) return Result::Nack;
+          if ((uint8_t)(len_ + b) != 0 || len_ == 0 || len_ > kFrameMax) return Result::Bad;
+          pos_ = 0; sum_ = 0;
+          st_ = St::Data;
+          return Result::None;
+
+        case St::Data:
+          buf_[pos_++] = b;
+          sum_ += b;
+          if (pos_ == len_) st_ = St::Dcs;
+          return Result::None;
+
+        case St::Dcs:
+          reset();
+          return (uint8_t)(sum_ + b) == 0 ? Result::Frame : Result::Bad;
+      }
+      return Result::None;
+    }
+
+    void reset() { st_ = St::Sync; prev_ = 0xFF; }
+
+    // Result::Frame 직후 유효: TFI 부터 LEN 바이트
+    const uint8_t* data() const { return buf_; }
+    uint8_t        len()  const { return len_; }
+
+  private:
+    enum class St : uint8_t { Sync, Len, Lcs, Data, Dcs };
+    St      st_   = St::Sync;
+    uint8_t prev_ = 0xFF;
+    uint8_t len_ = 0, pos_ = 0, sum_ = 0;
+    uint8_t buf_[kFrameMax];
+  };
+}
@@ -0,0 +1,54 @@
+#include "Pn532Hsu.h"
+
+Pn532Hsu::Pn532Hsu(const Pins& pins, const Config& cfg)
+: pins_(pins),
+  cfg_(cfg),
+  ser_(cfg.uart) {}
+
+bool Pn532Hsu::open(uint8_t attempt) {
+  long baud = 0;
+  if (attempt == 0) {
+    baud = cfg_.baudPrimary;
+    // 선택 RST 핀 처리 (첫 시도에서 한 번)
+    if (pins_.rst >= 0) {
+      pinMode(pins_.rst, OUTPUT);
+      digitalWrite(pins_.rst, HIGH);
+      delay(5);
+      hwReset(10, 50);
+    }
+  } else if (attempt == 1 && cfg_.baudFallback > 0 && cfg_.baudFallback != cfg_.baudPrimary) {
+    baud = cfg_.baudFallback;
+  } else {
+    return false;
+  }
+
+  ser_.end();
+  delay(5);
+  ser_.begin(baud, SERIAL_8N1, pins_.rx, pins_.tx);
+  delay(20);
+  return true;
+}
+
+// 파워다운 상태의 PN532 는 긴 0x55 프리앰블로 깨어남
+void Pn532Hsu::wake() {
+  static const uint8_t pre[] = {0x55, 0x55, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+  ser_.write(pre, sizeof(pre));
+  ser_.flush();
+  delay(2);
+  while (ser_.available() > 0) ser_.read();
+}
+
+void Pn532Hsu::attachTask(TaskHandle_t task) {
+  task_ = task;
+  // UART 이벤트 태스크에서 호출됨 (FIFO 임계/RX 타임아웃)
+  ser_.onReceive([this]() { if (task_) xTaskNotifyGive(task_); });
+}
+
+void Pn532Hsu::hwReset(uint16_t lowMs, uint16_t waitMs) {
+  if (pins_.rst < 0) return;
+  digitalWrite(pins_.rst, LOW);
+  delay(lowMs);
+  digitalWrite(pins_.rst, HIGH);
+  delay(waitMs);
+}
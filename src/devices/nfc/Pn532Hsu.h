@@ -0,0 +1,46 @@
+#pragma once
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// PN532 HSU(UART) 전송 계층 — NfcReader<Pn532Hsu>
+//  - open(n): n 번째 보레이트 후보로 UART 설정 (없으면 false)
+//  - drain(): RX FIFO 에 있는 바이트 전부를 sink 로 (블로킹 없음)
+//  - RX 콜백이 attachTask() 태스크를 깨우므로 폴링 주기 불필요
+class Pn532Hsu {
+public:
+  struct Pins {
+    int rx;          // ESP32 RX  <- PN532 TX
+    int tx;          // ESP32 TX  -> PN532 RX
+    int rst = -1;    // 선택: PN532 RST (없으면 -1)
+  };
+  struct Config {
+    long    baudPrimary  = 115200;   // 대부분 기본
+    long    baudFallback = 9600;     // 일부 보드 기본
+    uint8_t uart         = 2;        // ESP32-S3: UART2
+  };
+
+  static constexpr const char* kName = "HSU";
+
+  Pn532Hsu(const Pins& pins, const Config& cfg);
+
+  bool open(uint8_t attempt);
+  void wake();
+  void write(const uint8_t* buf, size_t n) { ser_.write(buf, n); }   // TX FIFO 에 넣고 바로 반환
+
+  // sink(uint8_t) 반환값은 무시 (UART 는 받은 바이트를 버릴 수 없음)
+  template <class Sink>
+  void drain(Sink&& sink) {
+    while (ser_.available() > 0) sink((uint8_t)ser_.read());
+  }
+
+  void attachTask(TaskHandle_t task);
+  uint32_t pollIntervalMs() const { return 0; }
+  void hwReset(uint16_t lowMs, uint16_t waitMs);
+
+private:
+  Pins           pins_;
+  Config         cfg_;
+  HardwareSerial ser_;
+  TaskHandle_t   task_ = nullptr;
+};
@@ -0,0 +1,125 @@
+#include "Pn532Spi.h"
+#include <driver/gpio.h>
+#include <esp_heap_caps.h>
+#include "src/util/log/Log.h"
+
+namespace {
+  constexpr uint8_t kSpiDataWrite = 0x01;
+  constexpr uint8_t kSpiStatRead  = 0x02;
+  constexpr uint8_t kSpiDataRead  = 0x03;
+}
+
+bool Pn532Spi::open(uint8_t attempt) {
+  if (attempt > 0) return false;              // SPI 는 탐색할 설정이 없음
+  if (dev_) return true;
+
+  if (pins_.rst >= 0) {
+    pinMode(pins_.rst, OUTPUT);
+    digitalWrite(pins_.rst, HIGH);
+    delay(5);
+    hwReset(10, 50);
+  }
+  if (pins_.irq >= 0) pinMode(pins_.irq, INPUT_PULLUP);
+  pinMode(pins_.ss, OUTPUT);
+  gpio_set_level((gpio_num_t)pins_.ss, 1);
+
+  tx_ = (uint8_t*)heap_caps_malloc(kBufSize, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+  rx_ = (uint8_t*)heap_caps_malloc(kBufSize, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+  if (!tx_ || !rx_) {
+    LOGE("NFC", "SPI DMA buffer alloc failed");
+    return false;
+  }
+
+  spi_bus_config_t bus = {};
+  bus.mosi_io_num     = pins_.mosi;
+  bus.miso_io_num     = pins_.miso;
+  bus.sclk_io_num     = pins_.sck;
+  bus.quadwp_io_num   = -1;
+  bus.quadhd_io_num   = -1;
+  bus.max_transfer_sz = kBufSize;
+  esp_err_t err = spi_bus_initialize(cfg_.host, &bus, SPI_DMA_CH_AUTO);
+  if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {   // INVALID_STATE = 다른 디바이스가 이미 버스 초기화
+    LOGE("NFC", "spi_bus_initialize failed: %s", esp_err_to_name(err));
+    return false;
+  }
+
+  spi_device_interface_config_t dev = {};
+  dev.mode           = 0;
+  dev.clock_speed_hz = (int)cfg_.spiHz;
+  dev.spics_io_num   = -1;                     // CS 는 직접 제어
+  dev.flags          = SPI_DEVICE_BIT_LSBFIRST;
+  dev.queue_size     = 1;
+  err = spi_bus_add_device(cfg_.host, &dev, &dev_);
+  if (err != ESP_OK) {
+    LOGE("NFC", "spi_bus_add_device failed: %s", esp_err_to_name(err));
+    dev_ = nullptr;
+    return false;
+  }
+
+  int khz = 0;
+  spi_device_get_actual_freq(dev_, &khz);
+  LOGI("NFC", "SPI %d kHz (requested %lu Hz, DMA)", khz, (unsigned long)cfg_.spiHz);
+  return true;
+}
+
+// CS 하강 에지로 깨어남. 내부 클럭이 안정될 때까지 약 2ms
+void Pn532Spi::wake() {
+  gpio_set_level((gpio_num_t)pins_.ss, 0);
+  delay(2);
+  gpio_set_level((gpio_num_t)pins_.ss, 1);
+  delay(1);
+}
+
+bool Pn532Spi::xfer_(size_t n, bool rx) {
+  spi_transaction_t t = {};
+  t.length    = n * 8;
+  t.tx_buffer = tx_;
+  t.rx_buffer = rx ? rx_ : nullptr;
+  gpio_set_level((gpio_num_t)pins_.ss, 0);
+  // 짧은 트랜잭션이라 큐/인터럽트 대신 폴링 전송 (데이터는 DMA)
+  const esp_err_t err = spi_device_polling_transmit(dev_, &t);
+  gpio_set_level((gpio_num_t)pins_.ss, 1);
+  return err == ESP_OK;
+}
+
+void Pn532Spi::write(const uint8_t* buf, size_t n) {
+  if (!dev_ || n + 1 > kBufSize) return;
+  tx_[0] = kSpiDataWrite;
+  memcpy(tx_ + 1, buf, n);
+  xfer_(n + 1, false);
+}
+
+bool Pn532Spi::ready_() {
+  if (!dev_) return false;
+  if (pins_.irq >= 0) return digitalRead(pins_.irq) == LOW;
+  tx_[0] = kSpiStatRead;
+  tx_[1] = 0x00;
+  return xfer_(2, true) && (rx_[1] & 0x01);
+}
+
+const uint8_t* Pn532Spi::read_() {
+  tx_[0] = kSpiDataRead;
+  memset(tx_ + 1, 0, Pn532::kWireMax);
+  return xfer_(1 + Pn532::kWireMax, true) ? rx_ + 1 : nullptr;
+}
+
+void IRAM_ATTR Pn532Spi::onIrq_(void* arg) {
+  auto* self = static_cast<Pn532Spi*>(arg);
+  if (!self->task_) return;
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(self->task_, &woken);
+  if (woken) portYIELD_FROM_ISR();
+}
+
+void Pn532Spi::attachTask(TaskHandle_t task) {
+  task_ = task;
+  if (pins_.irq >= 0) attachInterruptArg(pins_.irq, onIrq_, this, FALLING);
+}
+
+void Pn532Spi::hwReset(uint16_t lowMs, uint16_t waitMs) {
+  if (pins_.rst < 0) return;
+  digitalWrite(pins_.rst, LOW);
+  delay(lowMs);
+  digitalWrite(pins_.rst, HIGH);
+  delay(waitMs);
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <driver/spi_master.h>
+#include "Pn532Frame.h"
+
+// PN532 SPI 전송 계층 — NfcReader<Pn532Spi>
+//  - ESP-IDF spi_master 에 직접 디바이스 등록 (cfg.spiHz, mode 0, LSB first, DMA 버퍼)
+//  - PN532 SPI 는 첫 바이트로 동작 선택: 0x01 쓰기 / 0x02 상태(bit0 = 응답 준비) / 0x03 읽기
+//  - CS 는 GPIO 로 직접 제어 (웨이크업 시 CS LOW 유지가 필요해서)
+//  - IRQ 핀이 있으면 준비 신호(LOW)에 태스크를 깨우고, 없으면 pollMs 마다 상태 바이트 확인
+class Pn532Spi {
+public:
+  struct Pins {
+    int sck;         // SPI SCK
+    int miso;        // SPI MISO
+    int mosi;        // SPI MOSI
+    int ss;          // SPI CS (SS)
+    int rst = -1;    // 선택, 없으면 -1
+    int irq = -1;    // 선택, 없으면 -1 (상태 폴링)
+  };
+  struct Config {
+    uint32_t          spiHz  = 1000000;   // PN532 최대 5MHz
+    spi_host_device_t host   = SPI2_HOST; // FSPI
+    uint8_t           pollMs = 5;         // IRQ 없을 때 응답 대기 중 상태 확인 주기
+  };
+
+  static constexpr const char* kName = "SPI";
+
+  Pn532Spi(const Pins& pins, const Config& cfg) : pins_(pins), cfg_(cfg) {}
+
+  bool open(uint8_t attempt);
+  void wake();
+  void write(const uint8_t* buf, size_t n);
+
+  // 응답이 준비돼 있으면 한 번에 읽어 sink 로. sink 가 true(프레임/ACK 완성)를 돌려주면
+  // 나머지(PN532 가 채워 보내는 쓰레기)는 버림. ACK 뒤 응답까지 준비된 경우를 위해 최대 2 단위
+  template <class Sink>
+  void drain(Sink&& sink) {
+    for (uint8_t unit = 0; unit < 2 && ready_(); ++unit) {
+      const uint8_t* p = read_();
+      if (!p) return;
+      for (size_t i = 0; i < Pn532::kWireMax; ++i)
+        if (sink(p[i])) break;
+    }
+  }
+
+  void attachTask(TaskHandle_t task);
+  uint32_t pollIntervalMs() const { return pins_.irq >= 0 ? 0 : cfg_.pollMs; }
+  void hwReset(uint16_t lowMs, uint16_t waitMs);
+
+private:
+  static constexpr size_t kBufSize = (1 + Pn532::kWireMax + 3) & ~size_t(3);   // DMA: 4바이트 단위
+
+  bool ready_();
+  const uint8_t* read_();
+  bool xfer_(size_t n, bool rx);
+  static void IRAM_ATTR onIrq_(void* arg);
+
+  Pins                pins_;
+  Config              cfg_;
+  spi_device_handle_t dev_ = nullptr;
+  uint8_t*            tx_  = nullptr;    // DMA 가능 내부 RAM
+  uint8_t*            rx_  = nullptr;
+  TaskHandle_t        task_ = nullptr;
+};
@@ -1,4 +1,9 @@
 #include "power.h"
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "src/util/log/Log.h"
+#include "src/util/metrics/Metrics.h"
 
 namespace {
   constexpr uint32_t kEnablePulseHighUs   = 200;  // Datasheet: 50us~1ms HIGH pulse.
@@ -9,17 +14,93 @@ namespace {
   constexpr uint8_t  kDisablePulseCount   = 2;    // Two consecutive pulses disable charging.
   constexpr uint32_t kPostSequenceDelayUs = 500;  // Allow BAT_EN latch to settle.
 
-  int     g_adcPin            = 8;
-  float   g_vref              = 3.30f;
-  float   g_gain              = 2.0f;
-  uint8_t g_bits              = 12;
+  constexpr uint8_t  kSeedSamples         = 32;   // one-shot reads averaged to seed the filter
+  constexpr uint32_t kFallbackPeriodMs    = 125;  // one-shot mode: one oversampled frame per period
+
   int8_t  g_batEnPin          = -1;
   bool    g_chargerConfigured = false;
   bool    g_isCharging        = false;
 
+  // Battery monitor. Written by the monitor task only; readers load the cached floats.
+  uint8_t             g_adcPin = 8;
+  Power::MonitorConfig g_mon;
+  TaskHandle_t        g_monTask    = nullptr;
+  bool                g_continuous = false;
+  std::atomic<float>  g_vbat{NAN};
+  std::atomic<float>  g_soc{NAN};
+  std::atomic<float>  g_lastFrameV{NAN};
+  std::atomic<uint32_t> g_frames{0}, g_errors{0};
+
+  // Typical 1S Li-ion resting voltage vs. remaining capacity (ascending).
+  struct CurvePoint { float v; float pct; };
+  constexpr CurvePoint kDischarge[] = {
+    {3.27f,   0}, {3.61f,   5}, {3.69f,  10}, {3.71f,  15}, {3.73f,  20}, {3.75f,  25},
+    {3.77f,  30}, {3.79f,  35}, {3.80f,  40}, {3.82f,  45}, {3.84f,  50}, {3.85f,  55},
+    {3.87f,  60}, {3.91f,  65}, {3.95f,  70}, {3.98f,  75}, {4.02f,  80}, {4.08f,  85},
+    {4.11f,  90}, {4.15f,  95}, {4.20f, 100},
+  };
+
+  // Returns NaN until begin() seeds the filter.
+  Metrics::Gauge g_vbatGauge("gymbuddy_vbat_volts", "Battery voltage", [] { return Power::vbat(); });
+  Metrics::Gauge g_socGauge("gymbuddy_battery_soc_percent", "Estimated battery state of charge",
+                            [] { return Power::soc(); });
+
+  float socFromVolts(float v) {
+    constexpr size_t n = sizeof(kDischarge) / sizeof(kDischarge[0]);
+    if (v <= kDischarge[0].v)     return 0.0f;
+    if (v >= kDischarge[n - 1].v) return 100.0f;
+    size_t i = 1;
+    while (kDischarge[i].v < v) ++i;
+    const CurvePoint& a = kDischarge[i - 1];
+    const CurvePoint& b = kDischarge[i];
+    return a.pct + (v - a.v) * (b.pct - a.pct) / (b.v - a.v);
+  }
+
+  void publish(float frameV) {
+    g_lastFrameV.store(frameV, std::memory_order_relaxed);
+    const float prev = g_vbat.load(std::memory_order_relaxed);
+    const float v = isnan(prev) ? frameV : prev + g_mon.alpha * (frameV - prev);
+    g_vbat.store(v, std::memory_order_relaxed);
+    g_soc.store(socFromVolts(v), std::memory_order_relaxed);
+    g_frames.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Calibrated (eFuse curve fitting) one-shot average, in volts at the battery.
+  float oneShotVolts(uint16_t samples) {
+    uint32_t mv = 0;
+    for (uint16_t i = 0; i < samples; ++i) mv += analogReadMilliVolts(g_adcPin);
+    return mv / (float)samples / 1000.0f * g_mon.dividerGain;
+  }
+
+  // Runs from the ADC DMA ISR once per completed frame.
+  void ARDUINO_ISR_ATTR onAdcFrame() {
+    if (g_monTask) vTaskNotifyGiveFromISR(g_monTask, nullptr);
+  }
+
+  void monitorTask(void*) {
+    for (;;) {
+      if (!g_continuous) {
+        vTaskDelay(pdMS_TO_TICKS(kFallbackPeriodMs));
+        publish(oneShotVolts(g_mon.oversample > 64 ? 64 : g_mon.oversample));
+        continue;
+      }
+      if (!ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000))) {
+        g_errors.fetch_add(1, std::memory_order_relaxed);
+        continue;
+      }
+      // avg_read_mvolts: frame average of `oversample` conversions, already calibrated.
+      adc_continuous_data_t* frame = nullptr;
+      if (!analogContinuousRead(&frame, 0) || !frame) {
+        g_errors.fetch_add(1, std::memory_order_relaxed);
+        continue;
+      }
+      publish(frame[0].avg_read_mvolts / 1000.0f * g_mon.dividerGain);
+    }
+  }
+
   bool ensureChargerConfigured(const char* action) {
     if (!g_chargerConfigured) {
-      Serial.printf("[Power] Charger pin not configured; cannot %s.\n", action);
+      LOGE("Power", "Charger pin not configured; cannot %s.", action);
       return false;
     }
     return true;
@@ -44,23 +125,45 @@ namespace {
   }
 } // namespace
 
-void Power::begin(int adcPin, float vref, uint8_t adcBits, float dividerGain) {
-  g_adcPin = adcPin; g_vref = vref; g_bits = adcBits; g_gain = dividerGain;
-  analogReadResolution(g_bits);
-}
+void Power::begin(int adcPin, const MonitorConfig& cfg) {
+  if (g_monTask) return;
+  g_adcPin = (uint8_t)adcPin;
+  g_mon    = cfg;
+
+  // Seed the filter so vbat() is valid as soon as begin() returns.
+  publish(oneShotVolts(kSeedSamples));
+
+  // Frames completed before the task exists are simply dropped by onAdcFrame().
+  const uint8_t pins[] = { g_adcPin };
+  g_continuous = analogContinuous(pins, 1, cfg.oversample, cfg.sampleHz, &onAdcFrame) &&
+                 analogContinuousStart();
+  if (!g_continuous) {
+    analogContinuousDeinit();
+    LOGW("Power", "ADC continuous mode unavailable; using one-shot oversampling");
+  }
 
-float Power::vbat() {
-  uint32_t raw = analogRead(g_adcPin);
-  float v = (raw / (float)((1<<g_bits)-1)) * g_vref * g_gain;
-  return v;
+  if (xTaskCreatePinnedToCore(monitorTask, "vbat", cfg.stack, nullptr, cfg.prio, &g_monTask, cfg.core) != pdPASS) {
+    g_monTask = nullptr;
+    if (g_continuous) { analogContinuousStop(); analogContinuousDeinit(); }
+    LOGE("Power", "Battery monitor task create failed; vbat frozen at %.3f V", vbat());
+    return;
+  }
+  LOGI("Power", "VBAT %.3f V (%.0f%%), %s", vbat(), soc(), g_continuous ? "ADC DMA" : "one-shot");
 }
 
+float Power::vbat() { return g_vbat.load(std::memory_order_relaxed); }
+float Power::soc()  { return g_soc.load(std::memory_order_relaxed); }
+
 bool Power::isLow(float th) { return vbat() <= th; }
 
+Power::Stats Power::stats() {
+  return Stats{ g_continuous, g_frames.load(), g_errors.load(), g_lastFrameV.load() };
+}
+
 
 void Power::configureChargerPin(int batEnPin) {
   if (batEnPin < 0) {
-    Serial.println("[Power] Invalid BAT_EN pin");
+    LOGE("Power", "Invalid BAT_EN pin");
     return;
   }
 
@@ -71,7 +174,7 @@ void Power::configureChargerPin(int batEnPin) {
   pinMode(g_batEnPin, OUTPUT);
   digitalWrite(g_batEnPin, LOW);
 
-  Serial.printf("[Power] Charger BAT_EN pin configured on GPIO %d\n", g_batEnPin);
+  LOGI("Power", "Charger BAT_EN pin configured on GPIO %d", g_batEnPin);
 }
 
 bool Power::enableCharging() {
@@ -80,17 +183,17 @@ bool Power::enableCharging() {
   }
 
   if (g_isCharging) {
-    Serial.println("[Power] Charging already enabled");
+    LOGI("Power", "Charging already enabled");
     return true;
   }
 
   if (!sendPulseSequence(kEnablePulseCount, kEnablePulseHighUs, kEnablePulseLowUs)) {
-    Serial.println("[Power] Failed to send enable pulse sequence");
+    LOGE("Power", "Failed to send enable pulse sequence");
     return false;
   }
 
   g_isCharging = true;
-  Serial.println("[Power] Charging enabled");
+  LOGI("Power", "Charging enabled");
   return true;
 }
 
@@ -100,17 +203,17 @@ bool Power::disableCharging() {
   }
 
   if (!g_isCharging) {
-    Serial.println("[Power] Charging already disabled");
+    LOGI("Power", "Charging already disabled");
     return true;
   }
 
   if (!sendPulseSequence(kDisablePulseCount, kDisablePulseHighUs, kDisablePulseLowUs)) {
-    Serial.println("[Power] Failed to send disable pulse sequence");
+    LOGE("Power", "Failed to send disable pulse sequence");
     return false;
   }
 
   g_isCharging = false;
-  Serial.println("[Power] Charging disabled");
+  LOGI("Power", "Charging disabled");
   return true;
 }
 
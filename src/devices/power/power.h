@@ -3,10 +3,32 @@
 #define RT9532_BAT_EN_PIN 19
 
 
+// Battery monitor: the ADC runs in continuous (DMA) mode and a low-priority task
+// filters the eFuse-calibrated frame averages. vbat()/soc() only read the cache.
+// Falls back to oversampled calibrated one-shot reads if continuous mode fails.
 namespace Power {
-  void begin(int adcPin, float vref = 3.30f, uint8_t adcBits = 12, float dividerGain = 2.0f);
-  float vbat();        // 전압(V)
+  struct MonitorConfig {
+    float       dividerGain = 2.0f;    // VBAT = pin voltage * gain
+    uint32_t    sampleHz    = 2000;    // ADC conversion rate (S3: >= 611)
+    uint16_t    oversample  = 256;     // conversions averaged per frame (~8 frames/s)
+    float       alpha       = 0.05f;   // EMA weight per frame (~2.5 s time constant)
+    uint8_t     core        = 0;
+    UBaseType_t prio        = 1;
+    uint32_t    stack       = 2560;
+  };
+
+  struct Stats {
+    bool     continuous;   // false = one-shot fallback
+    uint32_t frames;       // filtered frames since boot
+    uint32_t errors;       // failed/empty reads
+    float    lastFrameV;   // unfiltered, latest frame
+  };
+
+  void  begin(int adcPin, const MonitorConfig& cfg = MonitorConfig{});
+  float vbat();        // 전압(V), filtered (cached, constant time)
+  float soc();         // state of charge 0..100 % from the resting discharge curve
   bool  isLow(float th = 3.6f);   // 임계치 이하 체크
+  Stats stats();
   void configureChargerPin(int batEnPin = RT9532_BAT_EN_PIN);
   bool enableCharging();
   bool disableCharging();
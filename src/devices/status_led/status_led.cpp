@@ -1,5 +1,11 @@
 #include "status_led.h"
+#include <atomic>
+#include <esp_timer.h>
+#include <soc/gpio_reg.h>
+#include <LittleFS.h>
+#include <ArduinoJson.h>
 #include "src/devices/power/power.h"
+#include "src/util/log/Log.h"
 
 namespace StatusLED {
     namespace {
@@ -20,97 +26,86 @@ namespace StatusLED {
 
     constexpr uint32_t STATUS_EVAL_INTERVAL_MS = 200;
 
-    constexpr uint32_t LOW_ON_MS       = 1500;
-    constexpr uint32_t LOW_OFF_MS      = 1500;
-    constexpr uint32_t CHG_ON_MS       = 500;
-    constexpr uint32_t CHG_OFF_MS      = 500;
-    constexpr uint32_t GOOD_ON_MS      = 1000;
-    constexpr uint32_t GOOD_OFF_MS     = 3000;
-
-    enum class Status {
-        Unknown,
-        Low,
-        Charging,
-        Charged,
-        BatteryGood,
-    };
-
-    struct Step {
-        uint32_t durationMs;
-        uint8_t  mask;
-    };
+    constexpr const char* PATTERN_FILE = "/leds.json";
 
     constexpr uint8_t MASK_RED    = 0x01;
     constexpr uint8_t MASK_YELLOW = 0x02;
     constexpr uint8_t MASK_GREEN  = 0x04;
     constexpr uint8_t MASK_BLUE   = 0x08;
 
-    constexpr Step PATTERN_LOW[] = {
-        {LOW_ON_MS, MASK_RED},
-        {LOW_OFF_MS, 0},
-    };
+    // Bit i of a mask drives LED_PINS[i]. W1TS/W1TC registers below cover GPIO 0..31.
+    constexpr uint8_t LED_PINS[] = {RED_PIN, YELLOW_PIN, GREEN_PIN, BLUE_PIN};
+    static_assert(RED_PIN < 32 && YELLOW_PIN < 32 && GREEN_PIN < 32 && BLUE_PIN < 32,
+                  "LED pins must be in GPIO bank 0");
 
-    constexpr Step PATTERN_CHARGING[] = {
-        {CHG_ON_MS, MASK_YELLOW},
-        {CHG_OFF_MS, 0},
+    constexpr uint8_t MAX_PATTERNS = 16;
+    constexpr uint8_t MAX_STEPS    = 8;
+    constexpr uint8_t PATTERN_NAME_MAX     = 15;
+
+    struct Step {
+        uint32_t durationMs;   // 0 = hold this step
+        uint8_t  mask;
     };
 
-    constexpr Step PATTERN_CHARGED[] = {
-        {0, MASK_GREEN},
+    struct Pattern {
+        char    name[PATTERN_NAME_MAX + 1];
+        uint8_t priority;      // higher wins
+        uint8_t length;
+        Step    steps[MAX_STEPS];
     };
 
-    constexpr Step PATTERN_GOOD[] = {
-        {GOOD_ON_MS, MASK_BLUE},
-        {GOOD_OFF_MS, 0},
+    // Built-in patterns. Battery ones are mutually exclusive; the rest are raised via set().
+    Pattern g_patterns[MAX_PATTERNS] = {
+        {"ota",            100, 2, {{100, MASK_YELLOW}, {100, MASK_GREEN}}},
+        {"low",             90, 2, {{1500, MASK_RED}, {1500, 0}}},
+        {"wifi_lost",       60, 4, {{150, MASK_BLUE}, {150, 0}, {150, MASK_BLUE}, {1550, 0}}},
+        {"uplink_backlog",  50, 2, {{100, MASK_YELLOW}, {1900, 0}}},
+        {"charging",        40, 2, {{500, MASK_YELLOW}, {500, 0}}},
+        {"charged",         30, 1, {{0, MASK_GREEN}}},
+        {"good",            20, 2, {{1000, MASK_BLUE}, {3000, 0}}},
     };
+    std::atomic<uint8_t> g_count{7};
 
-    const Step* g_pattern = nullptr;
-    size_t g_patternLength = 0;
-    size_t g_stepIndex = 0;
-    uint32_t g_stepStart = 0;
-    bool g_stepApplied = false;
-    Status g_currentStatus = Status::Unknown;
-    uint32_t g_lastEval = 0;
-    bool g_initialized = false;
-
-    bool ensureOutputPin(uint8_t pin) {
-        if (!digitalPinIsValid(pin)) {
-            Serial.printf("[StatusLED] Invalid LED GPIO %u\n", pin);
-            return false;
-        }
-        pinMode(pin, OUTPUT);
-        digitalWrite(pin, LOW);
-        return true;
+    enum class Status : uint8_t { Unknown, Low, Charging, Charged, BatteryGood };
+    Indicator g_statusId[5] = {kNone, kNone, kNone, kNone, kNone};   // filled in begin()
+
+    std::atomic<uint32_t> g_active{0};   // bit per pattern index
+
+    // Below: esp_timer task only (both timers dispatch there, so no locking).
+    esp_timer_handle_t g_stepTimer = nullptr;
+    esp_timer_handle_t g_evalTimer = nullptr;
+    int8_t   g_current = -1;
+    uint8_t  g_stepIndex = 0;
+    Status   g_currentStatus = Status::Unknown;
+    uint32_t g_ledBits = 0;              // all LED pins
+    bool     g_initialized = false;
+
+    bool validPin(uint8_t pin, const char* name) {
+        if (digitalPinIsValid(pin)) return true;
+        LOGE("StatusLED", "Invalid %s GPIO %u", name, pin);
+        return false;
     }
 
-    bool ensureInputPin(uint8_t pin, int mode, const char* name) {
-        if (!digitalPinIsValid(pin)) {
-            Serial.printf("[StatusLED] Invalid %s GPIO %u\n", name, pin);
-            return false;
+    void applyMask(uint8_t mask) {
+        uint32_t on = 0;
+        for (uint8_t i = 0; i < sizeof(LED_PINS); ++i) {
+            if (mask & (1u << i)) on |= 1u << LED_PINS[i];
         }
-        pinMode(pin, mode);
-        return true;
+        REG_WRITE(GPIO_OUT_W1TS_REG, on);
+        REG_WRITE(GPIO_OUT_W1TC_REG, g_ledBits & ~on);
     }
 
-    void applyMask(uint8_t mask) {
-        digitalWrite(RED_PIN,    (mask & MASK_RED)    ? HIGH : LOW);
-        digitalWrite(YELLOW_PIN, (mask & MASK_YELLOW) ? HIGH : LOW);
-        digitalWrite(GREEN_PIN,  (mask & MASK_GREEN)  ? HIGH : LOW);
-        digitalWrite(BLUE_PIN,   (mask & MASK_BLUE)   ? HIGH : LOW);
+    void showStep() {
+        const Pattern& p = g_patterns[g_current];
+        const Step& s = p.steps[g_stepIndex];
+        applyMask(s.mask);
+        if (s.durationMs && p.length > 1) esp_timer_start_once(g_stepTimer, (uint64_t)s.durationMs * 1000);
     }
 
-    void setPattern(const Step* pattern, size_t length) {
-        g_pattern = pattern;
-        g_patternLength = length;
-        g_stepIndex = 0;
-        g_stepStart = millis();
-        g_stepApplied = false;
-        if (g_pattern && g_patternLength) {
-            applyMask(g_pattern[0].mask);
-            g_stepApplied = true;
-        } else {
-            applyMask(0);
-        }
+    void onStep(void*) {
+        if (g_current < 0) return;
+        g_stepIndex = (g_stepIndex + 1) % g_patterns[g_current].length;
+        showStep();
     }
 
     bool isChargingActive() {
@@ -126,113 +121,160 @@ namespace StatusLED {
     Status determineStatus() {
         float vbat = Power::vbat();
         if (vbat <= VBAT_LOW_THRESHOLD) {
-        return Status::Low;
+            return Status::Low;
         }
-
-        bool charging = isChargingActive();
-        if (charging) {
-        return Status::Charging;
+        if (isChargingActive()) {
+            return Status::Charging;
         }
-
         bool goodSignal = isGoodSignalActive();
         if (goodSignal && vbat >= VBAT_CHARGED_THRESHOLD) {
-        return Status::Charged;
+            return Status::Charged;
         }
-
         if (vbat >= VBAT_GOOD_THRESHOLD) {
-        return Status::BatteryGood;
+            return Status::BatteryGood;
         }
-
         if (goodSignal) {
-        return Status::Charged;
+            return Status::Charged;
         }
-
         return Status::BatteryGood;
     }
 
-    void ensurePatternFor(Status status) {
-        if (status == g_currentStatus) {
-        return;
-        }
-
+    void updateBatteryIndicator() {
+        const Status status = determineStatus();
+        if (status == g_currentStatus) return;
+        set(g_statusId[(int)g_currentStatus], false);
+        set(g_statusId[(int)status], true);
         g_currentStatus = status;
-        switch (status) {
-        case Status::Low:
-            setPattern(PATTERN_LOW, sizeof(PATTERN_LOW) / sizeof(PATTERN_LOW[0]));
-            break;
-        case Status::Charging:
-            setPattern(PATTERN_CHARGING, sizeof(PATTERN_CHARGING) / sizeof(PATTERN_CHARGING[0]));
-            break;
-        case Status::Charged:
-            setPattern(PATTERN_CHARGED, sizeof(PATTERN_CHARGED) / sizeof(PATTERN_CHARGED[0]));
-            break;
-        case Status::BatteryGood:
-            setPattern(PATTERN_GOOD, sizeof(PATTERN_GOOD) / sizeof(PATTERN_GOOD[0]));
-            break;
-        case Status::Unknown:
-        default:
-            setPattern(nullptr, 0);
-            break;
-        }
     }
 
-    void updatePattern() {
-        if (!g_pattern || g_patternLength == 0) {
-        return;
+    int8_t pickPattern() {
+        const uint32_t active = g_active.load(std::memory_order_relaxed);
+        int8_t best = -1;
+        for (uint8_t i = 0; i < g_count.load(std::memory_order_relaxed); ++i) {
+            if (!(active & (1u << i))) continue;
+            if (best < 0 || g_patterns[i].priority > g_patterns[best].priority) best = i;
         }
+        return best;
+    }
 
-        const Step& step = g_pattern[g_stepIndex];
-        if (!g_stepApplied) {
-        applyMask(step.mask);
-        g_stepApplied = true;
-        }
+    void onEval(void*) {
+        updateBatteryIndicator();
+        const int8_t next = pickPattern();
+        if (next == g_current) return;
+        esp_timer_stop(g_stepTimer);
+        g_current = next;
+        g_stepIndex = 0;
+        if (next < 0) applyMask(0);
+        else          showStep();
+    }
 
-        if (step.durationMs == 0) {
-        return;
+    uint8_t parseMask(JsonVariantConst v) {
+        if (v.is<uint8_t>()) return v.as<uint8_t>() & 0x0F;
+        uint8_t mask = 0;
+        for (const char* c = v | ""; *c; ++c) {
+            switch (*c) {
+            case 'R': mask |= MASK_RED;    break;
+            case 'Y': mask |= MASK_YELLOW; break;
+            case 'G': mask |= MASK_GREEN;  break;
+            case 'B': mask |= MASK_BLUE;   break;
+            }
         }
+        return mask;
+    }
 
-        uint32_t now = millis();
-        if (now - g_stepStart >= step.durationMs) {
-        g_stepIndex = (g_stepIndex + 1) % g_patternLength;
-        g_stepStart = now;
-        g_stepApplied = false;
+    // Override/add patterns from LittleFS. Same name replaces the built-in entry.
+    void loadPatterns() {
+        if (!LittleFS.exists(PATTERN_FILE)) return;
+        File f = LittleFS.open(PATTERN_FILE, "r");
+        DynamicJsonDocument doc(4096);
+        const DeserializationError err = deserializeJson(doc, f);
+        f.close();
+        if (err) {
+            LOGW("StatusLED", "%s: %s", PATTERN_FILE, err.c_str());
+            return;
+        }
+        uint8_t loaded = 0;
+        for (JsonObjectConst o : doc["patterns"].as<JsonArrayConst>()) {
+            const char* name = o["name"] | "";
+            JsonArrayConst steps = o["steps"];
+            if (!*name || strlen(name) > PATTERN_NAME_MAX || steps.size() == 0 || steps.size() > MAX_STEPS) {
+                LOGW("StatusLED", "skip pattern '%s' (name <= %u chars, 1..%u steps)", name, PATTERN_NAME_MAX, MAX_STEPS);
+                continue;
+            }
+            Indicator id = find(name);
+            if (id == kNone) {
+                if (g_count >= MAX_PATTERNS) { LOGW("StatusLED", "pattern table full"); break; }
+                id = g_count;
+            }
+            Pattern p{};
+            strlcpy(p.name, name, sizeof(p.name));
+            p.priority = o["prio"] | g_patterns[id].priority;
+            p.length = steps.size();
+            for (uint8_t i = 0; i < p.length; ++i) {
+                p.steps[i] = {steps[i][0] | 0u, parseMask(steps[i][1])};
+            }
+            g_patterns[id] = p;
+            if (id == g_count) g_count++;   // publish after the entry is complete
+            loaded++;
         }
+        LOGI("StatusLED", "%u pattern(s) from %s", loaded, PATTERN_FILE);
     }
     }
 
     bool begin() {
-    g_initialized = ensureOutputPin(RED_PIN) &&
-                    ensureOutputPin(YELLOW_PIN) &&
-                    ensureOutputPin(GREEN_PIN) &&
-                    ensureOutputPin(BLUE_PIN) &&
-                    ensureInputPin(CHG_STATE_PIN, INPUT_PULLUP, "charger state") &&
-                    ensureInputPin(BAT_GOOD_PIN, INPUT_PULLUP, "battery good");
-
-    if (!g_initialized) {
-        Serial.println("[StatusLED] Initialization skipped due to invalid GPIO configuration");
-        applyMask(0);
+    if (g_initialized) return true;
+    // Validate everything before touching any pin (the yellow pin may be shared on some boards).
+    const bool ok = validPin(RED_PIN, "LED") && validPin(YELLOW_PIN, "LED") &&
+                    validPin(GREEN_PIN, "LED") && validPin(BLUE_PIN, "LED") &&
+                    validPin(CHG_STATE_PIN, "charger state") && validPin(BAT_GOOD_PIN, "battery good");
+    if (!ok) {
+        LOGW("StatusLED", "Initialization skipped due to invalid GPIO configuration");
         return false;
     }
 
+    for (uint8_t pin : LED_PINS) {
+        pinMode(pin, OUTPUT);
+        g_ledBits |= 1u << pin;
+    }
+    pinMode(CHG_STATE_PIN, INPUT_PULLUP);
+    pinMode(BAT_GOOD_PIN, INPUT_PULLUP);
     applyMask(0);
-    g_currentStatus = Status::Unknown;
-    g_lastEval = millis();
-    Serial.println("[StatusLED] Initialized");
+
+    loadPatterns();
+    g_statusId[(int)Status::Low]         = find("low");
+    g_statusId[(int)Status::Charging]    = find("charging");
+    g_statusId[(int)Status::Charged]     = find("charged");
+    g_statusId[(int)Status::BatteryGood] = find("good");
+
+    const esp_timer_create_args_t stepArgs{onStep, nullptr, ESP_TIMER_TASK, "led_step", true};
+    const esp_timer_create_args_t evalArgs{onEval, nullptr, ESP_TIMER_TASK, "led_eval", true};
+    if (esp_timer_create(&stepArgs, &g_stepTimer) != ESP_OK ||
+        esp_timer_create(&evalArgs, &g_evalTimer) != ESP_OK) {
+        LOGE("StatusLED", "esp_timer create failed");
+        return false;
+    }
+    esp_timer_start_periodic(g_evalTimer, (uint64_t)STATUS_EVAL_INTERVAL_MS * 1000);
+    g_initialized = true;
+    LOGI("StatusLED", "Initialized (%u patterns)", g_count.load());
     return true;
     }
 
-    void update() {
-    if (!g_initialized) {
-        return;
+    Indicator find(const char* name) {
+    const uint8_t n = g_count.load(std::memory_order_acquire);
+    for (uint8_t i = 0; i < n; ++i) {
+        if (strcmp(g_patterns[i].name, name) == 0) return i;
     }
-    uint32_t now = millis();
-    if (now - g_lastEval >= STATUS_EVAL_INTERVAL_MS) {
-        Status status = determineStatus();
-        ensurePatternFor(status);
-        g_lastEval = now;
+    return kNone;
+    }
+
+    void set(Indicator id, bool on) {
+    if (id >= MAX_PATTERNS) return;
+    if (on) g_active.fetch_or(1u << id, std::memory_order_relaxed);
+    else    g_active.fetch_and(~(1u << id), std::memory_order_relaxed);
     }
 
-    updatePattern();
+    void set(const char* name, bool on) {
+    set(find(name), on);
     }
 
 } // namespace StatusLED
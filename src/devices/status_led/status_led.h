@@ -1,7 +1,31 @@
 #pragma once
 #include <Arduino.h>
 
+// Build option -DGYMBUDDY_STATUS_LED=1 (or change here). Off by default: the yellow LED
+// pin (GPIO4) is the laser EN pin on the current board.
+#ifndef GYMBUDDY_STATUS_LED
+#define GYMBUDDY_STATUS_LED 0
+#endif
+
+// Status LEDs driven by esp_timer, independent of loop().
+//  - Each pattern is a list of {durationMs, mask} steps; a one-shot timer applies the
+//    step's mask and arms itself for the next one, so nothing runs between transitions.
+//  - A mask change is one W1TS + one W1TC write (atomic set/clear, no read-modify-write).
+//  - Patterns are keyed by indicator name and ranked by priority: the highest-priority
+//    active indicator plays. Battery indicators (low/charging/charged/good) are evaluated
+//    internally; others are raised by their owners via set().
+//  - Built-in table in status_led.cpp; /leds.json on LittleFS can override or add patterns:
+//      {"patterns":[{"name":"wifi_lost","prio":60,"steps":[[150,"B"],[150,""],[150,"B"],[1550,""]]}]}
+//    mask letters: R Y G B (or a number). A single step with duration 0 is solid.
 namespace StatusLED {
+  using Indicator = uint8_t;
+  constexpr Indicator kNone = 0xFF;
+
+  // Call after LittleFS is mounted (for /leds.json). set() is a no-op on the LEDs until then.
   bool begin();
-  void update();
+
+  // Indicator id by name (kNone if there is no such pattern). Safe from any task.
+  Indicator find(const char* name);
+  void set(Indicator id, bool on);
+  void set(const char* name, bool on);
 }
@@ -0,0 +1,234 @@
+#include "EventLog.h"
+#include <esp_rom_crc.h>
+#include "src/util/log/Log.h"
+
+namespace {
+  constexpr uint32_t kHeadMagic  = 0x45564844; // "EVHD"
+  constexpr uint32_t kValidEpoch = 1600000000; // 이 값 이전이면 NTP 미동기화로 간주
+
+  struct HeadFile {
+    uint32_t magic;
+    uint32_t head;
+    uint32_t crc;
+  };
+}
+
+EventLog::EventLog(const Config& cfg) : cfg_(cfg) {
+  if (cfg_.segments < 2) cfg_.segments = 2;        // 덮어쓰기 중에도 한 세그먼트는 남도록
+  if (cfg_.recordsPerSeg == 0) cfg_.recordsPerSeg = 1;
+}
+
+uint32_t EventLog::crcOf_(const Record& r) {
+  return esp_rom_crc32_le(0, reinterpret_cast<const uint8_t*>(&r), offsetof(Record, crc));
+}
+
+void EventLog::segPath_(uint8_t seg, char* out, size_t cap) const {
+  snprintf(out, cap, "%s/seg%u.bin", cfg_.dir, seg);
+}
+
+// ---------- 부팅 시 복구 ----------
+
+bool EventLog::begin() {
+  if (!LittleFS.exists(cfg_.dir) && !LittleFS.mkdir(cfg_.dir)) {
+    LOGE("EVLOG", "mkdir %s failed", cfg_.dir);
+    return false;
+  }
+
+  // 각 세그먼트의 첫 레코드로 base seq 를, 끝에서부터 CRC 가 맞는 마지막 레코드로 끝 seq 를 얻음
+  bool     any = false;
+  uint32_t oldest = 0, newestEnd = 0;
+  char path[32];
+  for (uint8_t s = 0; s < cfg_.segments; ++s) {
+    segPath_(s, path, sizeof(path));
+    File f = LittleFS.open(path, "r");
+    if (!f) continue;
+
+    Record r;
+    const size_t n = f.size() / sizeof(Record);
+    if (n == 0 || f.read((uint8_t*)&r, sizeof(r)) != sizeof(r) || crcOf_(r) != r.crc) { f.close(); continue; }
+    const uint32_t base = r.seq;
+
+    uint32_t end = base + 1;
+    for (size_t i = n; i > 1; --i) {
+      f.seek((i - 1) * sizeof(Record));
+      if (f.read((uint8_t*)&r, sizeof(r)) == sizeof(r) && crcOf_(r) == r.crc && r.seq == base + i - 1) {
+        end = r.seq + 1;
+        break;
+      }
+    }
+    f.close();
+
+    if (!any || (int32_t)(base - oldest) < 0)    oldest = base;
+    if (!any || (int32_t)(end - newestEnd) > 0)  newestEnd = end;
+    any = true;
+  }
+
+  tail_ = any ? newestEnd : 0;
+  head_ = any ? oldest : 0;
+  loadHead_();
+  if ((int32_t)(head_ - tail_) > 0) head_ = tail_;
+  if (tail_ - head_ > capacity_()) head_ = tail_ - capacity_();
+  savedHead_  = head_;
+  lastSaveMs_ = millis();
+
+  // 쓰던 세그먼트 이어서 열기 (경계면 다음 append 에서 새로 염)
+  if (tail_ % cfg_.recordsPerSeg != 0 && !openWriteSeg_(tail_, false)) return false;
+
+  ready_ = true;
+  refreshOldest_();
+  LOGI("EVLOG", "head=%lu tail=%lu depth=%lu",
+       (unsigned long)head_, (unsigned long)tail_, (unsigned long)(tail_ - head_));
+  return true;
+}
+
+void EventLog::loadHead_() {
+  char path[32];
+  snprintf(path, sizeof(path), "%s/head", cfg_.dir);
+  File f = LittleFS.open(path, "r");
+  if (!f) return;
+  HeadFile h{};
+  const bool ok = f.read((uint8_t*)&h, sizeof(h)) == sizeof(h) && h.magic == kHeadMagic &&
+                  h.crc == esp_rom_crc32_le(0, (const uint8_t*)&h, offsetof(HeadFile, crc));
+  f.close();
+  // 저장된 head 가 세그먼트 최솟값보다 앞이면(덮어쓰기) 세그먼트 값 유지
+  if (ok && (int32_t)(h.head - head_) > 0) head_ = h.head;
+}
+
+void EventLog::saveHead_() {
+  char path[32];
+  snprintf(path, sizeof(path), "%s/head", cfg_.dir);
+  HeadFile h{ kHeadMagic, head_, 0 };
+  h.crc = esp_rom_crc32_le(0, (const uint8_t*)&h, offsetof(HeadFile, crc));
+  File f = LittleFS.open(path, "w");
+  if (!f) return;
+  f.write((const uint8_t*)&h, sizeof(h));
+  f.close();
+  savedHead_  = head_;
+  lastSaveMs_ = millis();
+}
+
+// ---------- 쓰기 ----------
+
+bool EventLog::openWriteSeg_(uint32_t seq, bool truncate) {
+  const uint8_t seg = segOf_(seq);
+  if (wr_) wr_.close();
+  if (rdSeg_ == seg) { rd_.close(); rdSeg_ = -1; }
+
+  char path[32];
+  segPath_(seg, path, sizeof(path));
+  // 새 세그먼트는 "w" 로 잘라서 시작, 이어 쓰기는 "r+" 로 열어 seek 후 덮어씀
+  // (끝에 반쯤 쓰다 만 레코드가 있어도 정렬이 깨지지 않음)
+  wr_ = LittleFS.open(path, truncate ? "w" : "r+");
+  if (!wr_ && !truncate) wr_ = LittleFS.open(path, "w");
+  if (!wr_) {
+    LOGE("EVLOG", "open %s failed", path);
+    wrSeg_ = -1;
+    return false;
+  }
+  wrSeg_ = seg;
+  return true;
+}
+
+bool EventLog::append(const void* data, size_t len, uint32_t ts) {
+  if (!ready_ || len > kPayloadMax) return false;
+
+  if (tail_ % cfg_.recordsPerSeg == 0) {
+    // 재사용할 세그먼트에 남은 미전송 레코드는 버림 (가장 오래된 것부터)
+    const uint32_t floor = tail_ + cfg_.recordsPerSeg - capacity_();
+    if (tail_ + cfg_.recordsPerSeg > capacity_() && (int32_t)(floor - head_) > 0) {
+      dropped_ += floor - head_;
+      head_ = floor;
+      saveHead_();
+      refreshOldest_();
+    }
+    if (!openWriteSeg_(tail_, true)) return false;
+  } else if (wrSeg_ != segOf_(tail_) && !openWriteSeg_(tail_, false)) {
+    return false;
+  }
+
+  Record r{};
+  r.seq = tail_;
+  r.ts  = ts;
+  r.len = (uint16_t)len;
+  memcpy(r.data, data, len);
+  r.crc = crcOf_(r);
+
+  wr_.seek((tail_ % cfg_.recordsPerSeg) * sizeof(Record));
+  if (wr_.write((const uint8_t*)&r, sizeof(r)) != sizeof(r)) return false;
+  wr_.flush();
+
+  if (head_ == tail_) oldestTs_ = ts;
+  tail_++;
+  appended_++;
+  return true;
+}
+
+// ---------- 읽기 / ack ----------
+
+bool EventLog::readRecord_(uint32_t seq, Record& r) {
+  const uint8_t seg = segOf_(seq);
+  File* f = nullptr;
+  if (seg == wrSeg_) {
+    f = &wr_;                        // 쓰는 중인 세그먼트는 같은 핸들로 읽음
+  } else {
+    if (rdSeg_ != seg) {
+      if (rd_) rd_.close();
+      char path[32];
+      segPath_(seg, path, sizeof(path));
+      rd_ = LittleFS.open(path, "r");
+      rdSeg_ = rd_ ? seg : -1;
+    }
+    if (!rd_) return false;
+    f = &rd_;
+  }
+  f->seek((seq % cfg_.recordsPerSeg) * sizeof(Record));
+  return f->read((uint8_t*)&r, sizeof(r)) == sizeof(r);
+}
+
+bool EventLog::read(uint32_t seq, uint8_t* out, size_t& len, uint32_t& ts) {
+  if (!ready_ || (int32_t)(seq - head_) < 0 || (int32_t)(seq - tail_) >= 0) return false;
+  Record r;
+  if (!readRecord_(seq, r) || r.seq != seq || r.crc != crcOf_(r) || r.len > kPayloadMax) {
+    corrupt_++;
+    return false;
+  }
+  memcpy(out, r.data, r.len);
+  len = r.len;
+  ts  = r.ts;
+  return true;
+}
+
+void EventLog::refreshOldest_() {
+  oldestTs_ = 0;
+  Record r;
+  if (head_ != tail_ && readRecord_(head_, r) && r.seq == head_) oldestTs_ = r.ts;
+}
+
+void EventLog::ackThrough(uint32_t seq) {
+  if ((int32_t)(seq - head_) < 0) return;
+  head_ = ((int32_t)(seq + 1 - tail_) > 0) ? tail_ : seq + 1;
+  refreshOldest_();
+
+  // head 저장은 모아서: N건마다, 일정 시간마다, 또는 비었을 때
+  if (head_ - savedHead_ >= cfg_.headSaveEvery ||
+      millis() - lastSaveMs_ >= cfg_.headSaveMs ||
+      head_ == tail_) {
+    saveHead_();
+  }
+}
+
+void EventLog::flush() {
+  if (ready_ && head_ != savedHead_) saveHead_();
+}
+
+EventLog::Stats EventLog::stats() const {
+  Stats s{};
+  s.depth        = tail_ - head_;
+  s.bytesPending = s.depth * sizeof(Record);
+  const uint32_t now = (uint32_t)time(nullptr);
+  s.oldestAgeS   = (s.depth && oldestTs_ >= kValidEpoch && now > oldestTs_) ? now - oldestTs_ : 0;
+  s.appended     = appended_;
+  s.dropped      = dropped_;
+  s.corrupt      = corrupt_;
+  return s;
+}
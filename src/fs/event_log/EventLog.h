@@ -0,0 +1,90 @@
+#pragma once
+#include <Arduino.h>
+#include <LittleFS.h>
+
+// LittleFS 위의 append-only 이벤트 로그 (store-and-forward)
+//  - 고정 크기 레코드(64B) + CRC32, 단조 증가 seq
+//  - seq → (세그먼트, 오프셋)이 계산으로 결정되므로 append 때 디렉터리 스캔/파일 재작성 없음
+//  - 세그먼트 파일을 라운드로빈으로 돌려 쓰기 (가득 차면 가장 오래된 세그먼트를 덮어씀)
+//  - head(ack 위치)는 별도 파일에 모아서 저장 → 크래시 후 최대 headSaveEvery 건 재전송(at-least-once)
+// 업링크 태스크 한 곳에서만 호출할 것 (stats() 제외)
+class EventLog {
+public:
+  static constexpr size_t kPayloadMax = 48;
+
+  struct Config {
+    const char* dir            = "/evlog";
+    uint8_t     segments       = 4;
+    uint16_t    recordsPerSeg  = 256;    // 256 * 64B = 16KB/세그먼트
+    uint16_t    headSaveEvery  = 16;     // ack N건마다 head 저장
+    uint32_t    headSaveMs     = 2000;   // 또는 마지막 저장 후 N ms
+  };
+
+  struct Stats {
+    uint32_t depth;          // 미전송 레코드 수
+    uint32_t bytesPending;   // depth * 레코드 크기
+    uint32_t oldestAgeS;     // 가장 오래된 미전송 이벤트 나이(초), 시각 미동기화 시 0
+    uint32_t appended;
+    uint32_t dropped;        // 용량 초과로 덮어쓴 레코드
+    uint32_t corrupt;        // CRC 불일치로 건너뛴 레코드
+  };
+
+  explicit EventLog(const Config& cfg = Config{});
+
+  // LittleFS 마운트 이후 호출. 기존 세그먼트를 한 번 훑어 head/tail 복구.
+  bool begin();
+
+  bool append(const void* data, size_t len, uint32_t ts);
+
+  // seq 레코드 읽기. 범위 밖/CRC 불일치면 false
+  bool read(uint32_t seq, uint8_t* out, size_t& len, uint32_t& ts);
+
+  // seq 까지 전송 완료 → head = seq + 1
+  void ackThrough(uint32_t seq);
+
+  void flush();                      // head 강제 저장
+
+  uint32_t head() const { return head_; }
+  uint32_t tail() const { return tail_; }
+  bool     empty() const { return head_ == tail_; }
+  Stats    stats() const;
+
+private:
+  struct Record {
+    uint32_t seq;
+    uint32_t ts;
+    uint16_t len;
+    uint16_t rsv;
+    uint8_t  data[kPayloadMax];
+    uint32_t crc;                    // seq..data
+  };
+  static_assert(sizeof(Record) == 64, "EventLog record must stay 64 bytes");
+
+  static uint32_t crcOf_(const Record& r);
+  uint32_t capacity_() const { return (uint32_t)cfg_.segments * cfg_.recordsPerSeg; }
+  uint8_t  segOf_(uint32_t seq) const { return (seq / cfg_.recordsPerSeg) % cfg_.segments; }
+  void     segPath_(uint8_t seg, char* out, size_t cap) const;
+
+  bool readRecord_(uint32_t seq, Record& r);
+  bool openWriteSeg_(uint32_t seq, bool truncate);
+  void loadHead_();
+  void saveHead_();
+  void refreshOldest_();
+
+  Config   cfg_;
+  uint32_t head_ = 0;
+  uint32_t tail_ = 0;
+  uint32_t savedHead_ = 0;
+  uint32_t lastSaveMs_ = 0;
+  uint32_t oldestTs_ = 0;
+
+  File     wr_;
+  int16_t  wrSeg_ = -1;
+  File     rd_;
+  int16_t  rdSeg_ = -1;
+
+  uint32_t appended_ = 0;
+  uint32_t dropped_  = 0;
+  uint32_t corrupt_  = 0;
+  bool     ready_ = false;
+};
@@ -0,0 +1,327 @@
+#include "http_ota.h"
+#include <Update.h>
+#include <algorithm>
+#include <esp_heap_caps.h>
+#include <esp_rom_crc.h>
+#include <mbedtls/sha256.h>
+#include <rom/miniz.h>
+#include "src/devices/status_led/status_led.h"
+#include "src/util/log/Log.h"
+
+using namespace HttpOta;
+
+namespace {
+  constexpr size_t kDict = TINFL_LZ_DICT_SIZE;    // 32KB, tinfl 출력 링 = deflate 사전
+  static_assert((kDict & (kDict - 1)) == 0, "tinfl dict must be power of two");
+
+  // gzip 헤더(RFC 1952)는 바이트 단위로 파싱 → 조각 경계가 어디든 상관없음
+  enum class Stage : uint8_t { Magic, Header, ExtraLen, Extra, Name, Comment, HeaderCrc, Deflate, Trailer, Raw };
+  enum : uint8_t { FHCRC = 0x02, FEXTRA = 0x04, FNAME = 0x08, FCOMMENT = 0x10 };
+
+  struct Session {
+    bool     active = false;
+    bool     failed = false;
+    Target   target = Target::Firmware;
+    Stage    stage  = Stage::Magic;
+    bool     verify = false;
+    uint8_t  expect[32] = {};
+    uint32_t size = 0, received = 0, written = 0;
+    uint32_t t0Ms = 0, flashUs = 0;
+    char     error[48] = {};
+
+    // gzip 헤더 상태
+    uint8_t  hdr[10] = {};
+    uint8_t  hdrLen  = 0;
+    uint8_t  flags   = 0;
+    uint16_t skip    = 0;
+
+    // gzip 트레일러 확인: 풀린 바이트 CRC32 + 압축 스트림 마지막 8바이트(CRC32, ISIZE)
+    //  tinfl 이 스트림 끝 너머를 미리 읽을 수 있으므로 트레일러는 "마지막 8바이트" 로 잡음
+    uint32_t crc     = 0;
+    uint8_t  tail[8] = {};
+    uint8_t  tailLen = 0;
+
+    tinfl_decompressor*  inf  = nullptr;
+    uint8_t*             dict = nullptr;
+    size_t               dictOfs = 0;
+    mbedtls_sha256_context sha;
+  };
+
+  Session g_s;
+
+  bool parseHex_(const char* hex, uint8_t out[32]) {
+    if (!hex || strlen(hex) != 64) return false;
+    for (int i = 0; i < 32; ++i) {
+      uint8_t b = 0;
+      for (int k = 0; k < 2; ++k) {
+        const char c = hex[i * 2 + k];
+        b <<= 4;
+        if (c >= '0' && c <= '9')      b |= c - '0';
+        else if (c >= 'a' && c <= 'f') b |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') b |= c - 'A' + 10;
+        else return false;
+      }
+      out[i] = b;
+    }
+    return true;
+  }
+
+  void fail_(const char* why, bool updateErr = false) {
+    if (g_s.failed) return;
+    g_s.failed = true;
+    strlcpy(g_s.error, why, sizeof(g_s.error));
+    if (updateErr) LOGE("OTA", "%s @%lu: %s", why, (unsigned long)g_s.received, Update.errorString());
+    else           LOGE("OTA", "%s @%lu", why, (unsigned long)g_s.received);
+  }
+
+  void release_() {
+    heap_caps_free(g_s.inf);
+    heap_caps_free(g_s.dict);
+    g_s.inf  = nullptr;
+    g_s.dict = nullptr;
+    mbedtls_sha256_free(&g_s.sha);
+    g_s.active = false;
+    StatusLED::set("ota", false);
+  }
+
+  // 풀린 바이트 → 파티션 + 해시
+  bool emit_(const uint8_t* p, size_t n) {
+    if (!n) return true;
+    const uint32_t t = micros();
+    const size_t w = Update.write(const_cast<uint8_t*>(p), n);
+    g_s.flashUs += micros() - t;
+    if (w != n) { fail_("flash write", true); return false; }
+    if (g_s.verify) mbedtls_sha256_update(&g_s.sha, p, n);
+    if (g_s.stage != Stage::Raw) g_s.crc = esp_rom_crc32_le(g_s.crc, p, n);
+    g_s.written += n;
+    return true;
+  }
+
+  // 헤더 뒤 압축 바이트 중 마지막 8개 유지
+  void keepTail_(const uint8_t* p, size_t n) {
+    if (n >= sizeof(g_s.tail)) {
+      memcpy(g_s.tail, p + n - sizeof(g_s.tail), sizeof(g_s.tail));
+    } else {
+      memmove(g_s.tail, g_s.tail + n, sizeof(g_s.tail) - n);
+      memcpy(g_s.tail + sizeof(g_s.tail) - n, p, n);
+    }
+    g_s.tailLen = (uint8_t)std::min<size_t>(sizeof(g_s.tail), g_s.tailLen + n);
+  }
+
+  uint32_t le32_(const uint8_t* p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+  }
+
+  bool inflate_(const uint8_t* in, size_t len) {
+    while (len) {
+      size_t inBytes  = len;
+      size_t outBytes = kDict - g_s.dictOfs;
+      const tinfl_status st = tinfl_decompress(g_s.inf, in, &inBytes, g_s.dict, g_s.dict + g_s.dictOfs,
+                                               &outBytes, TINFL_FLAG_HAS_MORE_INPUT);
+      in  += inBytes;
+      len -= inBytes;
+      if (!emit_(g_s.dict + g_s.dictOfs, outBytes)) return false;
+      g_s.dictOfs = (g_s.dictOfs + outBytes) & (kDict - 1);
+
+      if (st < TINFL_STATUS_DONE) { fail_("bad deflate stream"); return false; }
+      if (st == TINFL_STATUS_DONE) { g_s.stage = Stage::Trailer; return true; }  // 나머지는 CRC32+ISIZE
+      if (st == TINFL_STATUS_NEEDS_MORE_INPUT && !len) break;
+      // HAS_MORE_OUTPUT: 링 끝까지 찼음 → 처음부터 다시
+    }
+    return true;
+  }
+
+  // gzip 헤더를 바이트 단위로 소비. 반환: 소비한 바이트 (Deflate/Raw 로 넘어가면 멈춤)
+  size_t header_(const uint8_t* p, size_t len) {
+    size_t i = 0;
+    while (i < len) {
+      const uint8_t b = p[i];
+      switch (g_s.stage) {
+        case Stage::Magic:
+        case Stage::Header:
+          g_s.hdr[g_s.hdrLen++] = b; ++i;
+          if (g_s.hdrLen == 2) {
+            if (g_s.hdr[0] != 0x1f || g_s.hdr[1] != 0x8b) {
+              // 평문 이미지: 잡아 둔 2바이트부터 그대로 기록
+              g_s.stage = Stage::Raw;
+              return emit_(g_s.hdr, 2) ? i : len;
+            }
+            g_s.stage = Stage::Header;
+          }
+          if (g_s.hdrLen == 10) {
+            if (g_s.hdr[2] != 8) { fail_("gzip: not deflate"); return len; }
+            g_s.flags = g_s.hdr[3];
+            g_s.skip  = 0;
+            g_s.stage = (g_s.flags & FEXTRA) ? Stage::ExtraLen : Stage::Extra;
+            if (g_s.stage == Stage::ExtraLen) g_s.hdrLen = 0;
+          }
+          break;
+
+        case Stage::ExtraLen:   // XLEN (LE 2바이트)
+          g_s.skip |= (uint16_t)b << (8 * g_s.hdrLen++); ++i;
+          if (g_s.hdrLen == 2) g_s.stage = Stage::Extra;
+          break;
+
+        case Stage::Extra:
+          if (g_s.skip) { const size_t n = g_s.skip < len - i ? g_s.skip : len - i; g_s.skip -= n; i += n; break; }
+          g_s.stage = (g_s.flags & FNAME) ? Stage::Name : Stage::Comment;
+          break;
+
+        case Stage::Name:
+          ++i;
+          if (b == 0) g_s.stage = Stage::Comment;
+          break;
+
+        case Stage::Comment:
+          if (!(g_s.flags & FCOMMENT)) { g_s.stage = Stage::HeaderCrc; g_s.skip = (g_s.flags & FHCRC) ? 2 : 0; break; }
+          ++i;
+          if (b == 0) g_s.flags &= ~FCOMMENT;
+          break;
+
+        case Stage::HeaderCrc:
+          if (g_s.skip) { g_s.skip--; ++i; break; }
+          g_s.stage = Stage::Deflate;
+          return i;
+
+        default:
+          return i;
+      }
+    }
+    return i;   // 헤더가 조각 경계에 걸림 → 다음 조각에서 이어서
+  }
+}
+
+bool HttpOta::begin(Target t, uint32_t size, uint32_t rawSize, const char* sha256Hex,
+                    bool& resumed, String& err) {
+  resumed = false;
+  uint8_t expect[32];
+  const bool verify = sha256Hex && *sha256Hex;
+  if (verify && !parseHex_(sha256Hex, expect)) { err = "bad sha256"; return false; }
+
+  if (g_s.active) {
+    if (!g_s.failed && verify && g_s.verify && g_s.target == t && g_s.size == size &&
+        memcmp(g_s.expect, expect, sizeof(expect)) == 0) {
+      resumed = true;
+      LOGI("OTA", "resume @%lu/%lu", (unsigned long)g_s.received, (unsigned long)size);
+      return true;
+    }
+    // 다른 이미지(또는 실패한 세션) → 버리고 새로 시작
+    abort("replaced by new upload");
+  }
+
+  g_s = Session{};
+  g_s.target = t;
+  g_s.size   = size;
+  g_s.verify = verify;
+  if (verify) memcpy(g_s.expect, expect, sizeof(expect));
+
+  // 사전 링은 PSRAM 우선 (Update 는 자기 4KB 버퍼로 복사해서 씀)
+  g_s.inf  = (tinfl_decompressor*)heap_caps_malloc(sizeof(tinfl_decompressor), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  g_s.dict = (uint8_t*)heap_caps_malloc(kDict, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!g_s.dict) g_s.dict = (uint8_t*)heap_caps_malloc(kDict, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  mbedtls_sha256_init(&g_s.sha);
+  if (!g_s.inf || !g_s.dict) { release_(); err = "out of memory"; return false; }
+  tinfl_init(g_s.inf);
+  mbedtls_sha256_starts(&g_s.sha, 0);
+
+  const int cmd = (t == Target::Firmware) ? U_FLASH : U_SPIFFS;
+  if (!Update.begin(rawSize ? rawSize : UPDATE_SIZE_UNKNOWN, cmd)) {
+    err = Update.errorString();
+    release_();
+    return false;
+  }
+  g_s.active = true;
+  g_s.t0Ms   = millis();
+  StatusLED::set("ota", true);
+  LOGI("OTA", "%s begin: %lu B%s", t == Target::Firmware ? "FW" : "FS", (unsigned long)size,
+       verify ? ", sha256" : ", unverified");
+  return true;
+}
+
+bool HttpOta::write(uint32_t pos, const uint8_t* data, size_t len) {
+  if (!g_s.active || g_s.failed) return false;
+  if (pos > g_s.received) return false;                       // 빈틈 → 호출 쪽이 409
+  const uint32_t dup = g_s.received - pos;                     // 이미 받은 부분은 건너뜀
+  if (dup >= len) return true;
+  data += dup;
+  len  -= dup;
+  if (g_s.size && g_s.received + len > g_s.size) { fail_("more data than announced"); return false; }
+
+  size_t used = 0;
+  while (used < len && !g_s.failed) {
+    switch (g_s.stage) {
+      case Stage::Raw:
+        emit_(data + used, len - used);
+        used = len;
+        break;
+      case Stage::Deflate:
+        // DONE 이후 남은 입력은 트레일러 → 마지막 8바이트만 남겨 finish 에서 확인
+        keepTail_(data + used, len - used);
+        inflate_(data + used, len - used);
+        used = len;
+        break;
+      case Stage::Trailer:
+        keepTail_(data + used, len - used);
+        used = len;
+        break;
+      default:
+        used += header_(data + used, len - used);
+        break;
+    }
+  }
+  g_s.received += len;
+  return !g_s.failed;
+}
+
+Result HttpOta::finish() {
+  Result r{};
+  r.received  = g_s.received;
+  r.written   = g_s.written;
+  r.elapsedMs = millis() - g_s.t0Ms;
+  r.flashMs   = g_s.flashUs / 1000;
+  if (!g_s.active) { strlcpy(r.error, "no session", sizeof(r.error)); return r; }
+
+  if (!g_s.failed && g_s.size && g_s.received != g_s.size) fail_("incomplete upload");
+  if (!g_s.failed && g_s.stage != Stage::Raw && g_s.stage != Stage::Trailer) fail_("truncated gzip stream");
+  if (!g_s.failed && g_s.stage == Stage::Trailer) {
+    if (g_s.tailLen < sizeof(g_s.tail) || le32_(g_s.tail) != g_s.crc) fail_("gzip crc32 mismatch");
+    else if (le32_(g_s.tail + 4) != g_s.written)                      fail_("gzip size mismatch");
+  }
+  if (!g_s.failed && g_s.verify) {
+    uint8_t got[32];
+    mbedtls_sha256_finish(&g_s.sha, got);
+    if (memcmp(got, g_s.expect, sizeof(got)) != 0) fail_("sha256 mismatch");
+  }
+  if (!g_s.failed && !Update.end(true)) fail_("finalize", true);
+
+  if (g_s.failed) {
+    Update.abort();
+    strlcpy(r.error, g_s.error, sizeof(r.error));
+  } else {
+    r.ok = true;
+    const uint32_t kbps = r.flashMs ? r.written / r.flashMs : 0;    // B/ms = KB/s(1000)
+    LOGI("OTA", "%s done: %lu B -> %lu B in %lu ms (flash %lu ms, %lu KB/s)%s",
+         g_s.target == Target::Firmware ? "FW" : "FS",
+         (unsigned long)r.received, (unsigned long)r.written, (unsigned long)r.elapsedMs,
+         (unsigned long)r.flashMs, (unsigned long)kbps, g_s.verify ? ", sha256 ok" : "");
+  }
+  release_();
+  return r;
+}
+
+void HttpOta::abort(const char* why) {
+  if (!g_s.active) return;
+  LOGW("OTA", "abort @%lu: %s", (unsigned long)g_s.received, why);
+  Update.abort();
+  release_();
+}
+
+Status HttpOta::status() {
+  return Status{
+    g_s.active, g_s.target,
+    g_s.stage != Stage::Raw && g_s.stage != Stage::Magic,
+    g_s.verify, g_s.size, g_s.received, g_s.written,
+    g_s.active ? millis() - g_s.t0Ms : 0, g_s.flashUs / 1000,
+    g_s.failed ? g_s.error : nullptr
+  };
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <Arduino.h>
+
+// HTTP 이미지 OTA 세션 (펌웨어 / LittleFS) — web.cpp registerHttpOta 의 엔진
+//  - 본문이 gzip(1f 8b)이면 ROM tinfl 로 풀면서 바로 파티션에 기록 (32KB 사전 링)
+//      .bin 평문도 그대로 받음 → 업로드 크기/시간은 대략 절반 (gzip -9 기준)
+//  - begin 때 받은 sha256(풀린 이미지) 를 finish 에서 비교, 다르면 Update.abort()
+//  - gzip 은 sha256 유무와 관계없이 트레일러 CRC32/ISIZE 도 확인 (sha256 없는 /update 업로드 대비)
+//  - 이어받기: 압축 바이트 오프셋 기준. 끊기면 status().received 부터 다시 보내면 됨
+//      세션은 RAM 에만 → 같은 부팅 안에서만 이어받기 가능
+//  - 호출은 모두 async_tcp 태스크(웹 핸들러)에서 → 내부 락 없음
+namespace HttpOta {
+  enum class Target : uint8_t { Firmware, Filesystem };
+
+  struct Status {
+    bool        active;
+    Target      target;
+    bool        gzip;          // 첫 2바이트를 본 뒤에 확정
+    bool        verify;        // sha256 을 받았는지
+    uint32_t    size;          // 업로드(압축) 전체 크기, 0 = 모름 (멀티파트)
+    uint32_t    received;      // 받은(압축) 바이트 = 다음 오프셋
+    uint32_t    written;       // 파티션에 기록한 (풀린) 바이트
+    uint32_t    elapsedMs;     // begin 이후
+    uint32_t    flashMs;       // Update.write 누적
+    const char* error;         // nullptr = 정상
+  };
+
+  struct Result {
+    bool     ok;
+    uint32_t received;
+    uint32_t written;
+    uint32_t elapsedMs;
+    uint32_t flashMs;
+    char     error[48];
+  };
+
+  // sha256Hex: 풀린 이미지의 SHA-256 (64자리 hex), nullptr 이면 검증 없음
+  // rawSize  : 풀린 이미지 크기(알면 파티션 크기 검사), 0 = 모름
+  // 같은 대상 + 같은 sha256 세션이 진행 중이면 그대로 이어감 (resumed = true)
+  bool begin(Target t, uint32_t size, uint32_t rawSize, const char* sha256Hex,
+             bool& resumed, String& err);
+
+  // pos: 이 조각 첫 바이트의 오프셋. received 보다 앞이면 겹친 부분은 건너뜀,
+  // 뒤면(빈틈) false. 오류가 나면 세션은 실패 상태로 남고 abort/begin 으로 정리
+  bool write(uint32_t pos, const uint8_t* data, size_t len);
+
+  // 스트림 끝 확인 + 해시 비교 + Update.end. 성공/실패 모두 세션 종료
+  Result finish();
+  void   abort(const char* why);
+
+  Status status();
+}
@@ -2,18 +2,19 @@
 #include "src/config/config.h"
 #include <ArduinoOTA.h>
 #include <WiFi.h>
+#include "src/util/log/Log.h"
 
 void OTAUpdater::begin() {
   if (WiFi.status() != WL_CONNECTED) return; // STA연결 시에만 사용
   ArduinoOTA
-    .onStart([](){ Serial.println("[OTA] Start"); })
-    .onEnd([](){ Serial.println("\n[OTA] End"); })
+    .onStart([](){ LOGI("OTA", "Start"); })
+    .onEnd([](){ LOGI("OTA", "End"); Log::flush(); })
     .onProgress([](unsigned int p, unsigned int t){
-      Serial.printf("[OTA] %u%%\r", (p / (t / 100)));
+      LOGD("OTA", "%u%%", (p / (t / 100)));
     })
-    .onError([](ota_error_t e){ Serial.printf("[OTA] Error %u\n", e); });
+    .onError([](ota_error_t e){ LOGE("OTA", "Error %u", e); });
   ArduinoOTA.begin();
-  Serial.println("[OTA] ready");
+  LOGI("OTA", "ready");
 }
 
 void OTAUpdater::handle() {
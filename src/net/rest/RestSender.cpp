@@ -1,9 +1,64 @@
 #include "RestSender.h"
-#include <WiFiClient.h>
-#include <HTTPClient.h>
+#include <WiFi.h>
+#include "src/fs/event_log/EventLog.h"
+#include "src/util/log/Log.h"
+#include "src/util/metrics/Metrics.h"
+#include "src/util/tracer/Tracer.h"
+
+namespace {
+  constexpr uint32_t kSyncTag       = 0xFFFFFFFFu; // post_plain_http 전용 태그
+  constexpr uint32_t kBackoffMinMs  = 1000;
+  constexpr uint32_t kBackoffMaxMs  = 30000;
+
+  struct Lock {
+    SemaphoreHandle_t m;
+    explicit Lock(SemaphoreHandle_t h) : m(h) { xSemaphoreTake(m, portMAX_DELAY); }
+    ~Lock() { xSemaphoreGive(m); }
+  };
+
+  Metrics::Histogram g_postMs("gymbuddy_rest_post_seconds", "REST POST latency from submit to final result",
+                              Metrics::kLatencyMs, 9, 1e-3f);
+  Metrics::Counter g_resp2xx("gymbuddy_rest_responses_total", "REST POST results by status class", "code=\"2xx\"");
+  Metrics::Counter g_resp4xx("gymbuddy_rest_responses_total", "REST POST results by status class", "code=\"4xx\"");
+  Metrics::Counter g_resp5xx("gymbuddy_rest_responses_total", "REST POST results by status class", "code=\"5xx\"");
+  Metrics::Counter g_respOther("gymbuddy_rest_responses_total", "REST POST results by status class", "code=\"other\"");
+  Metrics::Counter g_respErr("gymbuddy_rest_responses_total", "REST POST results by status class", "code=\"error\"");
+  Metrics::Counter g_retries("gymbuddy_rest_retries_total", "REST POST resend attempts");
+  Metrics::Counter g_logDropped("gymbuddy_rest_log_dropped_total", "Event log POSTs dropped after a permanent 4xx");
+
+  // 408/429 외 4xx 는 다시 보내도 같은 응답 → 재시도 대상 아님
+  bool permanentReject_(int status) {
+    return status >= 400 && status < 500 && status != 408 && status != 429;
+  }
+
+  void countStatus_(int status) {
+    if (status <= 0)                        g_respErr.inc();    // 연결/타임아웃/재시도 소진
+    else if (status >= 200 && status < 300) g_resp2xx.inc();
+    else if (status >= 400 && status < 500) g_resp4xx.inc();
+    else if (status >= 500 && status < 600) g_resp5xx.inc();
+    else                                    g_respOther.inc();
+  }
+}
 
 RestSender::RestSender(const Config& cfg) : cfg_(cfg) {
   if (cfg_.basePath == nullptr || cfg_.basePath[0] == '\0') cfg_.basePath = "/";
+  if (cfg_.queueLen == 0) cfg_.queueLen = 1;
+  if (cfg_.maxInFlight == 0) cfg_.maxInFlight = 1;
+
+  // 슬롯/본문 버퍼는 한 번만 할당하고 재사용
+  slots_    = new Slot[cfg_.queueLen];
+  bodyPool_ = new char[(size_t)cfg_.queueLen * cfg_.maxBodyBytes];
+  for (uint8_t i = 0; i < cfg_.queueLen; ++i) slots_[i].body = bodyPool_ + (size_t)i * cfg_.maxBodyBytes;
+  lock_ = xSemaphoreCreateMutex();
+  resetParser_();
+}
+
+RestSender::~RestSender() {
+  closeConnection_();
+  delete[] slots_;
+  delete[] bodyPool_;
+  delete[] encBuf_;
+  if (lock_) vSemaphoreDelete(lock_);
 }
 
 void RestSender::setAuthBearer(const String& token) { bearer_ = token; }
@@ -24,20 +79,495 @@ String RestSender::buildUrl_(const String& path) const {
   return url;
 }
 
+// ---------- 큐 ----------
 
-bool RestSender::post_plain_http(const String& json) {
-  WiFiClient net;           // ★ 평문용
-  HTTPClient http;
+bool RestSender::submit(const char* body, size_t len, uint32_t tag) {
+  return enqueue_(body, len, tag, false);
+}
+
+bool RestSender::enqueue_(const char* body, size_t len, uint32_t tag, bool fromLog) {
+  if (len > cfg_.maxBodyBytes) { stats_.rejected++; return false; }
+  Lock l(lock_);
+  if (tail_ - head_ >= cfg_.queueLen) { stats_.rejected++; return false; }
+  Slot& s = at_(tail_);
+  memcpy(s.body, body, len);
+  s.len      = (uint16_t)len;
+  s.tag      = tag;
+  s.submitMs = millis();
+  s.sentMs   = 0;
+  s.attempts = 0;
+  s.fromLog  = fromLog;
+  tail_++;
+  stats_.submitted++;
+  return true;
+}
+
+size_t RestSender::pending() const {
+  Lock l(lock_);
+  return tail_ - head_;
+}
+
+size_t RestSender::backlog() const {
+  size_t n;
+  {
+    Lock l(lock_);
+    n = tail_ - send_;
+  }
+  return n + logUnsent_.load(std::memory_order_relaxed);
+}
+
+// ---------- 연결 ----------
+
+bool RestSender::ensureConnected_() {
+  if (client_.connected()) return true;
+  if (connectedAt_) closeConnection_();  // 서버 쪽에서 끊긴 소켓 정리
+
+  const uint32_t now = millis();
+  if (WiFi.status() != WL_CONNECTED) return false;
+  if ((int32_t)(now - nextConnectMs_) < 0) return false;
+
+  // connect 는 timeoutMs 까지 블로킹 — 업링크 태스크에서만 호출되므로 샘플링에는 영향 없음
+  if (!client_.connect(cfg_.host, cfg_.port, cfg_.timeoutMs)) {
+    backoffMs_ = backoffMs_ ? min(backoffMs_ * 2, kBackoffMaxMs) : kBackoffMinMs;
+    nextConnectMs_ = millis() + backoffMs_;
+    LOGW("RestSender", "connect %s:%u failed, retry in %lums",
+         cfg_.host, cfg_.port, (unsigned long)backoffMs_);
+
+    // 연결 실패도 대기 중 맨 앞 요청의 시도 횟수로 계산
+    bool drop = false;
+    {
+      Lock l(lock_);
+      if (send_ == head_ && tail_ != head_) {
+        Slot& s = at_(head_);
+        drop = (++s.attempts > cfg_.maxRetries);
+      }
+    }
+    if (drop) completeHead_(-1);
+    return false;
+  }
+
+  client_.setNoDelay(true);   // 파이프라인된 작은 요청이 Nagle 에 묶이지 않도록
+  backoffMs_    = 0;
+  connectedAt_  = millis();
+  lastIoMs_     = connectedAt_;
+  stats_.connects++;
+  resetParser_();
+  return true;
+}
+
+void RestSender::closeConnection_() {
+  client_.stop();
+  if (connectedAt_) {
+    stats_.connectedMs += millis() - connectedAt_;
+    connectedAt_ = 0;
+  }
+  resetParser_();
+}
+
+// ---------- 송신 ----------
+
+bool RestSender::sendSlot_(Slot& s) {
+  char hdr[512];
+  int n = snprintf(hdr, sizeof(hdr),
+                   "POST %s HTTP/1.1\r\n"
+                   "Host: %s:%u\r\n"
+                   "Content-Type: application/json\r\n"
+                   "Content-Length: %u\r\n"
+                   "Connection: keep-alive\r\n",
+                   cfg_.basePath, cfg_.host, cfg_.port, (unsigned)s.len);
+  if (bearer_.length() && n > 0 && n < (int)sizeof(hdr)) {
+    n += snprintf(hdr + n, sizeof(hdr) - n, "Authorization: Bearer %s\r\n", bearer_.c_str());
+  }
+  for (const auto& h : headers_) {
+    if (n <= 0 || n >= (int)sizeof(hdr)) break;
+    n += snprintf(hdr + n, sizeof(hdr) - n, "%s: %s\r\n", h.first.c_str(), h.second.c_str());
+  }
+  if (n <= 0 || n + 2 >= (int)sizeof(hdr)) return false;
+  hdr[n++] = '\r'; hdr[n++] = '\n';
+
+  if (s.attempts > 0) { stats_.retries++; g_retries.inc(); }
+  s.attempts++;
+  s.sentMs = millis();
 
-  if (!http.begin(net, cfg_.host, cfg_.port, cfg_.basePath)) return false;
+  if (client_.write((const uint8_t*)hdr, n) != (size_t)n) return false;
+  if (s.len && client_.write((const uint8_t*)s.body, s.len) != s.len) return false;
+  lastIoMs_ = s.sentMs;
+  return true;
+}
 
-  http.setTimeout(4000);                     // 4초 타임아웃
-  http.addHeader("Content-Type", "application/json");
-  int code = http.POST((uint8_t*)json.c_str(), json.length());
-  String resp = http.getString();         // 필요하면 응답 읽기
+// ---------- 수신 (HTTP/1.1 응답 증분 파서) ----------
 
-  Serial.printf("[RestSender] POST %s -> %d\n", cfg_.basePath, resp.length() ? code : -1);
-  http.end();
-  return (code >= 200 && code < 300);
+void RestSender::resetParser_() {
+  rx_ = RxState::Status;
+  lineLen_ = 0;
+  status_ = 0;
+  remain_ = -1;
+  chunked_ = false;
+  serverClose_ = false;
 }
 
+bool RestSender::feed_(char c) {
+  switch (rx_) {
+    case RxState::Body:
+      return --remain_ <= 0;
+
+    case RxState::ChunkData:
+      if (--remain_ <= 0) rx_ = RxState::ChunkEnd;
+      return false;
+
+    case RxState::UntilClose:         // 버림. 완료는 poll() 이 연결 종료를 보고
+      return false;
+
+    default:
+      break;
+  }
+
+  // 줄 단위 상태
+  if (c != '\n') {
+    if (c != '\r' && lineLen_ < sizeof(line_) - 1) line_[lineLen_++] = c;
+    return false;
+  }
+  line_[lineLen_] = '\0';
+  const uint8_t len = lineLen_;
+  lineLen_ = 0;
+
+  switch (rx_) {
+    case RxState::Status: {
+      // "HTTP/1.1 200 OK"
+      const char* sp = strchr(line_, ' ');
+      status_ = sp ? atoi(sp + 1) : -1;
+      rx_ = RxState::Headers;
+      return false;
+    }
+    case RxState::Headers:
+      if (len == 0) {
+        if (status_ >= 100 && status_ < 200) { resetParser_(); return false; }   // 100 Continue 등 중간 응답
+        if (chunked_)         { rx_ = RxState::ChunkSize; return false; }
+        if (remain_ > 0)      { rx_ = RxState::Body;      return false; }
+        if (remain_ < 0 && status_ != 204 && status_ != 304) {
+          // 길이 없는 본문: 연결 종료까지 읽고, 그 뒤로는 이 연결에 보내지 않음
+          rx_ = RxState::UntilClose;
+          serverClose_ = true;
+          return false;
+        }
+        return true;          // 본문 없음 (204, Content-Length: 0 등)
+      }
+      if (strncasecmp(line_, "Content-Length:", 15) == 0) {
+        remain_ = atoi(line_ + 15);
+      } else if (strncasecmp(line_, "Transfer-Encoding:", 18) == 0) {
+        chunked_ = strcasestr(line_ + 18, "chunked") != nullptr;
+      } else if (strncasecmp(line_, "Connection:", 11) == 0) {
+        serverClose_ = strcasestr(line_ + 11, "close") != nullptr;
+      }
+      return false;
+
+    case RxState::ChunkSize:
+      remain_ = (int32_t)strtol(line_, nullptr, 16);
+      rx_ = (remain_ > 0) ? RxState::ChunkData : RxState::Trailer;
+      return false;
+
+    case RxState::ChunkEnd:           // 청크 데이터 뒤 CRLF
+      rx_ = RxState::ChunkSize;
+      return false;
+
+    case RxState::Trailer:
+      return len == 0;
+
+    default:
+      return false;
+  }
+}
+
+void RestSender::readResponses_() {
+  uint8_t buf[256];
+  while (client_.available() > 0) {
+    int n = client_.read(buf, sizeof(buf));
+    if (n <= 0) break;
+    lastIoMs_ = millis();
+    for (int i = 0; i < n; ++i) {
+      if (!feed_((char)buf[i])) continue;
+
+      if (!inFlight_()) {
+        // 보낸 요청이 없는데 온 응답 (유휴 keep-alive 에 서버가 보내는 408 등) → 대기 중 요청에 붙이지 않음
+        LOGW("RestSender", "unsolicited HTTP %d on idle connection, closing", status_);
+        closeConnection_();
+        return;
+      }
+      const bool close = serverClose_;
+      completeHead_(status_);
+      resetParser_();
+      if (close) {
+        // 남은 전송중 요청은 처리되지 않은 것으로 보고 재전송
+        failInFlight_();
+        closeConnection_();
+        return;
+      }
+    }
+  }
+}
+
+bool RestSender::inFlight_() const {
+  Lock l(lock_);
+  return head_ != send_;
+}
+
+void RestSender::completeHead_(int status) {
+  Result r{};
+  bool fromLog = false;
+  {
+    Lock l(lock_);
+    if (head_ == tail_) return;
+    Slot& s = at_(head_);
+    fromLog     = s.fromLog;
+    r.tag       = s.tag;
+    r.status    = status;
+    r.attempts  = s.attempts;
+    r.latencyMs = millis() - s.submitMs;
+    if (send_ == head_) send_++;
+    head_++;
+  }
+
+  if (r.ok()) stats_.ok++; else stats_.failed++;
+  stats_.lastLatencyMs = r.latencyMs;
+  g_postMs.observe(r.latencyMs);
+  countStatus_(status);
+
+  if (fromLog) {
+    // 로그 레코드는 순서대로만 ack. 하나라도 실패하면 이후 성공분도 ack 하지 않고 나중에 재전송
+    // 영구 거절(4xx)은 재전송해도 같으므로 ack 하고 버림 — 안 그러면 뒤 레코드가 전부 막힘
+    const bool rejected = permanentReject_(status);
+    if (rejected) {
+      stats_.dropped++;
+      g_logDropped.inc();
+      LOGW("RestSender", "HTTP %d: dropping log records through seq %lu", status, (unsigned long)r.tag);
+    }
+    if (!r.ok() && !rejected && !drainHold_) {
+      drainHold_     = true;
+      drainResumeAt_ = millis() + drainRetryMs_;
+    }
+    if ((r.ok() || rejected) && !drainHold_) log_->ackThrough(r.tag);
+  } else if (r.tag == kSyncTag) {
+    syncStatus_ = status ? status : -1;
+    return;
+  }
+  if (cb_) cb_(r);
+}
+
+// ---------- EventLog 드레인 ----------
+
+void RestSender::drainFrom(EventLog* log, Encoder enc, uint32_t retryMs) {
+  log_ = log;
+  enc_ = enc;
+  drainRetryMs_ = retryMs;
+  if (!encBuf_) encBuf_ = new char[cfg_.maxBodyBytes];
+  drainNext_ = log_ ? log_->head() : 0;
+  publishBacklog_();
+}
+
+void RestSender::setBatch(const Batch& b) {
+  batch_ = b;
+  if (batch_.maxBytes == 0 || batch_.maxBytes > cfg_.maxBodyBytes) batch_.maxBytes = cfg_.maxBodyBytes;
+}
+
+size_t RestSender::buildBody_() {
+  uint8_t  rec[EventLog::kPayloadMax];
+  size_t   len;
+  uint32_t ts;
+
+  // 단건: 레코드 하나 = 요청 하나
+  if (batch_.maxEvents <= 1) {
+    while (drainNext_ != log_->tail()) {
+      const bool ok = log_->read(drainNext_, rec, len, ts);
+      const size_t n = ok ? enc_(rec, len, ts, encBuf_, cfg_.maxBodyBytes) : 0;
+      drainNext_++;
+      if (n) return n;       // 깨진/인코딩 불가 레코드는 건너뜀 — 뒤 레코드 ack 때 함께 정리됨
+    }
+    return 0;
+  }
+
+  // 배치: [obj,obj,...]
+  const size_t cap = batch_.maxBytes;
+  size_t   pos   = 0;
+  uint16_t count = 0;
+  encBuf_[pos++] = '[';
+  while (drainNext_ != log_->tail() && count < batch_.maxEvents) {
+    const size_t sep = count ? 1 : 0;
+    if (pos + sep + 2 >= cap) break;                 // 최소 "x]" 자리도 없음
+    if (!log_->read(drainNext_, rec, len, ts)) { drainNext_++; continue; }
+    const size_t n = enc_(rec, len, ts, encBuf_ + pos + sep, cap - pos - sep - 1);
+    if (n == 0) {
+      if (count) break;                              // 남은 자리에 안 들어감 → 다음 배치로
+      drainNext_++;                                  // 단독으로도 안 들어가는 레코드는 버림
+      continue;
+    }
+    if (sep) encBuf_[pos] = ',';
+    pos += sep + n;
+    lastRecBytes_ = n + 1;
+    count++;
+    drainNext_++;
+  }
+  if (count == 0) return 0;
+  encBuf_[pos++] = ']';
+  return pos;
+}
+
+void RestSender::publishBacklog_() {
+  const uint32_t n = log_ ? log_->tail() - drainNext_ : 0;
+  logUnsent_.store((int32_t)n > 0 ? n : 0, std::memory_order_relaxed);
+}
+
+void RestSender::drain_() {
+  if (!log_ || !enc_) return;
+
+  if (drainHold_) {
+    bool logInFlight = false;
+    {
+      Lock l(lock_);
+      for (uint32_t i = head_; i != tail_; ++i) {
+        if (at_(i).fromLog) { logInFlight = true; break; }
+      }
+    }
+    if (logInFlight || (int32_t)(millis() - drainResumeAt_) < 0) return;
+    drainHold_ = false;
+    drainNext_ = log_->head();
+  }
+
+  // 덮어쓰기로 head 가 앞질렀으면 따라감
+  if ((int32_t)(drainNext_ - log_->head()) < 0) drainNext_ = log_->head();
+
+  const uint32_t now = millis();
+  uint32_t unsent = log_->tail() - drainNext_;
+  if (unsent == 0) { firstPendingMs_ = 0; flushReq_ = false; return; }
+  if (firstPendingMs_ == 0) firstPendingMs_ = now | 1;
+
+  if (held_ || WiFi.status() != WL_CONNECTED || (int32_t)(now - nextConnectMs_) < 0) return;
+
+  // 배치 모드: 개수/바이트/대기시간/flush 요청 중 하나라도 만족해야 전송
+  const bool batching = batch_.maxEvents > 1;
+  const bool stale    = (now - firstPendingMs_) >= batch_.maxAgeMs;
+  const bool flushAll = !batching || stale || flushReq_;
+  auto full = [&](uint32_t n) {
+    return n >= batch_.maxEvents || (uint32_t)n * lastRecBytes_ >= batch_.maxBytes;
+  };
+  if (!flushAll && !full(unsent)) return;
+
+  bool sent = false;
+  while (unsent) {
+    {
+      Lock l(lock_);
+      if (tail_ - head_ >= cfg_.queueLen) break;
+    }
+    const uint32_t first = drainNext_;
+    const size_t n = buildBody_();
+    if (n == 0) break;                               // 남은 게 전부 건너뛴 레코드
+    // tag = 본문에 담긴 마지막 seq → 성공 시 ackThrough 로 배치 전체 ack
+    if (!enqueue_(encBuf_, n, drainNext_ - 1, true)) { drainNext_ = first; break; }
+    sent = true;
+    unsent = log_->tail() - drainNext_;
+    if (!flushAll && !full(unsent)) break;          // 남은 건 다음 배치로 모음
+  }
+
+  if (log_->tail() == drainNext_) {
+    firstPendingMs_ = 0;
+    flushReq_ = false;
+  } else if (sent) {
+    firstPendingMs_ = now | 1;                      // 남은 레코드는 지금부터 나이 계산
+  }
+}
+
+void RestSender::failInFlight_() {
+  // 맨 앞부터 재시도 한도를 넘은 요청은 실패로 완료, 나머지는 대기열로 되돌림
+  for (;;) {
+    bool drop = false;
+    {
+      Lock l(lock_);
+      if (head_ == send_) break;
+      drop = at_(head_).attempts > cfg_.maxRetries;
+      if (!drop) { send_ = head_; break; }
+    }
+    completeHead_(-1);
+  }
+}
+
+// ---------- 구동 ----------
+
+void RestSender::poll() {
+  TRACE_SCOPE("rest.poll");
+  const uint32_t now = millis();
+
+  if (client_.connected()) {
+    readResponses_();
+
+    // 가장 오래된 전송중 요청의 응답 타임아웃
+    bool timedOut = false;
+    {
+      Lock l(lock_);
+      if (head_ != send_) timedOut = (now - at_(head_).sentMs) > cfg_.timeoutMs;
+    }
+    if (timedOut) {
+      LOGW("RestSender", "response timeout (%ums), reconnect", cfg_.timeoutMs);
+      failInFlight_();
+      closeConnection_();
+    }
+  } else if (connectedAt_) {
+    readResponses_();   // 닫히기 전에 받아 둔 바이트
+    if (rx_ == RxState::UntilClose && inFlight_()) completeHead_(status_);   // 연결 종료 = 본문 끝
+    failInFlight_();
+    closeConnection_();
+  }
+
+  drain_();
+
+  // 대기 중인 요청을 파이프라인 깊이까지 전송 (길이 없는 응답을 받는 중이면 연결이 닫힐 때까지 보내지 않음)
+  while (!held_ && rx_ != RxState::UntilClose) {
+    Slot* s = nullptr;
+    bool exhaustedAtHead = false;
+    {
+      Lock l(lock_);
+      if (send_ == tail_ || send_ - head_ >= cfg_.maxInFlight) break;
+      Slot& cand = at_(send_);
+      if (cand.attempts > cfg_.maxRetries) {
+        // 앞선 응답을 기다렸다가 맨 앞이 되면 실패 처리 (응답 순서 보존)
+        if (send_ != head_) break;
+        exhaustedAtHead = true;
+      } else {
+        s = &cand;
+      }
+    }
+    if (exhaustedAtHead) { completeHead_(-1); continue; }
+    if (!ensureConnected_()) break;
+    if (!sendSlot_(*s)) {
+      failInFlight_();
+      closeConnection_();
+      break;
+    }
+    Lock l(lock_);
+    send_++;
+  }
+
+  // 유휴 연결 정리
+  if (client_.connected() && pending() == 0 && (held_ || (millis() - lastIoMs_) > cfg_.idleCloseMs)) {
+    closeConnection_();
+  }
+  publishBacklog_();
+}
+
+bool RestSender::post_plain_http(const String& json) {
+  TRACE_SCOPE("rest.post_sync");
+  syncStatus_ = 0;
+  if (!submit(json, kSyncTag)) return false;
+  // 동기 호출은 업링크 창을 기다리지 않음
+  const bool held = held_;
+  held_ = false;
+
+  const uint32_t limit = (uint32_t)cfg_.timeoutMs * (cfg_.maxRetries + 1) + kBackoffMaxMs;
+  const uint32_t t0 = millis();
+  while (syncStatus_ == 0 && (millis() - t0) < limit) {
+    poll();
+    delay(1);
+  }
+  held_ = held;
+
+  LOGD("RestSender", "POST %s -> %d", cfg_.basePath, syncStatus_);
+  return (syncStatus_ >= 200 && syncStatus_ < 300);
+}
@@ -1,29 +1,171 @@
 #pragma once
 #include <Arduino.h>
+#include <WiFiClient.h>
+#include <atomic>
+#include <functional>
 #include <vector>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 
+class EventLog;
+
+// HTTP/1.1 keep-alive 업링크
+//  - 소켓 하나를 유지하면서 큐에 쌓인 POST 를 파이프라인으로 전송
+//  - 응답은 poll() 에서 도착한 만큼만 파싱 (블로킹 읽기 없음)
+//  - 완료(성공/실패)는 onComplete 콜백으로 통지 — poll() 을 부른 태스크 컨텍스트에서 호출됨
+//  - drainFrom() 으로 EventLog 를 붙이면 연결될 때마다 로그를 순서대로 비우고 성공분만 ack
+//  - setBatch() 로 배치 모드를 켜면 로그 레코드를 JSON 배열 하나로 묶어 전송
+//    (개수/바이트/대기시간 중 먼저 닿는 조건, 또는 requestFlush() 시 flush)
+//  - hold() 중에는 새 전송 없이 모아 둠 (RadioScheduler 가 업링크 창에서만 풂)
 class RestSender {
 public:
   struct Config {
     const char* host        = "isluel.iptime.org";     // 예: "api.example.com"
     uint16_t    port        = 35184;     // 443=HTTPS, 80=HTTP
     const char* basePath    = "/api/v2/esp/count";    // 예: "/prod"
-    bool        useHttps    = false;  // true=HTTPS, false=HTTP
-    uint16_t    timeoutMs   = 4000;   // 요청 타임아웃
+    bool        useHttps    = false;  // true=HTTPS, false=HTTP (현재 평문만 지원)
+    uint16_t    timeoutMs   = 4000;   // 요청 타임아웃 (연결 + 응답 대기)
     uint8_t     maxRetries  = 2;      // 재시도 횟수
+    uint8_t     queueLen    = 8;      // 대기+전송중 요청 슬롯 수
+    uint8_t     maxInFlight = 4;      // 파이프라인 깊이 (응답 안 받은 요청 수)
+    uint16_t    maxBodyBytes = 1024;  // 슬롯당 본문 최대 크기
+    uint32_t    idleCloseMs = 15000;  // 유휴 시 연결 종료
+  };
+
+  struct Batch {
+    uint16_t maxEvents = 1;      // <= 1 이면 배치 안 함 (레코드당 POST 1회)
+    uint16_t maxBytes  = 1024;   // maxBodyBytes 로 제한됨
+    uint32_t maxAgeMs  = 0;
   };
 
+  struct Result {
+    uint32_t tag;        // submit() 때 넘긴 식별자
+    int      status;     // HTTP 상태코드, 전송 실패 시 -1
+    uint8_t  attempts;   // 총 시도 횟수
+    uint32_t latencyMs;  // submit → 응답 완료
+    bool ok() const { return status >= 200 && status < 300; }
+  };
+
+  struct Stats {
+    uint32_t submitted  = 0;
+    uint32_t ok         = 0;
+    uint32_t failed     = 0;
+    uint32_t retries    = 0;
+    uint32_t connects   = 0;
+    uint32_t rejected   = 0;   // 큐 가득/본문 초과로 submit 실패
+    uint32_t dropped    = 0;   // 영구 4xx 로 버린 로그 요청 (레코드는 ack)
+    uint32_t lastLatencyMs = 0;
+    uint32_t connectedMs   = 0; // 소켓 열려 있던 누적 시간
+  };
+
+  using Callback = std::function<void(const Result&)>;
+  // EventLog 레코드 → 요청 본문. 반환값 0 이면 건너뜀
+  using Encoder  = size_t (*)(const uint8_t* rec, size_t len, uint32_t ts, char* out, size_t cap);
+
   explicit RestSender(const Config& cfg);
+  ~RestSender();
 
   void setAuthBearer(const String& token);                // Authorization: Bearer <token>
   void addHeader(const String& key, const String& value); // 커스텀 헤더
+  void onComplete(Callback cb) { cb_ = std::move(cb); }
+  void drainFrom(EventLog* log, Encoder enc, uint32_t retryMs = 5000);
+  void setBatch(const Batch& b);
+  void requestFlush() { flushReq_ = true; }   // 세트 종료 등: 모인 이벤트를 기다리지 않고 전송
+  bool flushRequested() const { return flushReq_; }
+  // 전송 보류 (RadioScheduler 업링크 창 밖). 전송중 응답은 계속 받고, 다 받으면 연결을 바로 닫음
+  void hold(bool on) { held_ = on; }
+
+  // 본문을 슬롯에 복사해 큐잉. 어느 태스크에서 불러도 됨. 대기 없음.
+  bool submit(const char* body, size_t len, uint32_t tag = 0);
+  bool submit(const String& body, uint32_t tag = 0) { return submit(body.c_str(), body.length(), tag); }
+
+  // 연결 유지/전송/응답 파싱/타임아웃 처리. 업링크 태스크에서 주기적으로 호출.
+  void poll();
+
+  size_t pending() const;      // 큐 + 전송중
+  // 아직 안 보낸 것: 큐 대기 + 로그에서 안 꺼낸 레코드. 어느 태스크에서 불러도 됨
+  //  (로그 쪽은 poll() 끝에 게시한 값 — 업링크 태스크 밖에서는 최대 poll 1주기 늦음)
+  size_t backlog() const;
+  bool   connected() { return client_.connected(); }
+  const Stats& stats() const { return stats_; }
 
+  // 동기 호환 API: submit 후 완료까지 poll (timeoutMs * (maxRetries+1) 상한)
   bool post_plain_http(const String& json);
 
 private:
+  struct Slot {
+    char*     body = nullptr;
+    uint16_t  len = 0;
+    uint32_t  tag = 0;
+    uint32_t  submitMs = 0;
+    uint32_t  sentMs = 0;
+    uint8_t   attempts = 0;
+    bool      fromLog = false;   // tag = EventLog seq
+  };
+
+  // UntilClose: Content-Length 도 chunked 도 없는 응답 → 연결이 닫혀야 본문 끝
+  enum class RxState : uint8_t { Status, Headers, Body, ChunkSize, ChunkData, ChunkEnd, Trailer, UntilClose };
+
   String buildUrl_(const String& path) const;
 
+  bool ensureConnected_();
+  void closeConnection_();
+  bool sendSlot_(Slot& s);
+  void readResponses_();
+  bool feed_(char c);          // true = 응답 1건 완료
+  void completeHead_(int status);
+  bool inFlight_() const;      // 보냈고 응답을 기다리는 요청이 있음
+  void failInFlight_();        // 연결 끊김/타임아웃: 전송중 요청 재시도 또는 실패 처리
+  void resetParser_();
+  bool enqueue_(const char* body, size_t len, uint32_t tag, bool fromLog);
+  void drain_();
+  size_t buildBody_();         // 로그에서 다음 본문(단건 또는 배열) 생성, drainNext_ 전진
+  void publishBacklog_();      // logUnsent_ 갱신 (업링크 태스크)
+
+  Slot& at_(uint32_t i) { return slots_[i % cfg_.queueLen]; }
+
   Config cfg_;
   String bearer_;
   std::vector<std::pair<String,String>> headers_;
+  Callback cb_;
+
+  WiFiClient client_;
+  Slot*  slots_ = nullptr;
+  char*  bodyPool_ = nullptr;
+  // 링 인덱스(단조 증가, % queueLen): [head_, send_) 전송중, [send_, tail_) 대기
+  uint32_t head_ = 0, send_ = 0, tail_ = 0;
+  SemaphoreHandle_t lock_ = nullptr;
+
+  // 응답 파서
+  RxState  rx_ = RxState::Status;
+  char     line_[128];
+  uint8_t  lineLen_ = 0;
+  int      status_ = 0;
+  int32_t  remain_ = -1;       // Body/ChunkData 남은 바이트, -1 = Content-Length 없음
+  bool     chunked_ = false;
+  bool     serverClose_ = false;
+
+  uint32_t lastIoMs_ = 0;
+  uint32_t connectedAt_ = 0;
+  uint32_t nextConnectMs_ = 0; // 연결 실패 백오프
+  uint32_t backoffMs_ = 0;
+  volatile int syncStatus_ = 0;
+
+  // EventLog 드레인
+  EventLog* log_ = nullptr;
+  Encoder   enc_ = nullptr;
+  char*     encBuf_ = nullptr;
+  uint32_t  drainNext_ = 0;       // 다음에 보낼 seq
+  std::atomic<uint32_t> logUnsent_{0};   // tail - drainNext_ (다른 태스크는 이것만 읽음)
+  uint32_t  drainRetryMs_ = 5000;
+  uint32_t  drainResumeAt_ = 0;
+  bool      drainHold_ = false;   // 실패 발생 → 전송중인 로그 요청이 다 끝나면 head 부터 다시
+
+  // 배치
+  Batch     batch_;
+  volatile bool flushReq_ = false;
+  volatile bool held_ = false;
+  uint32_t  firstPendingMs_ = 0;  // 미전송 레코드가 생긴 시각
+  uint16_t  lastRecBytes_ = 0;    // 직전 인코딩 크기 (바이트 한도 도달 추정용)
+  Stats    stats_;
 };
@@ -0,0 +1,218 @@
+#include "Telemetry.h"
+#include <ESPAsyncWebServer.h>
+#include <atomic>
+#include <base64.h>
+#include <esp_cpu.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "TelemetryFrame.h"
+#include "src/util/spsc_ring.h"
+#include "src/util/log/Log.h"
+
+using TraceFormat::TraceRecord;
+
+namespace {
+  constexpr size_t  kBatchMax   = 64;     // 프레임당 최대 샘플 (남으면 다음 주기)
+  constexpr size_t  kRepMax     = 8;
+  constexpr size_t  kFrameCap   = TelemetryFrame::maxSize(kBatchMax, kRepMax);
+  constexpr uint8_t kPeerMax    = 8;
+  constexpr uint8_t kDecimLevels = 4;     // 1, 2, 4, 8
+  constexpr uint8_t kCalmFrames = 20;     // 큐가 이만큼 연속으로 비면 decimation 절반
+
+  AsyncWebSocket   ws("/ws/telemetry");
+  AsyncEventSource sse("/api/telemetry/sse");
+
+  Telemetry::Config g_cfg;
+  std::atomic<bool> g_active{false};      // 구독자 있음 → 생산자가 링에 넣음
+  SpscRing<TraceRecord, 256> g_samples;
+  SpscRing<RepEvent, 16>     g_reps;
+
+  // 생산자(sense 태스크)만 씀. 읽기는 통계용이라 찢어진 값도 무방
+  uint32_t g_ringDrops = 0;
+  uint32_t g_publishes = 0;
+  uint64_t g_pubCycles = 0;
+  uint32_t g_pubMax    = 0;
+
+  // 펌프 태스크만 씀
+  uint32_t g_frames = 0, g_bytes = 0, g_clientDrops = 0;
+
+  // 클라이언트별 backpressure 상태 (WS 이벤트는 AsyncTCP 태스크, 전송은 펌프 태스크)
+  struct Peer {
+    uint32_t id;
+    uint8_t  decim;
+    uint8_t  calm;
+    uint16_t dropped;
+  };
+  Peer         g_peers[kPeerMax];
+  uint8_t      g_nPeers = 0;
+  Peer         g_ssePeer{0, 1, 0, 0};     // SSE 는 클라이언트별 큐 길이를 안 주므로 묶어서 하나로
+  portMUX_TYPE g_mux = portMUX_INITIALIZER_UNLOCKED;
+
+  void onWsEvent_(AsyncWebSocket*, AsyncWebSocketClient* c, AwsEventType type, void*, uint8_t*, size_t) {
+    if (type == WS_EVT_CONNECT) {
+      bool full;
+      portENTER_CRITICAL(&g_mux);
+      full = g_nPeers >= kPeerMax;
+      if (!full) g_peers[g_nPeers++] = Peer{c->id(), 1, 0, 0};
+      portEXIT_CRITICAL(&g_mux);
+      if (full) { c->close(); return; }
+      g_active.store(true);
+    } else if (type == WS_EVT_DISCONNECT) {
+      portENTER_CRITICAL(&g_mux);
+      for (uint8_t i = 0; i < g_nPeers; ++i) {
+        if (g_peers[i].id == c->id()) { g_peers[i] = g_peers[--g_nPeers]; break; }
+      }
+      portEXIT_CRITICAL(&g_mux);
+    }
+  }
+
+  // decimation 단계별로 한 번만 포장
+  struct FrameCache {
+    const TraceRecord* s; size_t ns;
+    const RepEvent*    r; size_t nr;
+    uint8_t buf[kDecimLevels][kFrameCap];
+    size_t  len[kDecimLevels];
+
+    uint8_t* get(uint8_t decim, uint16_t dropped, size_t& n) {
+      uint8_t lv = 0;
+      while ((1u << lv) < decim && lv + 1 < kDecimLevels) lv++;
+      if (!len[lv]) len[lv] = TelemetryFrame::pack(s, ns, r, nr, (uint8_t)(1u << lv), 0, buf[lv], kFrameCap);
+      // dropped 는 클라이언트마다 다르므로 보내기 직전에 헤더만 고침 (binary() 가 복사해 감)
+      memcpy(buf[lv] + offsetof(TelemetryFrame::Header, dropped), &dropped, sizeof(dropped));
+      n = len[lv];
+      return buf[lv];
+    }
+  };
+  FrameCache g_cache;
+
+  // 송신 큐 상태로 다음 decimation 결정. 보낼 수 있으면 true
+  bool admit_(Peer& p, bool busy, bool idle) {
+    if (busy) {
+      if (p.dropped < 0xFFFF) p.dropped++;
+      if (p.decim < g_cfg.maxDecim) p.decim *= 2;
+      p.calm = 0;
+      g_clientDrops++;
+      return false;
+    }
+    if (idle && ++p.calm >= kCalmFrames) {
+      if (p.decim > 1) p.decim /= 2;
+      p.calm = 0;
+    }
+    return true;
+  }
+
+  void sendWs_() {
+    Peer peers[kPeerMax];
+    uint8_t n;
+    portENTER_CRITICAL(&g_mux);
+    n = g_nPeers;
+    memcpy(peers, g_peers, n * sizeof(Peer));
+    portEXIT_CRITICAL(&g_mux);
+
+    // 클라이언트 포인터는 잡지 않음 — 끊기면 AsyncTCP 쪽에서 해제되므로
+    // id 로 부르는 서버 API(서버 락 안에서 찾음)만 사용. 큐 길이 대신 "가득 참" 여부로 판단
+    for (uint8_t i = 0; i < n; ++i) {
+      Peer& p = peers[i];
+      const bool busy = !ws.availableForWrite(p.id);
+      if (!admit_(p, busy, !busy)) continue;
+      size_t len;
+      const uint8_t* f = g_cache.get(p.decim, p.dropped, len);
+      if (!len) continue;
+      ws.binary(p.id, f, len);
+      p.dropped = 0;
+      g_frames++;
+      g_bytes += len;
+    }
+
+    // 그사이 끊긴 클라이언트는 건너뜀
+    portENTER_CRITICAL(&g_mux);
+    for (uint8_t i = 0; i < n; ++i) {
+      for (uint8_t k = 0; k < g_nPeers; ++k) {
+        if (g_peers[k].id == peers[i].id) { g_peers[k] = peers[i]; break; }
+      }
+    }
+    portEXIT_CRITICAL(&g_mux);
+  }
+
+  void sendSse_() {
+    const size_t clients = sse.count();
+    if (!clients) return;
+    const size_t waiting = sse.avgPacketsWaiting();
+    if (!admit_(g_ssePeer, waiting >= g_cfg.queueHigh, waiting == 0)) return;
+    size_t len;
+    const uint8_t* f = g_cache.get(g_ssePeer.decim, g_ssePeer.dropped, len);
+    if (!len) return;
+    sse.send(base64::encode(f, len).c_str(), "t", millis());
+    g_ssePeer.dropped = 0;
+    g_frames += clients;
+    g_bytes  += len * clients;
+  }
+
+  void pumpTask_(void*) {
+    static TraceRecord s[kBatchMax];
+    static RepEvent    r[kRepMax];
+    TickType_t wake = xTaskGetTickCount();
+    for (;;) {
+      vTaskDelayUntil(&wake, pdMS_TO_TICKS(g_cfg.batchMs));
+
+      const bool active = ws.count() > 0 || sse.count() > 0;
+      g_active.store(active);
+      if (!active) {
+        g_samples.clear();
+        g_reps.clear();
+        continue;
+      }
+
+      const size_t ns = g_samples.pop(s, kBatchMax);
+      const size_t nr = g_reps.pop(r, kRepMax);
+      if (!ns && !nr) continue;
+      g_cache.s = s; g_cache.ns = ns;
+      g_cache.r = r; g_cache.nr = nr;
+      memset(g_cache.len, 0, sizeof(g_cache.len));
+
+      sendWs_();
+      sendSse_();
+    }
+  }
+}
+
+bool Telemetry::begin(AsyncWebServer& server, AuthFilter auth, const Config& cfg) {
+  g_cfg = cfg;
+  ws.onEvent(onWsEvent_);
+  ws.setFilter(auth);
+  sse.setFilter(auth);
+  sse.onConnect([](AsyncEventSourceClient*) { g_active.store(true); });
+  server.addHandler(&ws);
+  server.addHandler(&sse);
+  if (xTaskCreatePinnedToCore(pumpTask_, "telem", cfg.stack, nullptr, cfg.prio, nullptr, cfg.core) != pdPASS) {
+    LOGE("TELEM", "pump task create failed");
+    return false;
+  }
+  return true;
+}
+
+void Telemetry::handle() {
+  ws.cleanupClients(g_cfg.maxClients);
+}
+
+void Telemetry::publishSample(const TraceRecord& r) {
+  if (!g_active.load(std::memory_order_relaxed)) return;
+  const uint32_t c0 = esp_cpu_get_cycle_count();
+  if (!g_samples.push(r)) g_ringDrops++;
+  const uint32_t dc = esp_cpu_get_cycle_count() - c0;
+  g_publishes++;
+  g_pubCycles += dc;
+  if (dc > g_pubMax) g_pubMax = dc;
+}
+
+void Telemetry::publishRep(const RepEvent& ev) {
+  if (!g_active.load(std::memory_order_relaxed)) return;
+  if (!g_reps.push(ev)) g_ringDrops++;
+}
+
+Telemetry::Stats Telemetry::stats() {
+  const uint32_t pubs = g_publishes;
+  return Stats{ (uint8_t)ws.count(), (uint8_t)sse.count(), g_frames, g_bytes, g_ringDrops, g_clientDrops,
+                pubs, pubs ? (uint32_t)(g_pubCycles / pubs) : 0, g_pubMax };
+}
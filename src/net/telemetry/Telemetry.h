@@ -0,0 +1,53 @@
+#pragma once
+#include <Arduino.h>
+#include "src/app/trend/TraceFormat.h"
+#include "src/app/event/RepEvent.h"
+
+class AsyncWebServer;
+class AsyncWebServerRequest;
+
+// 실시간 거리/phase/rep 스트림 (프레임 형식은 TelemetryFrame.h)
+//  - GET /ws/telemetry      : WebSocket 바이너리 프레임
+//  - GET /api/telemetry/sse : EventSource 대체 경로 (event "t", data = 프레임 base64)
+//  - 센서 태스크: publishSample/publishRep 는 SPSC 링에 넣기만 함
+//      구독자가 없으면 바로 반환, 링이 가득 차면 드롭 (대기/락 없음)
+//  - 펌프 태스크: batchMs 마다 링을 비워 프레임 1개로 묶고 클라이언트별로 전송
+//      송신 큐가 가득 찬 클라이언트는 그 프레임을 건너뛰고 decimation 2배,
+//      큐에 여유가 계속 있으면 다시 절반 → 느린 폰 하나가 메모리를 잡아먹지 않음
+//      (WS: 라이브러리 큐 WS_MAX_QUEUED_MESSAGES 기준, SSE: 평균 대기 패킷 queueHigh 기준)
+//  - 클라이언트 정리(cleanupClients)는 handle() — loop() 에서 호출
+namespace Telemetry {
+  using AuthFilter = bool (*)(AsyncWebServerRequest*);
+
+  struct Config {
+    uint16_t    batchMs    = 50;    // 프레임 묶음 주기
+    uint8_t     maxClients = 4;     // WebSocket 동시 접속 상한
+    uint8_t     queueHigh  = 4;     // SSE 평균 대기 패킷 상한 (이상이면 드롭)
+    uint8_t     maxDecim   = 8;
+    uint8_t     core       = 0;     // PRO_CPU (네트워크 쪽)
+    UBaseType_t prio       = 1;
+    uint32_t    stack      = 4096;
+  };
+
+  struct Stats {
+    uint8_t  wsClients;
+    uint8_t  sseClients;
+    uint32_t frames;            // 보낸 프레임 (클라이언트별 합)
+    uint32_t bytes;
+    uint32_t ringDrops;         // 링 가득 참 (펌프가 밀림)
+    uint32_t clientDrops;       // backpressure 로 건너뛴 프레임
+    uint32_t publishes;
+    uint32_t publishAvgCycles;  // publishSample 1회 비용 (CPU 사이클)
+    uint32_t publishMaxCycles;
+  };
+
+  bool begin(AsyncWebServer& server, AuthFilter auth, const Config& cfg = Config());
+  // loop() 에서 주기적으로: 끊긴 클라이언트 해제 + maxClients 초과분 종료
+  void handle();
+
+  // 센서 태스크 전용 (단일 생산자)
+  void publishSample(const TraceFormat::TraceRecord& r);
+  void publishRep(const RepEvent& ev);
+
+  Stats stats();
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "src/app/trend/TraceFormat.h"
+#include "src/app/event/RepEvent.h"
+
+// 실시간 텔레메트리 바이너리 프레임 (리틀엔디언, WebSocket 바이너리 / SSE 는 base64)
+//   [Header 12B][Sample 8B × nSamples][Rep 16B × nReps]
+//  - Header.t0Us = 첫 샘플 시각(micros), Sample.dtUs = 프레임 안 이전 샘플과의 간격 (첫 샘플 0, 65535 에서 포화)
+//  - decim > 1 이면 느린 클라이언트용으로 decim 개 중 1개만 담음 (rep 는 항상 전부)
+//  - dropped: 이 클라이언트가 지난 프레임 이후 backpressure 로 버린 프레임 수 (포화)
+namespace TelemetryFrame {
+
+  constexpr uint8_t kVersion = 1;
+
+  struct Header {
+    uint8_t  version;
+    uint8_t  decim;
+    uint16_t nSamples;
+    uint8_t  nReps;
+    uint8_t  rsv;
+    uint16_t dropped;
+    uint32_t t0Us;
+  };
+
+  struct Sample {
+    uint16_t dtUs;
+    uint16_t raw;          // 센서 원시값(mm)
+    uint16_t mm;           // 필터 출력(mm)
+    uint8_t  phase;        // TrendDetector::Phase
+    uint8_t  flags;        // TraceFormat::Flags
+  };
+
+  struct Rep {
+    uint32_t ms;           // millis()
+    uint16_t minv;
+    uint16_t maxv;
+    uint16_t romMm;
+    uint16_t eccentricMs;
+    uint16_t concentricMs;
+    uint16_t peakVelMms;
+  };
+
+  static_assert(sizeof(Header) == 12, "Header layout");
+  static_assert(sizeof(Sample) == 8,  "Sample layout");
+  static_assert(sizeof(Rep) == 16,    "Rep layout");
+
+  constexpr size_t maxSize(size_t samples, size_t reps) {
+    return sizeof(Header) + samples * sizeof(Sample) + reps * sizeof(Rep);
+  }
+
+  // 반환: 쓴 바이트 수 (cap 부족하면 0)
+  inline size_t pack(const TraceFormat::TraceRecord* s, size_t ns,
+                     const RepEvent* r, size_t nr,
+                     uint8_t decim, uint16_t dropped,
+                     uint8_t* out, size_t cap) {
+    if (decim == 0) decim = 1;
+    const size_t keep = (ns + decim - 1) / decim;
+    if (nr > 255 || maxSize(keep, nr) > cap) return 0;
+
+    uint32_t prevUs = ns ? s[0].tUs : 0;
+    Header h{kVersion, decim, (uint16_t)keep, (uint8_t)nr, 0, dropped, prevUs};
+    memcpy(out, &h, sizeof(h));
+    uint8_t* p = out + sizeof(h);
+
+    for (size_t i = 0; i < ns; i += decim) {
+      const uint32_t dt = s[i].tUs - prevUs;
+      const Sample o{ (uint16_t)(dt > 0xFFFF ? 0xFFFF : dt), s[i].raw, s[i].mm, s[i].phase, s[i].flags };
+      memcpy(p, &o, sizeof(o));
+      p += sizeof(o);
+      prevUs = s[i].tUs;
+    }
+    for (size_t i = 0; i < nr; ++i) {
+      const Rep o{ r[i].ms, r[i].minv, r[i].maxv, r[i].romMm, r[i].eccentricMs, r[i].concentricMs, r[i].peakVelMms };
+      memcpy(p, &o, sizeof(o));
+      p += sizeof(o);
+    }
+    return (size_t)(p - out);
+  }
+
+} // namespace TelemetryFrame
@@ -0,0 +1,109 @@
+#include "static_assets.h"
+#include <LittleFS.h>
+#include <ESPAsyncWebServer.h>
+#include <memory>
+#include <new>
+#include <vector>
+#include "src/util/log/Log.h"
+#include "src/util/tracer/Tracer.h"
+
+namespace {
+  // Basic Auth 뒤의 페이지라 공유 캐시 금지. FS 업데이트 후 늦어도 하루 뒤(또는 새로고침) 반영
+  constexpr const char* kCacheControl = "private, max-age=86400";
+  constexpr size_t      kAssetMax     = 64 * 1024;   // 이보다 큰 압축본은 매니페스트 오류로 간주
+
+  struct Asset {
+    String path;                        // 요청 경로 (/config.html)
+    String mime;
+    String etag;                        // 따옴표 포함 "xxxxxxxxxxxxxxxx"
+    std::unique_ptr<uint8_t[]> body;    // gzip 본문
+    size_t len = 0;
+  };
+
+  std::vector<Asset>  g_assets;
+  StaticAssets::Stats g_stats{};
+
+  // "/config.html text/html 2345 a1b2c3d4e5f60718"
+  bool parseLine_(const String& line, Asset& a, size_t& gzLen) {
+    const int s1 = line.indexOf(' ');
+    const int s2 = s1 < 0 ? -1 : line.indexOf(' ', s1 + 1);
+    const int s3 = s2 < 0 ? -1 : line.indexOf(' ', s2 + 1);
+    if (s3 < 0) return false;
+    a.path = line.substring(0, s1);
+    a.mime = line.substring(s1 + 1, s2);
+    gzLen  = (size_t)line.substring(s2 + 1, s3).toInt();
+    a.etag = "\"" + line.substring(s3 + 1) + "\"";
+    return a.path.startsWith("/") && gzLen > 0 && gzLen <= kAssetMax && a.etag.length() > 2;
+  }
+
+  bool load_(Asset& a, size_t gzLen) {
+    File f = LittleFS.open(a.path + ".gz", "r");
+    if (!f || f.size() != gzLen) return false;
+    a.body.reset(new (std::nothrow) uint8_t[gzLen]);
+    if (!a.body) return false;
+    a.len = f.read(a.body.get(), gzLen);
+    return a.len == gzLen;
+  }
+
+  const Asset* find_(const char* path) {
+    for (const auto& a : g_assets)
+      if (a.path == path) return &a;
+    return nullptr;
+  }
+
+  // If-None-Match: "a", W/"b", * 모두 허용
+  bool matches_(AsyncWebServerRequest* req, const String& etag) {
+    if (!req->hasHeader("If-None-Match")) return false;
+    const String inm = req->header("If-None-Match");
+    return inm == "*" || inm.indexOf(etag) >= 0;
+  }
+}
+
+bool StaticAssets::begin(const char* manifest) {
+  g_assets.clear();
+  g_stats = Stats{};
+  File m = LittleFS.open(manifest, "r");
+  if (!m) {
+    LOGW("WEB", "%s not found, serving plain files", manifest);
+    return false;
+  }
+  while (m.available()) {
+    String line = m.readStringUntil('\n');
+    line.trim();
+    if (line.length() == 0 || line[0] == '#') continue;
+    Asset a;
+    size_t gzLen = 0;
+    if (!parseLine_(line, a, gzLen) || !load_(a, gzLen)) {
+      LOGW("WEB", "bad asset entry: %s", line.c_str());
+      continue;
+    }
+    g_stats.bytes += a.len;
+    g_assets.push_back(std::move(a));
+  }
+  g_stats.assets = g_assets.size();
+  LOGI("WEB", "%u assets (%lu B gzip) cached", (unsigned)g_stats.assets, (unsigned long)g_stats.bytes);
+  return !g_assets.empty();
+}
+
+bool StaticAssets::send(AsyncWebServerRequest* req, const char* path) {
+  TRACE_SCOPE("web.static");
+  const Asset* a = find_(path);
+  if (!a) return false;
+
+  AsyncWebServerResponse* res;
+  if (matches_(req, a->etag)) {
+    res = req->beginResponse(304);
+    g_stats.notModified++;
+  } else {
+    // 본문은 부팅 시 올린 RAM 버퍼를 그대로 사용 (복사 없음)
+    res = req->beginResponse(200, a->mime, a->body.get(), a->len);
+    res->addHeader("Content-Encoding", "gzip");
+    g_stats.served++;
+  }
+  res->addHeader("ETag", a->etag);
+  res->addHeader("Cache-Control", kCacheControl);
+  req->send(res);
+  return true;
+}
+
+StaticAssets::Stats StaticAssets::stats() { return g_stats; }
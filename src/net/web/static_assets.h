@@ -0,0 +1,25 @@
+#pragma once
+#include <Arduino.h>
+
+class AsyncWebServerRequest;
+
+// 미리 압축된 정적 페이지 (assets.sh 가 data/ → _fs_data/ 로 만든 *.gz + /assets.manifest)
+//  - 부팅 시 매니페스트를 한 번 읽어 gzip 본문을 RAM 에 올림 → 요청마다 LittleFS 접근 없음
+//  - 응답: Content-Encoding: gzip, 강한 ETag(압축본 SHA-256 앞 16자리), Cache-Control
+//  - If-None-Match 가 맞으면 본문 없이 304
+namespace StaticAssets {
+  struct Stats {
+    uint16_t assets;      // 매니페스트 항목 수
+    uint32_t bytes;       // RAM 에 올린 gzip 본문 합계
+    uint32_t served;      // 200
+    uint32_t notModified; // 304
+  };
+
+  // 매니페스트가 없거나 깨졌으면 false. send() 가 false 면 호출부가 평문 파일로 대체 (assets.sh 가 원본도 넣음)
+  bool begin(const char* manifest = "/assets.manifest");
+
+  // path("/config.html") 가 매니페스트에 있으면 응답하고 true
+  bool send(AsyncWebServerRequest* req, const char* path);
+
+  Stats stats();
+}
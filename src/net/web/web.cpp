@@ -6,92 +6,78 @@
 #include <LittleFS.h>
 #include <ESPAsyncWebServer.h>
 #include <ArduinoJson.h>
-#include <Update.h>
+#include <memory>
 
 #include "src/config/config.h"
 #include "src/net/wifi/wifi_ap.h"
+#include "src/net/wifi/wifi_scan.h"
+#include "src/net/wifi/radio_scheduler.h"
+#include "src/net/ota/http_ota.h"
 #include "src/devices/power/power.h"
 #include "src/devices/laser/laser.h"
+#include "src/app/recorder/TraceRecorder.h"
+#include "src/app/session/Members.h"
+#include "static_assets.h"
+#include "src/net/telemetry/Telemetry.h"
+#include "src/util/log/Log.h"
+#include "src/util/metrics/Metrics.h"
+#include "src/util/tracer/Tracer.h"
 
 // -----------------------------------------------------------------------------
 // NOTE
 // - 인증: HTTP Basic Auth (세션/쿠키/로그인 페이지 없음)
 // - 보호 대상: 모든 민감 엔드포인트는 Basic Auth 강제
-// - 정적 페이지: /admin.html, /config.html, /update.html (LittleFS)
+// - 정적 페이지: /config.html, /update.html (gzip 자산은 static_assets, 없으면 LittleFS 평문)
 // -----------------------------------------------------------------------------
 
 namespace {
   AsyncWebServer server(80);
 
   inline bool authOK_(AsyncWebServerRequest* req) {
-    const auto& cfg = Config::get();
-    if (!req->authenticate(cfg.adminUser.c_str(), cfg.adminPass.c_str())) {
+    const auto cfg = Config::get();
+    if (!req->authenticate(cfg->adminUser.c_str(), cfg->adminPass.c_str())) {
       req->requestAuthentication();   // 401 + WWW-Authenticate
       return false;
     }
     return true;
   }
 
-  static const char* encToStr(wifi_auth_mode_t m) {
-    switch (m) {
-      case WIFI_AUTH_OPEN: return "OPEN";
-      case WIFI_AUTH_WEP: return "WEP";
-      case WIFI_AUTH_WPA_PSK: return "WPA_PSK";
-      case WIFI_AUTH_WPA2_PSK: return "WPA2_PSK";
-      case WIFI_AUTH_WPA_WPA2_PSK: return "WPA_WPA2_PSK";
-      case WIFI_AUTH_WPA2_ENTERPRISE: return "WPA2_ENT";
-      case WIFI_AUTH_WPA3_PSK: return "WPA3_PSK";
-      case WIFI_AUTH_WPA2_WPA3_PSK: return "WPA2_WPA3_PSK";
-      default: return "UNKNOWN";
-    }
+  // 핸들러 필터용 (401 을 보내지 않고 일치 여부만). WebSocket/SSE 업그레이드 요청에 사용
+  bool authFilter_(AsyncWebServerRequest* req) {
+    const auto cfg = Config::get();
+    return req->authenticate(cfg->adminUser.c_str(), cfg->adminPass.c_str());
   }
+
+  // 스캔은 WiFiScan 이 백그라운드에서 수행. 핸들러는 캐시만 돌려줌
+  //  - 결과 있음: 200 + 목록 (TTL 지났거나 ?refresh=1 이면 새 스캔도 시작)
+  //  - 첫 스캔 진행 중: 202 {"scanning":true} → 프론트가 잠시 후 재요청
+  //  - X-Scan-Age-Ms / X-Scan-In-Progress 헤더로 캐시 상태 전달
   void setupWifiScanRoute() {
     // AP 페이지에서 스캔 가능하도록 AP+STA 모드 권장
     WiFi.mode(WIFI_AP_STA); // 이미 설정됐으면 중복 호출 무해
+    WiFiScan::begin();
 
     server.on("/api/wifi/scan", HTTP_GET, [](AsyncWebServerRequest* req){
+      TRACE_SCOPE("web.wifi.scan");
       if (!authOK_(req)) return;
 
-      // 스캔 실행 (비동기 원하면 true, 여기선 간단히 동기)
-      int n = WiFi.scanNetworks(/*async=*/false, /*show_hidden=*/false);
-
-      // 스트림 응답 시작
-      AsyncResponseStream* resp = req->beginResponseStream("application/json");
-      resp->print('[');
-
-      if (n > 0) {
-        bool first = true;
-        for (int i = 0; i < n; ++i) {
-          String ssid = WiFi.SSID(i);
-          int32_t rssi = WiFi.RSSI(i);
-          wifi_auth_mode_t enc = WiFi.encryptionType(i);
-          String bssid = WiFi.BSSIDstr(i); // "aa:bb:cc:dd:ee:ff"
-
-          // 숨김 SSID는 빈 문자열 → 프론트에서 제외하므로 그대로 내려도 OK
-          // JSON 한 항목 직렬화
-          StaticJsonDocument<256> doc;
-          doc["ssid"]  = ssid;
-          doc["rssi"]  = rssi;
-          doc["enc"]   = encToStr(enc);
-          doc["bssid"] = bssid;
-
-          if (!first) resp->print(',');
-          first = false;
-          serializeJson(doc, *resp);
-        }
-        // 스캔 결과 캐시 지우기(선택)
-        WiFi.scanDelete();
-      }
-      resp->print(']');
-      req->send(resp);
+      const auto snap = WiFiScan::get(req->hasParam("refresh"));
+      AsyncWebServerResponse* res = snap.valid
+        ? req->beginResponse(200, "application/json", snap.json)
+        : req->beginResponse(snap.scanning ? 202 : 503, "application/json",
+                             snap.scanning ? "{\"scanning\":true}" : "{\"error\":\"scan failed\"}");
+      res->addHeader("Cache-Control", "no-store");
+      res->addHeader("X-Scan-Age-Ms", String(snap.ageMs));
+      res->addHeader("X-Scan-In-Progress", snap.scanning ? "1" : "0");
+      req->send(res);
     });
   }
 
   void applyAndSaveConfig_(const AppConfig& in) {
-    AppConfig cur = Config::get();
+    const auto cur = Config::get();
 
-    const bool apChanged  = (in.apSsid != cur.apSsid) || (in.apPass != cur.apPass);
-    const bool staChanged = (in.staSsid!= cur.staSsid)|| (in.staPass!= cur.staPass);
+    const bool apChanged  = (in.apSsid != cur->apSsid) || (in.apPass != cur->apPass);
+    const bool staChanged = (in.staSsid!= cur->staSsid)|| (in.staPass!= cur->staPass);
     const bool wantSTA    = in.staSsid.length() > 0;
 
     Config::save(in);
@@ -113,33 +99,45 @@ namespace {
 
   // ---------- API: Config ----------
   void handleGetConfig(AsyncWebServerRequest* req) {
+    TRACE_SCOPE("web.config.get");
     if (!authOK_(req)) return;
 
-    StaticJsonDocument<512> doc;
+    StaticJsonDocument<768> doc;
     const auto cfg = Config::get();
 
-    doc["apSsid"]    = cfg.apSsid;
-    doc["apPass"]    = cfg.apPass;
-    doc["staSsid"]   = cfg.staSsid;
-    doc["staPass"]   = cfg.staPass;
-    doc["adminUser"] = cfg.adminUser;
-    doc["adminPass"] = cfg.adminPass;
-    doc["version"]   = cfg.version;
+    doc["apSsid"]    = cfg->apSsid;
+    doc["apPass"]    = cfg->apPass;
+    doc["staSsid"]   = cfg->staSsid;
+    doc["staPass"]   = cfg->staPass;
+    doc["adminUser"] = cfg->adminUser;
+    doc["adminPass"] = cfg->adminPass;
+    doc["version"]   = cfg->version;
+    doc["batchMaxEvents"] = cfg->batchMaxEvents;
+    doc["batchMaxBytes"]  = cfg->batchMaxBytes;
+    doc["batchMaxAgeMs"]  = cfg->batchMaxAgeMs;
+    doc["setIdleMs"]      = cfg->setIdleMs;
+    doc["sessionIdleMs"]  = cfg->sessionIdleMs;
+    doc["radioPolicy"]    = RadioScheduler::policyName((RadioScheduler::Policy)cfg->radioPolicy);
+    doc["listenInterval"] = cfg->listenInterval;
+    doc["uplinkWindowMs"] = cfg->uplinkWindowMs;
+    doc["uplinkHighWater"] = cfg->uplinkHighWater;
+    doc["apIdleOffMs"]    = cfg->apIdleOffMs;
 
     String json; serializeJson(doc, json);
     req->send(200, "application/json", json);
   }
 
   void handlePostConfigBody(AsyncWebServerRequest* req, uint8_t* data, size_t len, size_t, size_t) {
+    TRACE_SCOPE("web.config.post");
     if (!authOK_(req)) return;
 
-    StaticJsonDocument<512> doc;
+    StaticJsonDocument<1024> doc;   // 키 문자열도 복사되므로 GET 보다 크게
     if (deserializeJson(doc, data, len)) {
       req->send(400, "text/plain", "Invalid JSON");
       return;
     }
 
-    AppConfig in = Config::get();
+    AppConfig in = *Config::get();
     if (doc.containsKey("apSsid"))    in.apSsid    = (const char*)doc["apSsid"];
     if (doc.containsKey("apPass"))    in.apPass    = (const char*)doc["apPass"];
     if (doc.containsKey("staSsid"))   in.staSsid   = (const char*)doc["staSsid"];
@@ -147,6 +145,24 @@ namespace {
     if (doc.containsKey("adminUser")) in.adminUser = (const char*)doc["adminUser"];
     if (doc.containsKey("adminPass")) in.adminPass = (const char*)doc["adminPass"];
     if (doc.containsKey("version"))   in.version   = doc["version"].as<uint32_t>();
+    if (doc.containsKey("batchMaxEvents")) in.batchMaxEvents = doc["batchMaxEvents"].as<uint16_t>();
+    if (doc.containsKey("batchMaxBytes"))  in.batchMaxBytes  = doc["batchMaxBytes"].as<uint16_t>();
+    if (doc.containsKey("batchMaxAgeMs"))  in.batchMaxAgeMs  = doc["batchMaxAgeMs"].as<uint32_t>();
+    if (doc.containsKey("setIdleMs"))      in.setIdleMs      = doc["setIdleMs"].as<uint32_t>();
+    if (doc.containsKey("sessionIdleMs"))  in.sessionIdleMs  = doc["sessionIdleMs"].as<uint32_t>();
+    if (doc.containsKey("radioPolicy")) {
+      RadioScheduler::Policy p;
+      if (!RadioScheduler::parsePolicy(doc["radioPolicy"] | "", p)) {
+        req->send(400, "text/plain", "radioPolicy: always_on | modem_sleep | scheduled");
+        return;
+      }
+      in.radioPolicy = (uint16_t)p;
+      RadioScheduler::setPolicy(p);   // 정책은 바로, 나머지 라디오 설정은 재부팅 후
+    }
+    if (doc.containsKey("listenInterval"))  in.listenInterval  = doc["listenInterval"].as<uint16_t>();
+    if (doc.containsKey("uplinkWindowMs"))  in.uplinkWindowMs  = doc["uplinkWindowMs"].as<uint32_t>();
+    if (doc.containsKey("uplinkHighWater")) in.uplinkHighWater = doc["uplinkHighWater"].as<uint16_t>();
+    if (doc.containsKey("apIdleOffMs"))     in.apIdleOffMs     = doc["apIdleOffMs"].as<uint32_t>();
 
     applyAndSaveConfig_(in);
     req->send(204); // No Content
@@ -168,6 +184,8 @@ namespace {
     if (!authOK_(req)) return;
     req->send(200, "text/plain", "Rebooting...");
     delay(200);
+    Config::flush();
+    Log::flush();
     ESP.restart();
   }
 
@@ -224,10 +242,420 @@ namespace {
     req->send(200, "application/json", json);
   }
 
+  // ---------- Trace recorder ----------
+  const char* traceStateStr(TraceRecorder::State s) {
+    switch (s) {
+      case TraceRecorder::State::Recording: return "recording";
+      case TraceRecorder::State::Stopped:   return "stopped";
+      default:                              return "idle";
+    }
+  }
+
+  void sendTraceStatus(AsyncWebServerRequest* req) {
+    const auto st = TraceRecorder::status();
+    StaticJsonDocument<256> doc;
+    doc["state"]    = traceStateStr(st.state);
+    doc["capacity"] = st.capacity;
+    doc["written"]  = st.written;
+    doc["selected"] = st.selected;
+    doc["lost"]     = st.lost;
+    doc["preMs"]    = st.preMs;
+    doc["psram"]    = st.psram;
+    doc["periodUs"] = TraceRecorder::periodUs();
+    String json; serializeJson(doc, json);
+    req->send(200, "application/json", json);
+  }
+
+  // 다운로드 진행 상태 (요청마다 하나, 응답 콜백이 소유)
+  struct TraceDownload {
+    TraceRecorder::Cursor cur;
+    bool     headerSent = false;
+    TraceFormat::TraceRecord pend;       // 청크 경계에 걸친 레코드
+    uint8_t  pendOff = sizeof(TraceFormat::TraceRecord);
+  };
+
+  // AsyncTCP 태스크에서 호출됨. 링에서 바로 복사하므로 샘플링은 멈추지 않음
+  size_t fillTraceChunk(TraceDownload& dl, uint8_t* buf, size_t maxLen) {
+    TRACE_SCOPE("web.trace.chunk");
+    using TraceFormat::TraceRecord;
+    constexpr size_t kRec = sizeof(TraceRecord);
+    size_t w = 0;
+
+    if (!dl.headerSent) {
+      if (maxLen < sizeof(TraceFormat::TraceHeader)) return RESPONSE_TRY_AGAIN;
+      // count = 0: 도중에 덮어쓴 레코드는 건너뛰므로 EOF 까지 읽도록
+      const TraceFormat::TraceHeader h{TraceFormat::kMagic, TraceFormat::kVersion, (uint16_t)kRec, 0,
+                                       TraceRecorder::periodUs()};
+      memcpy(buf, &h, sizeof(h));
+      w = sizeof(h);
+      dl.headerSent = true;
+    }
+
+    for (;;) {
+      if (dl.pendOff < kRec) {
+        const size_t n = std::min(kRec - dl.pendOff, maxLen - w);
+        memcpy(buf + w, reinterpret_cast<const uint8_t*>(&dl.pend) + dl.pendOff, n);
+        dl.pendOff += n;
+        w += n;
+      }
+      if (w == maxLen) break;
+
+      TraceRecord tmp[32];
+      const size_t room = (maxLen - w) / kRec;
+      if (room == 0) {
+        if (!TraceRecorder::readNext(dl.cur, &dl.pend, 1)) break;
+        dl.pendOff = 0;
+        continue;
+      }
+      const size_t got = TraceRecorder::readNext(dl.cur, tmp, std::min(room, (size_t)32));
+      if (!got) break;
+      memcpy(buf + w, tmp, got * kRec);
+      w += got * kRec;
+    }
+    return w;   // 0 = 끝
+  }
+
+  void registerTraceRoutes() {
+    server.on("/api/trace", HTTP_GET, [](AsyncWebServerRequest* req){
+      if (!authOK_(req)) return;
+      sendTraceStatus(req);
+    });
+
+    // pre: 시작 시점 이전 몇 ms 를 포함할지 (기본 5000)
+    server.on("/api/trace/start", HTTP_POST, [](AsyncWebServerRequest* req){
+      if (!authOK_(req)) return;
+      if (!TraceRecorder::ready()) { req->send(503, "text/plain", "Trace buffer unavailable"); return; }
+      long pre = 5000;
+      if (req->hasParam("pre", true)) pre = req->getParam("pre", true)->value().toInt();
+      if (pre < 0) { req->send(400, "text/plain", "pre out of range"); return; }
+      TraceRecorder::start((uint32_t)pre);
+      sendTraceStatus(req);
+    });
+
+    server.on("/api/trace/stop", HTTP_POST, [](AsyncWebServerRequest* req){
+      if (!authOK_(req)) return;
+      TraceRecorder::stop();
+      sendTraceStatus(req);
+    });
+
+    // 바이너리(TraceFormat) chunked 스트림. 기록 중이면 요청 시점까지
+    server.on("/api/trace/download", HTTP_GET, [](AsyncWebServerRequest* req){
+      if (!authOK_(req)) return;
+      if (!TraceRecorder::ready()) { req->send(503, "text/plain", "Trace buffer unavailable"); return; }
+      auto dl = std::make_shared<TraceDownload>();
+      dl->cur = TraceRecorder::select();
+      AsyncWebServerResponse* resp = req->beginChunkedResponse("application/octet-stream",
+        [dl](uint8_t* buf, size_t maxLen, size_t) -> size_t { return fillTraceChunk(*dl, buf, maxLen); });
+      resp->addHeader("Content-Disposition", "attachment; filename=\"trace.gbtr\"");
+      req->send(resp);
+    });
+  }
+
+  // ---------- Members (UID → 회원 ID 테이블) ----------
+  //  POST /api/members (CSV "uid_hex,member_id") → 파일로 흘려 쓰고 202, 변환은 loop() 의 Members::handle
+  //  GET  /api/members → import 가 "pending" 이 아닐 때까지 재요청
+  constexpr const char* kMembersUpload   = "/members.csv.tmp";
+  constexpr size_t      kMembersMaxBytes = 64 * 1024;
+
+  // 업로드 파일은 한 번에 한 요청만 (owner). 본문/연결 끊김 콜백은 모두 AsyncTCP 태스크
+  File                   membersUpload;
+  AsyncWebServerRequest* membersOwner = nullptr;
+
+  // 요청별 상태: _tempObject (OtaUploadCtx 와 같은 방식)
+  struct MembersUploadCtx {
+    bool     authed;
+    uint16_t code;     // 0 = 정상, 아니면 완료 시 보낼 오류 코드
+  };
+
+  void releaseMembersUpload_(bool remove) {
+    if (membersUpload) membersUpload.close();
+    if (remove) LittleFS.remove(kMembersUpload);
+    membersOwner = nullptr;
+  }
+
+  const char* importName_(Members::Import s) {
+    switch (s) {
+      case Members::Import::Pending: return "pending";
+      case Members::Import::Ok:      return "ok";
+      case Members::Import::Failed:  return "failed";
+      default:                       return "idle";
+    }
+  }
+
+  void sendMembers_(AsyncWebServerRequest* req, int code) {
+    const auto st = Members::stats();
+    StaticJsonDocument<192> doc;
+    doc["entries"]   = st.entries;
+    doc["hits"]      = st.hits;
+    doc["misses"]    = st.misses;
+    doc["fileReads"] = st.fileReads;
+    doc["import"]    = importName_(st.import);
+    if (st.import == Members::Import::Failed) doc["importError"] = st.importErr;
+    String json; serializeJson(doc, json);
+    req->send(code, "application/json", json);
+  }
+
+  void handleGetMembers(AsyncWebServerRequest* req) {
+    TRACE_SCOPE("web.members.get");
+    if (!authOK_(req)) return;
+    sendMembers_(req, 200);
+  }
+
+  void handlePostMembersBody(AsyncWebServerRequest* req, uint8_t* data, size_t len, size_t index, size_t total) {
+    if (!req->_tempObject) {
+      auto* c = (MembersUploadCtx*)malloc(sizeof(MembersUploadCtx));
+      if (!c) return;
+      *c = MembersUploadCtx{authFilter_(req), 0};
+      req->_tempObject = c;
+      if (!c->authed) return;
+      // 인증/크기/동시 업로드는 첫 조각에서 한 번만 판단
+      if (index != 0)                                    c->code = 400;
+      else if (total > kMembersMaxBytes)                 c->code = 413;
+      else if (membersOwner || Members::importPending()) c->code = 409;
+      if (c->code) return;
+      membersUpload = LittleFS.open(kMembersUpload, "w");
+      if (!membersUpload) { c->code = 500; return; }
+      membersOwner = req;
+      // 도중에 끊기면 반쯤 받은 파일은 버림 (정상 완료 후에는 이미 owner 가 아님)
+      req->onDisconnect([req]() { if (membersOwner == req) releaseMembersUpload_(true); });
+    }
+    auto* c = (MembersUploadCtx*)req->_tempObject;
+    if (!c->authed || c->code || membersOwner != req) return;
+    if (index + len > kMembersMaxBytes) { c->code = 413; releaseMembersUpload_(true); return; }
+    if (membersUpload.write(data, len) != len) { c->code = 500; releaseMembersUpload_(true); }
+  }
+
+  void handlePostMembers(AsyncWebServerRequest* req) {
+    TRACE_SCOPE("web.members.post");
+    if (!authOK_(req)) return;
+    const auto* c = (const MembersUploadCtx*)req->_tempObject;
+    if (!c) { req->send(400, "text/plain", "Missing CSV body"); return; }
+    switch (c->code) {
+      case 0:   break;
+      case 413: req->send(413, "text/plain", "CSV too large (max 64KB)"); return;
+      case 409: req->send(409, "text/plain", "Another member import in progress"); return;
+      case 500: req->send(500, "text/plain", "Cannot store upload (FS full?)"); return;
+      default:  req->send(c->code, "text/plain", "Bad upload"); return;
+    }
+    if (membersOwner != req) { req->send(400, "text/plain", "Missing CSV body"); return; }
+    releaseMembersUpload_(false);
+    if (!Members::requestImport(kMembersUpload)) {
+      LittleFS.remove(kMembersUpload);
+      req->send(409, "text/plain", "Another member import in progress");
+      return;
+    }
+    sendMembers_(req, 202);
+  }
+
+  // ---------- Metrics (Prometheus 텍스트 형식) ----------
+  // 스크레이퍼 설정: basic_auth 로 관리자 계정
+  void handleMetrics(AsyncWebServerRequest* req) {
+    TRACE_SCOPE("web.metrics");
+    if (!authOK_(req)) return;
+    AsyncResponseStream* res = req->beginResponseStream("text/plain; version=0.0.4");
+    res->addHeader("Cache-Control", "no-store");
+    Metrics::render(*res);
+    req->send(res);
+  }
+
+  // ---------- Radio (정책별 전류 추정 / 전달 지연 비교) ----------
+  void handleRadio(AsyncWebServerRequest* req) {
+    if (!authOK_(req)) return;
+    const auto st = RadioScheduler::stats();
+    StaticJsonDocument<1024> doc;
+    doc["policy"]     = RadioScheduler::policyName(st.policy);
+    doc["windowOpen"] = st.windowOpen;
+    doc["apOn"]       = st.apOn;
+    JsonObject w = doc.createNestedObject("windows");
+    w["total"]     = st.windows;
+    w["flush"]     = st.windowsFlush;
+    w["highWater"] = st.windowsHighWater;
+    w["timer"]     = st.windowsTimer;
+    JsonObject per = doc.createNestedObject("policies");
+    for (int i = 0; i < (int)RadioScheduler::Policy::Count; ++i) {
+      const auto& p = st.perPolicy[i];
+      JsonObject o = per.createNestedObject(RadioScheduler::policyName((RadioScheduler::Policy)i));
+      o["totalMs"]      = p.totalMs;
+      o["awakeMs"]      = p.awakeMs;
+      o["estMa"]        = p.estMa;
+      o["delivered"]    = p.delivered;
+      o["latencyAvgMs"] = p.latencyAvgMs;
+      o["latencyMaxMs"] = p.latencyMaxMs;
+    }
+    String json; serializeJson(doc, json);
+    req->send(200, "application/json", json);
+  }
+
+  // ---------- Systrace (태스크/함수 구간, Chrome trace JSON) ----------
+  // 내보내는 동안 기록을 멈춤. 끝나거나 연결이 끊기면 재개
+  void handleSystrace(AsyncWebServerRequest* req) {
+    if (!authOK_(req)) return;
+    if (!Tracer::stats().enabled) { req->send(503, "text/plain", "Tracer disabled (GYMBUDDY_TRACE=0)"); return; }
+    auto ex = std::make_shared<Tracer::Export>(Tracer::beginExport());
+    if (!ex->token) { req->send(409, "text/plain", "Export already in progress"); return; }
+    AsyncWebServerResponse* resp = req->beginChunkedResponse("application/json",
+      [ex](uint8_t* buf, size_t maxLen, size_t) -> size_t {
+        if (maxLen < Tracer::kExportLineMax) return RESPONSE_TRY_AGAIN;
+        return Tracer::fillExport(*ex, buf, maxLen);
+      });
+    resp->addHeader("Content-Disposition", "attachment; filename=\"systrace.json\"");
+    req->onDisconnect([ex]() { Tracer::endExport(*ex); });
+    req->send(resp);
+  }
+
   // ---------- OTA (/update) ----------
+  // ---------- HTTP OTA (src/net/ota/http_ota) ----------
+  // 업로드 요청별 상태: _tempObject 에 둠 (요청이 끝나면 AsyncWebServerRequest 가 free)
+  //  - 인증은 본문 첫 조각에서 한 번 확인 → 동시 업로드끼리 결과를 공유하지 않음
+  struct OtaUploadCtx {
+    bool authed;
+    bool ok;       // 받은 조각을 모두 반영했는지
+    bool gap;      // offset 이 세션 received 보다 뒤
+  };
+
+  OtaUploadCtx* otaCtx_(AsyncWebServerRequest* req) {
+    if (!req->_tempObject) {
+      auto* c = (OtaUploadCtx*)malloc(sizeof(OtaUploadCtx));
+      if (!c) return nullptr;
+      *c = OtaUploadCtx{authFilter_(req), true, false};
+      req->_tempObject = c;
+    }
+    return (OtaUploadCtx*)req->_tempObject;
+  }
+
+  String qparam_(AsyncWebServerRequest* req, const char* name) {
+    return req->hasParam(name) ? req->getParam(name)->value() : String();
+  }
+
+  void sendOtaStatus_(AsyncWebServerRequest* req, int code) {
+    const auto st = HttpOta::status();
+    StaticJsonDocument<256> doc;
+    doc["active"]    = st.active;
+    doc["target"]    = st.target == HttpOta::Target::Firmware ? "fw" : "fs";
+    doc["gzip"]      = st.gzip;
+    doc["verify"]    = st.verify;
+    doc["size"]      = st.size;
+    doc["offset"]    = st.received;
+    doc["written"]   = st.written;
+    doc["elapsedMs"] = st.elapsedMs;
+    doc["flashMs"]   = st.flashMs;
+    if (st.error) doc["error"] = st.error;
+    String json; serializeJson(doc, json);
+    req->send(code, "application/json", json);
+  }
+
+  void sendOtaResult_(AsyncWebServerRequest* req, const HttpOta::Result& r) {
+    StaticJsonDocument<256> doc;
+    doc["ok"]        = r.ok;
+    doc["received"]  = r.received;
+    doc["written"]   = r.written;
+    doc["elapsedMs"] = r.elapsedMs;
+    doc["flashMs"]   = r.flashMs;
+    // 전송 = 받은(압축) 바이트 / 전체 시간, 기록 = 풀린 바이트 / Update.write 누적 시간
+    doc["transferKBps"] = r.elapsedMs ? (float)r.received / r.elapsedMs : 0.0f;
+    doc["flashKBps"]    = r.flashMs   ? (float)r.written  / r.flashMs   : 0.0f;
+    if (!r.ok) doc["error"] = r.error;
+    String json; serializeJson(doc, json);
+    req->send(r.ok ? 200 : 500, "application/json", json);
+    if (r.ok) { delay(300); Config::flush(); Log::flush(); ESP.restart(); }
+  }
+
+  // 멀티파트 업로드 (브라우저 /update 페이지, 예전 스크립트)
+  //  - .bin / .bin.gz 모두 가능, ?sha256= 을 주면 검증 (없어도 .gz 는 gzip CRC32/ISIZE 확인). 이어받기는 /api/ota/* 로
+  void otaMultipart_(HttpOta::Target target, AsyncWebServerRequest* req, const String& filename,
+                     size_t index, uint8_t* data, size_t len) {
+    OtaUploadCtx* c = otaCtx_(req);
+    if (!c || !c->authed || !c->ok) return;
+
+    if (!index) {
+      LOGI("WEB", "%s OTA: %s", target == HttpOta::Target::Firmware ? "FW" : "FS", filename.c_str());
+      bool resumed; String err;
+      const String sha = qparam_(req, "sha256");
+      // 멀티파트는 전체 크기를 모름 (Content-Length 에 경계/헤더 포함) → size 0
+      if (!HttpOta::begin(target, 0, 0, sha.c_str(), resumed, err)) {
+        LOGE("WEB", "OTA: %s", err.c_str());
+        c->ok = false;
+        return;
+      }
+    }
+    if (!HttpOta::write(index, data, len)) c->ok = false;
+  }
+
+  void otaMultipartDone_(AsyncWebServerRequest* req) {
+    if (!authOK_(req)) return;
+    OtaUploadCtx* c = (OtaUploadCtx*)req->_tempObject;
+    if (!c || !c->ok) {
+      const auto st = HttpOta::status();
+      HttpOta::abort("upload failed");
+      req->send(500, "text/plain", st.error ? st.error : "FAIL");
+      return;
+    }
+    sendOtaResult_(req, HttpOta::finish());
+  }
+
+  // 이어받기 가능한 원본 본문 업로드
+  //  1) POST /api/ota/begin?target=fw|fs&size=<gz 바이트>&sha256=<풀린 이미지>[&rawSize=]
+  //       → {"offset":N,"resumed":bool}  (같은 이미지 세션이 살아 있으면 N 부터)
+  //  2) PUT  /api/ota/chunk?offset=N  (application/octet-stream, 아무 크기)
+  //       → 상태 JSON, offset 이 어긋나면 409 + 현재 offset
+  //  3) POST /api/ota/finish → 검증/기록 결과 + 전송/기록 처리량, 성공 시 재시작
+  //  GET /api/ota/status, POST /api/ota/abort
+  void handleOtaBegin(AsyncWebServerRequest* req) {
+    if (!authOK_(req)) return;
+    const String target = qparam_(req, "target");
+    const String sha    = qparam_(req, "sha256");
+    const uint32_t size = (uint32_t)qparam_(req, "size").toInt();
+    if ((target != "fw" && target != "fs") || !size || sha.length() != 64) {
+      req->send(400, "text/plain", "Need target=fw|fs, size, sha256");
+      return;
+    }
+    bool resumed; String err;
+    if (!HttpOta::begin(target == "fw" ? HttpOta::Target::Firmware : HttpOta::Target::Filesystem,
+                        size, (uint32_t)qparam_(req, "rawSize").toInt(), sha.c_str(), resumed, err)) {
+      req->send(500, "text/plain", err);
+      return;
+    }
+    String json = "{\"offset\":" + String(HttpOta::status().received) +
+                  ",\"resumed\":" + (resumed ? "true" : "false") + "}";
+    req->send(200, "application/json", json);
+  }
+
+  void handleOtaChunkBody(AsyncWebServerRequest* req, uint8_t* data, size_t len, size_t index, size_t) {
+    OtaUploadCtx* c = otaCtx_(req);
+    if (!c || !c->authed || !c->ok) return;
+    const uint32_t pos = (uint32_t)qparam_(req, "offset").toInt() + index;
+    if (pos > HttpOta::status().received) { c->ok = false; c->gap = true; return; }
+    if (!HttpOta::write(pos, data, len)) c->ok = false;
+  }
+
+  void handleOtaChunk(AsyncWebServerRequest* req) {
+    if (!authOK_(req)) return;
+    const OtaUploadCtx* c = (const OtaUploadCtx*)req->_tempObject;
+    if (!HttpOta::status().active) { req->send(409, "text/plain", "No OTA session"); return; }
+    if (c && c->gap) { sendOtaStatus_(req, 409); return; }
+    sendOtaStatus_(req, (!c || c->ok) ? 200 : 500);
+  }
+
+  void handleOtaStatus(AsyncWebServerRequest* req) {
+    if (!authOK_(req)) return;
+    sendOtaStatus_(req, 200);
+  }
+
+  void handleOtaFinish(AsyncWebServerRequest* req) {
+    if (!authOK_(req)) return;
+    sendOtaResult_(req, HttpOta::finish());
+  }
+
+  void handleOtaAbort(AsyncWebServerRequest* req) {
+    if (!authOK_(req)) return;
+    HttpOta::abort("client abort");
+    req->send(204);
+  }
+
   void registerHttpOta() {
     server.on("/update", HTTP_GET, [](AsyncWebServerRequest* req){
       if (!authOK_(req)) return;
+      if (StaticAssets::send(req, "/update.html")) return;
       if (LittleFS.exists("/update.html")) {
         req->send(LittleFS, "/update.html", "text/html");
       } else {
@@ -238,71 +666,36 @@ namespace {
       }
     });
 
-    server.on("/update", 
-      HTTP_POST, 
-      [](AsyncWebServerRequest* req){
-        if (!authOK_(req)) return;
-        const bool ok = !Update.hasError();
-        req->send(ok ? 200 : 500, "text/plain", ok ? "OK" : "FAIL");
-        if (ok) { delay(300); ESP.restart(); }
-      },
-      [](AsyncWebServerRequest* req, const String& filename, size_t index, uint8_t* data, size_t len, bool final){
-        static bool authed = false;
-        if (!authed) { if (!authOK_(req)) return; authed = true; }
-
-        if (!index) {
-          Serial.printf("FW OTA: %s\n", filename.c_str());
-          // 펌웨어 파티션 (U_FLASH)로 시작
-          if (!Update.begin(/*UPDATE_SIZE_UNKNOWN*/)) {
-            Update.printError(Serial);
-          }
-        }
-        if (Update.write(data, len) != (int)len) Update.printError(Serial);
-
-        if (final) {
-          if (!Update.end(true)) Update.printError(Serial);
-          authed = false;
-        }
+    server.on("/update", HTTP_POST, otaMultipartDone_,
+      [](AsyncWebServerRequest* req, const String& filename, size_t index, uint8_t* data, size_t len, bool){
+        otaMultipart_(HttpOta::Target::Firmware, req, filename, index, data, len);
       }
     );
-    server.on("/fsupdate", 
-      HTTP_POST,
-      [](AsyncWebServerRequest* req){
-        if (!authOK_(req)) return;
-        const bool ok = !Update.hasError();
-        req->send(ok ? 200 : 500, "text/plain", ok ? "OK" : "FAIL");
-        if (ok) { delay(300); ESP.restart(); }
-      },
-      [](AsyncWebServerRequest* req, const String& filename, size_t index, uint8_t* data, size_t len, bool final){
-        static bool authed = false;
-        if (!authed) { if (!authOK_(req)) return; authed = true; }
-
-        if (!index) {
-          Serial.printf("FS OTA: %s\n", filename.c_str());
-          // FS 파티션 대상으로 시작 (ESP32: U_SPIFFS 사용)
-          // 크기를 모르면 UPDATE_SIZE_UNKNOWN로 시작 가능
-          if (!Update.begin(UPDATE_SIZE_UNKNOWN, U_SPIFFS)) {
-            Update.printError(Serial);
-          }
-        }
-        if (Update.write(data, len) != (int)len) Update.printError(Serial);
-
-        if (final) {
-          if (!Update.end(true)) Update.printError(Serial);
-          authed = false;
-        }
+    // FS 파티션 (ESP32: U_SPIFFS 로 LittleFS 이미지 기록)
+    server.on("/fsupdate", HTTP_POST, otaMultipartDone_,
+      [](AsyncWebServerRequest* req, const String& filename, size_t index, uint8_t* data, size_t len, bool){
+        otaMultipart_(HttpOta::Target::Filesystem, req, filename, index, data, len);
       }
     );
+
+    server.on("/api/ota/begin",  HTTP_POST, handleOtaBegin);
+    server.on("/api/ota/chunk",  HTTP_PUT,  handleOtaChunk, nullptr, handleOtaChunkBody);
+    server.on("/api/ota/status", HTTP_GET,  handleOtaStatus);
+    server.on("/api/ota/finish", HTTP_POST, handleOtaFinish);
+    server.on("/api/ota/abort",  HTTP_POST, handleOtaAbort);
   }
 } // namespace
 
 void WebServerApp::begin() {
   LittleFS.begin(true);
+  StaticAssets::begin();
 
   // ---------- Static pages (protected) ----------
-  // 루트: admin.html 있으면 인증 후 서빙, 없으면 상태 문자열
+  // gzip 자산(매니페스트)이 있으면 RAM 에서 서빙, 예전 FS 이미지거나 gz 를 못 올렸으면 평문 파일
+  // 루트: config.html 있으면 인증 후 서빙, 없으면 상태 문자열
   server.on("/", HTTP_GET, [](AsyncWebServerRequest* req){
     if (!authOK_(req)) return;
+    if (StaticAssets::send(req, "/config.html")) return;
     if (LittleFS.exists("/config.html")) {
       req->send(LittleFS, "/config.html", "text/html");
     } else {
@@ -312,6 +705,7 @@ void WebServerApp::begin() {
 
   server.on("/config", HTTP_GET, [](AsyncWebServerRequest* req){
     if (!authOK_(req)) return;
+    if (StaticAssets::send(req, "/config.html")) return;
     if (LittleFS.exists("/config.html")) {
       req->send(LittleFS, "/config.html", "text/html");
     } else {
@@ -340,14 +734,29 @@ void WebServerApp::begin() {
   // OTA
   registerHttpOta();
 
+  // Trace recorder
+  registerTraceRoutes();
+
+  // Members
+  server.on("/api/members", HTTP_GET, handleGetMembers);
+  server.on("/api/members", HTTP_POST, handlePostMembers, nullptr, handlePostMembersBody);
+
   // Scan Wifi
   setupWifiScanRoute();
 
+  // Metrics / systrace
+  server.on("/metrics", HTTP_GET, handleMetrics);
+  server.on("/api/radio", HTTP_GET, handleRadio);
+  server.on("/api/systrace", HTTP_GET, handleSystrace);
+
+  // Live telemetry (WebSocket + SSE)
+  Telemetry::begin(server, authFilter_);
+
   // Deprecated endpoint
   server.on("/save", HTTP_ANY, [](AsyncWebServerRequest* req){
     req->send(410, "text/plain", "Deprecated. Use POST /api/config (JSON).");
   });
 
   server.begin();
-  Serial.println(String("[WEB] server started at http://") + WiFiMgr::ip());
+  LOGI("WEB", "server started at http://%s", WiFiMgr::ip().c_str());
 }
@@ -0,0 +1,234 @@
+#include "radio_scheduler.h"
+#include <WiFi.h>
+#include <atomic>
+#include <esp_wifi.h>
+#include "src/config/config.h"
+#include "src/net/rest/RestSender.h"
+#include "src/util/log/Log.h"
+#include "src/util/metrics/Metrics.h"
+
+namespace {
+  using RadioScheduler::Policy;
+  constexpr int kPolicies = (int)Policy::Count;
+
+  constexpr uint32_t kApRestoreMs = 10000;   // STA 가 이만큼 끊겨 있으면 AP 복구 (재연결 중 깜빡임 무시)
+
+  RadioScheduler::Config g_cfg;
+  RestSender*            g_sender = nullptr;
+  std::atomic<uint8_t>   g_policy{(uint8_t)Policy::Scheduled};
+
+  // 이하 업링크 태스크에서만 갱신
+  Policy        g_applied     = Policy::Count;   // 마지막으로 적용한 정책
+  wifi_ps_type_t g_ps         = WIFI_PS_NONE;
+  bool          g_psValid     = false;
+  bool          g_window      = false;
+  bool          g_held        = false;
+  bool          g_stalled     = false; // 지난 창이 다 못 보내고 닫힘 → 다음은 타이머 창만
+  uint32_t      g_windowAt    = 0;     // 창 연 시각
+  uint32_t      g_lastWindow  = 0;     // 마지막으로 창 닫은 시각
+  uint32_t      g_apLastUse   = 0;     // AP 접속자가 마지막으로 있던 시각
+  uint32_t      g_staDownAt   = 0;     // 0 = 연결됨
+  uint32_t      g_lastPollMs  = 0;
+  uint32_t      g_windows = 0, g_winFlush = 0, g_winHighWater = 0, g_winTimer = 0;
+
+  struct Acc {
+    uint32_t totalMs, awakeMs, delivered, latMaxMs;
+    uint64_t latSumMs;
+  };
+  Acc g_acc[kPolicies] = {};
+
+  const char* const kNames[kPolicies] = { "always_on", "modem_sleep", "scheduled" };
+
+  // 이벤트 발생 → 서버 응답 (ms 단위, 분 단위까지)
+  const uint32_t kDeliveryMs[] = { 100, 500, 1000, 5000, 15000, 30000, 60000, 120000, 300000 };
+  Metrics::Histogram g_delivery[kPolicies] = {
+    {"gymbuddy_event_delivery_seconds", "Rep event to server ack latency", kDeliveryMs, 9, 1e-3f, "policy=\"always_on\""},
+    {"gymbuddy_event_delivery_seconds", "Rep event to server ack latency", kDeliveryMs, 9, 1e-3f, "policy=\"modem_sleep\""},
+    {"gymbuddy_event_delivery_seconds", "Rep event to server ack latency", kDeliveryMs, 9, 1e-3f, "policy=\"scheduled\""},
+  };
+  Metrics::Gauge g_policyGauge("gymbuddy_radio_policy", "Radio policy (0=always_on 1=modem_sleep 2=scheduled)",
+                               [] { return (float)g_policy.load(std::memory_order_relaxed); });
+  Metrics::Gauge g_estMaGauge("gymbuddy_radio_estimated_ma", "Estimated average radio current for the active policy",
+                              [] { return RadioScheduler::stats().perPolicy[g_policy.load()].estMa; });
+  Metrics::Counter g_windowsTotal("gymbuddy_uplink_windows_total", "Scheduled uplink windows opened");
+
+  uint16_t sleepMa_(Policy p) {
+    switch (p) {
+      case Policy::ModemSleep: return g_cfg.minModemMa;
+      case Policy::Scheduled:  return g_cfg.maxModemMa;
+      default:                 return g_cfg.awakeMa;
+    }
+  }
+
+  void setPs_(wifi_ps_type_t ps) {
+    if (g_psValid && ps == g_ps) return;
+    if (!WiFi.setSleep(ps)) LOGW("RADIO", "setSleep(%d) failed", (int)ps);
+    g_ps = ps;
+    g_psValid = true;
+  }
+
+  void hold_(bool on) {
+    if (on == g_held) return;
+    g_sender->hold(on);
+    g_held = on;
+  }
+
+  // listen_interval 은 연결할 때 AP 에 알림 → 다음 연결부터 적용
+  void applyListenInterval_() {
+    wifi_config_t c;
+    if (esp_wifi_get_config(WIFI_IF_STA, &c) != ESP_OK) return;
+    if (c.sta.listen_interval == g_cfg.listenInterval) return;
+    c.sta.listen_interval = g_cfg.listenInterval;
+    esp_wifi_set_config(WIFI_IF_STA, &c);
+  }
+
+  // STA 가 살아 있고 관리자가 안 쓰면 AP 를 끔 (그래야 STA 절전이 실제로 동작)
+  bool manageAp_(uint32_t now, bool staUp, bool& admin) {
+    bool apOn = WiFi.getMode() & WIFI_MODE_AP;
+    admin = apOn && WiFi.softAPgetStationNum() > 0;
+    if (admin) g_apLastUse = now;
+
+    if (staUp) g_staDownAt = 0;
+    else if (!g_staDownAt) g_staDownAt = now | 1;
+
+    if (apOn && staUp && g_cfg.apIdleOffMs && now - g_apLastUse >= g_cfg.apIdleOffMs) {
+      LOGI("RADIO", "soft AP off (no station for %lus)", (unsigned long)(g_cfg.apIdleOffMs / 1000));
+      WiFi.mode(WIFI_STA);
+      g_psValid = false;   // 모드 변경 후 다시 적용
+      apOn = false;
+    } else if (!apOn && g_staDownAt && (int32_t)(now - g_staDownAt) >= (int32_t)kApRestoreMs) {
+      const auto cfg = Config::get();
+      LOGI("RADIO", "STA down, soft AP back on");
+      WiFi.mode(WIFI_AP_STA);
+      WiFi.softAP(cfg->apSsid.c_str(), cfg->apPass.c_str());
+      g_apLastUse = now;
+      g_psValid = false;
+      apOn = true;
+    }
+    return apOn;
+  }
+}
+
+void RadioScheduler::begin(RestSender* sender, const Config& cfg) {
+  g_cfg    = cfg;
+  g_sender = sender;
+  if (g_cfg.policy >= Policy::Count) g_cfg.policy = Policy::Scheduled;   // NVS 값이 이상하면
+  g_policy.store((uint8_t)g_cfg.policy, std::memory_order_relaxed);
+  g_apLastUse = g_lastWindow = g_lastPollMs = millis();
+  applyListenInterval_();
+  WiFi.onEvent([](WiFiEvent_t, WiFiEventInfo_t) { applyListenInterval_(); }, ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+  LOGI("RADIO", "policy %s (listen interval %u, window %lus, high water %u)",
+       kNames[(int)g_cfg.policy], (unsigned)cfg.listenInterval,
+       (unsigned long)(cfg.windowMs / 1000), (unsigned)cfg.highWater);
+}
+
+void RadioScheduler::poll() {
+  if (!g_sender) return;
+  const uint32_t now = millis();
+  const Policy p = (Policy)g_policy.load(std::memory_order_relaxed);
+  const bool staUp = WiFi.status() == WL_CONNECTED;
+  bool admin = false;
+  const bool apOn = manageAp_(now, staUp, admin);
+
+  if (p != g_applied) {
+    if (g_applied != Policy::Count) LOGI("RADIO", "policy %s -> %s", kNames[(int)g_applied], kNames[(int)p]);
+    g_applied = p;
+    g_window = false;
+  }
+
+  // 창 (Scheduled 에서만). 관리자가 있거나 AP 가 켜져 있으면 창 없이 바로 전송
+  //  - AP 가 켜져 있으면 IDF 가 STA 절전을 안 하므로 이벤트를 모아 봐야 전력 이득 없이 지연만 생김
+  const bool gated = p == Policy::Scheduled && !admin && !apOn;
+  if (!gated) {
+    g_window = false;
+    hold_(false);
+  } else if (!g_window) {
+    const size_t backlog = staUp ? g_sender->backlog() : 0;   // 링크 없으면 창을 열어도 못 보냄
+    const char* why = nullptr;
+    if (backlog && now - g_lastWindow >= g_cfg.windowMs)          { why = "timer";      g_winTimer++; }
+    else if (g_stalled)                                            {}
+    else if (backlog && g_sender->flushRequested())                { why = "flush";      g_winFlush++; }
+    else if (backlog && backlog >= g_cfg.highWater)                { why = "high-water"; g_winHighWater++; }
+    if (why) {
+      g_window   = true;
+      g_windowAt = now;
+      g_windows++;
+      g_windowsTotal.inc();
+      g_sender->requestFlush();   // 창 안에서는 배치 대기 없이 전부
+      hold_(false);
+      LOGD("RADIO", "window open (%s, backlog %u)", why, (unsigned)backlog);
+    } else {
+      hold_(true);
+    }
+  } else if ((g_sender->backlog() == 0 && g_sender->pending() == 0) || now - g_windowAt >= g_cfg.windowMaxMs) {
+    g_stalled    = g_sender->backlog() || g_sender->pending();
+    g_window     = false;
+    g_lastWindow = now;
+    hold_(true);
+    LOGD("RADIO", "window closed after %lums%s", (unsigned long)(now - g_windowAt), g_stalled ? " (stalled)" : "");
+  }
+
+  // 라디오 절전 모드
+  const bool awake = p == Policy::AlwaysOn || admin || apOn || g_window;
+  setPs_(awake ? WIFI_PS_NONE : p == Policy::ModemSleep ? WIFI_PS_MIN_MODEM : WIFI_PS_MAX_MODEM);
+
+  // 계측: AP 가 켜져 있으면 STA 절전이 안 되므로 깨어 있는 것으로
+  const uint32_t dt = now - g_lastPollMs;
+  g_lastPollMs = now;
+  Acc& a = g_acc[(int)p];
+  a.totalMs += dt;
+  if (awake) a.awakeMs += dt;
+}
+
+void RadioScheduler::setPolicy(Policy p) {
+  if (p >= Policy::Count) return;
+  g_policy.store((uint8_t)p, std::memory_order_relaxed);
+}
+
+RadioScheduler::Policy RadioScheduler::policy() {
+  return (Policy)g_policy.load(std::memory_order_relaxed);
+}
+
+const char* RadioScheduler::policyName(Policy p) {
+  return p < Policy::Count ? kNames[(int)p] : "?";
+}
+
+bool RadioScheduler::parsePolicy(const char* s, Policy& out) {
+  for (int i = 0; i < kPolicies; ++i) {
+    if (strcmp(s, kNames[i]) == 0) { out = (Policy)i; return true; }
+  }
+  return false;
+}
+
+void RadioScheduler::recordDelivery(uint32_t latencyMs) {
+  const int p = g_policy.load(std::memory_order_relaxed);
+  Acc& a = g_acc[p];
+  a.delivered++;
+  a.latSumMs += latencyMs;
+  if (latencyMs > a.latMaxMs) a.latMaxMs = latencyMs;
+  g_delivery[p].observe(latencyMs);
+}
+
+RadioScheduler::Stats RadioScheduler::stats() {
+  Stats s{};
+  s.policy           = policy();
+  s.windowOpen       = g_window;
+  s.apOn             = WiFi.getMode() & WIFI_MODE_AP;
+  s.windows          = g_windows;
+  s.windowsFlush     = g_winFlush;
+  s.windowsHighWater = g_winHighWater;
+  s.windowsTimer     = g_winTimer;
+  for (int i = 0; i < kPolicies; ++i) {
+    const Acc& a = g_acc[i];
+    PolicyStats& o = s.perPolicy[i];
+    o.totalMs      = a.totalMs;
+    o.awakeMs      = a.awakeMs;
+    o.estMa        = a.totalMs ? ((float)a.awakeMs * g_cfg.awakeMa +
+                                  (float)(a.totalMs - a.awakeMs) * sleepMa_((Policy)i)) / a.totalMs
+                               : 0.0f;
+    o.delivered    = a.delivered;
+    o.latencyAvgMs = a.delivered ? (uint32_t)(a.latSumMs / a.delivered) : 0;
+    o.latencyMaxMs = a.latMaxMs;
+  }
+  return s;
+}
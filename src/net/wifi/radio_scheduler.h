@@ -0,0 +1,67 @@
+#pragma once
+#include <Arduino.h>
+
+class RestSender;
+
+// STA 라디오 절전 + 업링크 창 (업링크 태스크에서 poll)
+//  - AlwaysOn   : WIFI_PS_NONE, 언제든 전송 (기존 동작)
+//  - ModemSleep : WIFI_PS_MIN_MODEM (DTIM 마다 깨어남), 언제든 전송
+//  - Scheduled  : WIFI_PS_MAX_MODEM + listenInterval, 전송은 창에서만 (RestSender::hold)
+//      창 열림: windowMs 주기 / 세트 종료(requestFlush) / 미전송 highWater 이상
+//      창 안에서는 WIFI_PS_NONE 으로 모아 둔 것을 한 번에 보내고, 다 보내면 닫음
+//  - AP 가 켜져 있으면(접속자 유무 무관) 정책과 무관하게 PS_NONE + 바로 전송
+//  - IDF 는 soft AP 가 켜져 있으면 STA 절전을 하지 않음 → apIdleOffMs 를 켜면(기본 0 = 끔)
+//    STA 가 연결돼 있고 그동안 AP 접속자가 없을 때 AP 를 끔. STA 가 끊기면 AP 를 다시 켬
+//    (AP 가 꺼진 동안 관리 페이지는 STA 주소로 — 관리자가 직접 켜는 옵션)
+//    → Scheduled/ModemSleep 의 절전과 창은 apIdleOffMs 를 켠 뒤 AP 가 꺼져 있을 때만 동작
+//  - 측정: 정책별 체류 시간 / 라디오 깨어 있던 시간 → 평균 전류 추정 (estMa, 실측 아님),
+//          이벤트 발생 → 서버 응답까지 지연 (recordDelivery)
+namespace RadioScheduler {
+  enum class Policy : uint8_t { AlwaysOn, ModemSleep, Scheduled, Count };
+
+  struct Config {
+    Policy   policy         = Policy::Scheduled;
+    uint8_t  listenInterval = 3;        // MAX_MODEM 에서 깨어나는 비콘 간격 (다음 연결부터)
+    uint32_t windowMs       = 60000;    // 업링크 창 주기
+    uint32_t windowMaxMs    = 10000;    // 창 최대 길이 (서버/링크 문제로 못 비워도 닫음)
+    uint16_t highWater      = 10;       // 미전송 이벤트가 이만큼이면 바로 창
+    uint32_t apIdleOffMs    = 0;        // 0 = AP 항상 유지 (켜면 AP 로 관리 페이지 접속 불가)
+    // 라디오 평균 전류 추정 (mA)
+    uint16_t awakeMa        = 100;      // PS_NONE / AP 켜짐
+    uint16_t minModemMa     = 25;
+    uint16_t maxModemMa     = 12;
+  };
+
+  struct PolicyStats {
+    uint32_t totalMs;        // 이 정책으로 지낸 시간
+    uint32_t awakeMs;        // 그중 라디오가 계속 깨어 있던 시간
+    float    estMa;          // 라디오 평균 전류 추정
+    uint32_t delivered;      // 서버가 받은 이벤트 수
+    uint32_t latencyAvgMs;   // 이벤트 발생 → 응답
+    uint32_t latencyMaxMs;
+  };
+
+  struct Stats {
+    Policy   policy;
+    bool     windowOpen;
+    bool     apOn;
+    uint32_t windows;
+    uint32_t windowsFlush, windowsHighWater, windowsTimer;   // 창을 연 이유
+    PolicyStats perPolicy[(int)Policy::Count];
+  };
+
+  // WiFi.begin 이후. sender 는 업링크 태스크 소유 → poll 도 업링크 태스크에서
+  void begin(RestSender* sender, const Config& cfg = Config{});
+  void poll();
+
+  // 어느 태스크에서나 (다음 poll 에서 적용)
+  void setPolicy(Policy p);
+  Policy policy();
+  const char* policyName(Policy p);
+  bool parsePolicy(const char* s, Policy& out);
+
+  // 업링크 태스크: 이벤트 하나가 서버에 도착 (지연 = 이벤트 발생 시각부터)
+  void recordDelivery(uint32_t latencyMs);
+
+  Stats stats();
+}
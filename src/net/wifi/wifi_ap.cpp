@@ -1,22 +1,32 @@
 #include "wifi_ap.h"
 #include "src/config/config.h"
 #include <WiFi.h>
+#include "src/util/log/Log.h"
+#include "src/util/metrics/Metrics.h"
+#include "src/devices/status_led/status_led.h"
 
 namespace {
+  bool g_everConnected = false;       // 이벤트 태스크만 씀
+  bool g_linkUp = false;              // GOT_IP 이후 아직 안 끊김 (재연결 실패마다 오는 DISCONNECTED 는 무시)
+  Metrics::Counter g_disconnects("gymbuddy_wifi_disconnects_total", "STA link losses");
+  Metrics::Counter g_reconnects("gymbuddy_wifi_reconnects_total", "STA got IP again after a link loss");
+  Metrics::Gauge   g_rssi("gymbuddy_wifi_rssi_dbm", "STA signal strength (NaN when not connected)",
+                          [] { return WiFi.status() == WL_CONNECTED ? (float)WiFi.RSSI() : NAN; });
+
   void startAP(const AppConfig& cfg) {
     WiFi.mode(WIFI_AP_STA);
     bool ok = WiFi.softAP(cfg.apSsid.c_str(), cfg.apPass.c_str());
-    Serial.printf("[AP] %s (%s)\n", ok ? "started" : "failed", cfg.apSsid.c_str());
-    Serial.print("[AP] IP: "); Serial.println(WiFi.softAPIP());
+    if (ok) LOGI("AP", "started (%s) IP: %s", cfg.apSsid.c_str(), WiFi.softAPIP().toString().c_str());
+    else    LOGE("AP", "failed (%s)", cfg.apSsid.c_str());
   }
 }
 
 void WiFiMgr::begin() {
-  auto cfg = Config::get();
-  startAP(cfg);
+  const auto cfg = Config::get();
+  startAP(*cfg);
 
-  if (cfg.staSsid.length() > 0) {
-    connectSTA(cfg.staSsid, cfg.staPass);
+  if (cfg->staSsid.length() > 0) {
+    connectSTA(cfg->staSsid, cfg->staPass);
   } else {
     WiFi.mode(WIFI_AP); // STA 정보 없으면 AP only
   }
@@ -25,18 +35,16 @@ void WiFiMgr::begin() {
 bool WiFiMgr::connectSTA(const String& ssid, const String& pass, uint32_t timeoutMs) {
   WiFi.mode(WIFI_AP_STA);
   WiFi.begin(ssid.c_str(), pass.c_str());
-  Serial.printf("[STA] connecting to %s ...\n", ssid.c_str());
+  LOGI("STA", "connecting to %s ...", ssid.c_str());
   uint32_t t0 = millis();
   while (WiFi.status() != WL_CONNECTED && (millis() - t0) < timeoutMs) {
     delay(250);
-    Serial.print(".");
   }
-  Serial.println();
   if (WiFi.status() == WL_CONNECTED) {
-    Serial.printf("[STA] IP: %s\n", WiFi.localIP().toString().c_str());
+    LOGI("STA", "IP: %s", WiFi.localIP().toString().c_str());
     return true;
   } else {
-    Serial.println("[STA] failed, keep AP");
+    LOGE("STA", "failed, keep AP");
     return false;
   }
 }
@@ -45,3 +53,17 @@ String WiFiMgr::ip() {
   if (WiFi.status() == WL_CONNECTED) return WiFi.localIP().toString();
   return WiFi.softAPIP().toString();
 }
+
+void WiFiMgr::watchLink() {
+  WiFi.onEvent([](WiFiEvent_t, WiFiEventInfo_t) {
+    if (g_everConnected) g_reconnects.inc();
+    g_everConnected = true;
+    g_linkUp = true;
+    StatusLED::set("wifi_lost", false);
+  }, ARDUINO_EVENT_WIFI_STA_GOT_IP);
+  WiFi.onEvent([](WiFiEvent_t, WiFiEventInfo_t) {
+    if (g_linkUp) g_disconnects.inc();
+    g_linkUp = false;
+    StatusLED::set("wifi_lost", true);
+  }, ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+}
@@ -9,4 +9,5 @@ namespace WiFiMgr {
     uint32_t timeoutMs = 10000
     );
   String ip();                     // 현재 IP 문자열
+  void watchLink();                // STA 끊김/재연결 카운트 (/metrics). WiFi.begin 전후 한 번
 }
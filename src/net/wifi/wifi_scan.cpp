@@ -0,0 +1,113 @@
+#include "wifi_scan.h"
+#include <WiFi.h>
+#include <ArduinoJson.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+namespace {
+  constexpr uint32_t kScanTimeoutMs = 15000;   // 완료 이벤트가 안 오면 진행 중 표시 해제
+
+  uint32_t              g_ttlMs = 30000;
+  std::atomic<bool>     g_scanning{false};
+  std::atomic<uint32_t> g_startMs{0};
+  SemaphoreHandle_t     g_mtx = nullptr;
+
+  // g_mtx 로 보호
+  bool     g_valid   = false;
+  uint32_t g_doneMs  = 0;
+  uint16_t g_count   = 0;
+  String   g_json    = "[]";
+
+  struct Lock {
+    Lock()  { xSemaphoreTake(g_mtx, portMAX_DELAY); }
+    ~Lock() { xSemaphoreGive(g_mtx); }
+  };
+
+  const char* encToStr(wifi_auth_mode_t m) {
+    switch (m) {
+      case WIFI_AUTH_OPEN: return "OPEN";
+      case WIFI_AUTH_WEP: return "WEP";
+      case WIFI_AUTH_WPA_PSK: return "WPA_PSK";
+      case WIFI_AUTH_WPA2_PSK: return "WPA2_PSK";
+      case WIFI_AUTH_WPA_WPA2_PSK: return "WPA_WPA2_PSK";
+      case WIFI_AUTH_WPA2_ENTERPRISE: return "WPA2_ENT";
+      case WIFI_AUTH_WPA3_PSK: return "WPA3_PSK";
+      case WIFI_AUTH_WPA2_WPA3_PSK: return "WPA2_WPA3_PSK";
+      default: return "UNKNOWN";
+    }
+  }
+
+  // Arduino 이벤트 태스크에서 호출: 결과 직렬화 후 드라이버 쪽 목록 해제
+  void onScanDone_(arduino_event_id_t, arduino_event_info_t) {
+    const int n = WiFi.scanComplete();
+    String json;
+    json.reserve(n > 0 ? n * 80 : 2);
+    json += '[';
+    uint16_t count = 0;
+    for (int i = 0; i < n; ++i) {
+      // 숨김 SSID는 빈 문자열 → 프론트에서 제외하므로 그대로 내려도 OK
+      StaticJsonDocument<256> doc;
+      doc["ssid"]  = WiFi.SSID(i);
+      doc["rssi"]  = WiFi.RSSI(i);
+      doc["enc"]   = encToStr(WiFi.encryptionType(i));
+      doc["bssid"] = WiFi.BSSIDstr(i);
+      String item;
+      serializeJson(doc, item);
+      if (count++) json += ',';
+      json += item;
+    }
+    json += ']';
+    WiFi.scanDelete();
+
+    if (n >= 0) {
+      Lock lk;
+      g_json   = std::move(json);
+      g_count  = count;
+      g_doneMs = millis();
+      g_valid  = true;
+    }
+    g_scanning.store(false);
+  }
+}
+
+void WiFiScan::begin(uint32_t ttlMs) {
+  g_ttlMs = ttlMs;
+  if (g_mtx) return;
+  g_mtx = xSemaphoreCreateMutex();
+  WiFi.onEvent(onScanDone_, ARDUINO_EVENT_WIFI_SCAN_DONE);
+}
+
+bool WiFiScan::request() {
+  if (!g_mtx) return false;
+  bool expected = false;
+  if (!g_scanning.compare_exchange_strong(expected, true)) {
+    // 이미 진행 중: 합류. 완료 이벤트를 놓친 경우에만 다시 시작
+    if (millis() - g_startMs.load() < kScanTimeoutMs) return true;
+    WiFi.scanDelete();
+  }
+  g_startMs.store(millis());
+  const int16_t rc = WiFi.scanNetworks(/*async=*/true, /*show_hidden=*/false);
+  if (rc == WIFI_SCAN_FAILED) {
+    g_scanning.store(false);
+    return false;
+  }
+  return true;
+}
+
+WiFiScan::Snapshot WiFiScan::get(bool forceRefresh) {
+  Snapshot s{false, false, 0, 0, String()};
+  if (!g_mtx) return s;
+  bool stale;
+  {
+    Lock lk;
+    s.valid = g_valid;
+    s.ageMs = g_valid ? millis() - g_doneMs : 0;
+    s.count = g_count;
+    s.json  = g_json;
+    stale   = !g_valid || s.ageMs >= g_ttlMs;
+  }
+  if (forceRefresh || stale) request();
+  s.scanning = g_scanning.load();
+  return s;
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <Arduino.h>
+
+// 백그라운드 Wi-Fi 스캔 + 결과 캐시
+//  - request(): 진행 중인 스캔이 없을 때만 비동기 스캔 시작 (동시 요청은 한 번으로 합쳐짐)
+//  - 완료 이벤트(ARDUINO_EVENT_WIFI_SCAN_DONE)에서 결과를 JSON 배열로 직렬화해 보관
+//  - 웹 핸들러는 캐시만 읽으므로 AsyncTCP 태스크가 스캔 동안 막히지 않음
+namespace WiFiScan {
+  struct Snapshot {
+    bool     valid;       // 한 번이라도 스캔이 끝났는지
+    bool     scanning;    // 스캔 진행 중
+    uint32_t ageMs;       // 마지막 결과 이후 경과 시간
+    uint16_t count;       // AP 수
+    String   json;        // [{"ssid","rssi","enc","bssid"}...]
+  };
+
+  void begin(uint32_t ttlMs = 30000);
+
+  // 스캔 시작 (이미 진행 중이면 무시). 시작했거나 진행 중이면 true
+  bool request();
+
+  // 캐시 복사본. 결과가 TTL 보다 오래됐으면 새 스캔도 걸어 둠 (stale-while-revalidate)
+  Snapshot get(bool forceRefresh = false);
+}
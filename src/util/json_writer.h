@@ -0,0 +1,90 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// 고정 버퍼 JSON writer — 힙 할당 없음
+// 버퍼가 모자라면 이후 쓰기를 모두 무시하고 ok() == false
+class JsonWriter {
+public:
+  JsonWriter(char* buf, size_t cap) : buf_(buf), cap_(cap) {}
+
+  JsonWriter& beginObject() { sep_(); put_('{'); push_(); return *this; }
+  JsonWriter& endObject()   { pop_(); put_('}'); return *this; }
+  JsonWriter& beginArray()  { sep_(); put_('['); push_(); return *this; }
+  JsonWriter& endArray()    { pop_(); put_(']'); return *this; }
+
+  JsonWriter& key(const char* k) {
+    sep_();
+    put_('"'); raw_(k, strlen(k)); put_('"'); put_(':');
+    afterKey_ = true;
+    return *this;
+  }
+
+  JsonWriter& value(const char* s) {
+    sep_();
+    put_('"');
+    for (const char* p = s ? s : ""; *p; ++p) {
+      const uint8_t c = (uint8_t)*p;
+      if (c == '"' || c == '\\') { put_('\\'); put_((char)c); }
+      else if (c < 0x20) {
+        static const char hex[] = "0123456789abcdef";
+        raw_("\\u00", 4); put_(hex[c >> 4]); put_(hex[c & 0xF]);
+      } else put_((char)c);
+    }
+    put_('"');
+    return *this;
+  }
+
+  JsonWriter& value(uint32_t v) {
+    sep_();
+    char tmp[10];
+    uint8_t n = 0;
+    do { tmp[n++] = (char)('0' + v % 10); v /= 10; } while (v);
+    while (n) put_(tmp[--n]);
+    return *this;
+  }
+
+  JsonWriter& value(int32_t v) {
+    if (v < 0) { sep_(); put_('-'); afterKey_ = true; return value((uint32_t)(-(int64_t)v)); }
+    return value((uint32_t)v);
+  }
+
+  JsonWriter& value(bool b) { sep_(); b ? raw_("true", 4) : raw_("false", 5); return *this; }
+
+  template <typename V>
+  JsonWriter& field(const char* k, V v) { return key(k).value(v); }
+
+  bool   ok()   const { return !overflow_; }
+  size_t size() const { return len_; }
+
+private:
+  // 배열/객체 안의 두 번째 원소부터 ',' — 키 바로 뒤 값에는 붙이지 않음
+  void sep_() {
+    if (afterKey_) { afterKey_ = false; return; }
+    if (depth_ == 0) return;
+    const uint8_t bit = (uint8_t)(1u << (depth_ - 1));
+    if (notFirst_ & bit) put_(',');
+    notFirst_ |= bit;
+  }
+  void push_() { if (depth_ < 8) { depth_++; notFirst_ &= (uint8_t)~(1u << (depth_ - 1)); } }
+  void pop_()  { if (depth_) depth_--; }
+
+  void put_(char c) {
+    if (len_ + 1 > cap_) { overflow_ = true; return; }
+    buf_[len_++] = c;
+  }
+  void raw_(const char* s, size_t n) {
+    if (len_ + n > cap_) { overflow_ = true; return; }
+    memcpy(buf_ + len_, s, n);
+    len_ += n;
+  }
+
+  char*   buf_;
+  size_t  cap_;
+  size_t  len_ = 0;
+  uint8_t depth_ = 0;
+  uint8_t notFirst_ = 0;
+  bool    afterKey_ = false;
+  bool    overflow_ = false;
+};
@@ -0,0 +1,190 @@
+#include "Log.h"
+#include <LittleFS.h>
+#include <atomic>
+#include <stdarg.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+namespace {
+  // 고정 크기 슬롯 링 (다중 생산자 / 단일 소비자)
+  //  - 슬롯마다 seq: == pos 이면 비어 있음, == pos+1 이면 채워짐
+  //  - 생산자는 head CAS 로 슬롯을 잡고 그 자리에 바로 vsnprintf → seq 공개
+  //  - 소비자(출력 태스크)는 seq 확인 후 읽고 pos+kSlots 로 되돌림
+  constexpr size_t kSlots  = 64;            // 2의 거듭제곱
+  constexpr size_t kMsgMax = 112;
+  static_assert((kSlots & (kSlots - 1)) == 0, "kSlots must be power of two");
+
+  struct Slot {
+    std::atomic<uint32_t> seq;
+    uint32_t    ms;
+    const char* tag;                        // 문자열 리터럴만 (포인터 보관)
+    uint8_t     level;
+    uint8_t     len;
+    char        msg[kMsgMax];
+  };
+
+  Slot                  g_ring[kSlots];
+  std::atomic<uint32_t> g_head{0};
+  uint32_t              g_tail = 0;         // 소비자만
+
+  Log::Config          g_cfg;
+  std::atomic<bool>    g_started{false};
+  std::atomic<uint8_t> g_level{GYMBUDDY_LOG_LEVEL};
+  SemaphoreHandle_t    g_drainLock = nullptr;   // 출력 태스크 ↔ flush() (생산자는 안 잡음)
+
+  std::atomic<uint32_t> g_written{0}, g_dropped{0}, g_truncated{0}, g_maxUs{0};
+  uint32_t g_fileBytes = 0;
+  File     g_file;
+  uint32_t g_fileSize = 0;
+
+  const char kLevelChar[] = "-EWIDV";
+
+  size_t formatLine_(char* out, size_t cap, uint32_t ms, uint8_t lv, const char* tag, const char* msg, size_t len) {
+    const int n = snprintf(out, cap, "[%7lu][%c][%s] ", (unsigned long)ms, kLevelChar[lv < 6 ? lv : 0], tag);
+    if (n < 0) return 0;
+    size_t p = (size_t)n < cap - 2 ? (size_t)n : cap - 2;
+    if (len > cap - 2 - p) len = cap - 2 - p;
+    memcpy(out + p, msg, len);
+    p += len;
+    out[p++] = '\n';
+    return p;
+  }
+
+  void openFile_() {
+    if (!g_cfg.filePath) return;
+    g_file = LittleFS.open(g_cfg.filePath, "a");
+    g_fileSize = g_file ? (uint32_t)g_file.size() : 0;
+  }
+
+  void rotate_() {
+    g_file.close();
+    String old = String(g_cfg.filePath) + ".1";
+    LittleFS.remove(old);
+    LittleFS.rename(g_cfg.filePath, old);
+    g_file = LittleFS.open(g_cfg.filePath, "w");
+    g_fileSize = 0;
+  }
+
+  void mirror_(const char* line, size_t n) {
+    if (!g_file) return;
+    if (g_fileSize + n > g_cfg.fileMax) rotate_();
+    if (!g_file) return;
+    const size_t w = g_file.write((const uint8_t*)line, n);
+    g_fileSize  += w;
+    g_fileBytes += w;
+  }
+
+  // 호출 태스크에서 링을 비움. 반환: 출력한 줄 수
+  size_t drain_() {
+    char line[kMsgMax + 32];
+    size_t n = 0;
+    for (;;) {
+      Slot& s = g_ring[g_tail & (kSlots - 1)];
+      if (s.seq.load(std::memory_order_acquire) != g_tail + 1) break;
+      const size_t len = formatLine_(line, sizeof(line), s.ms, s.level, s.tag, s.msg, s.len);
+      s.seq.store(g_tail + kSlots, std::memory_order_release);
+      g_tail++;
+      Serial.write((const uint8_t*)line, len);
+      mirror_(line, len);
+      n++;
+    }
+    if (n && g_file) g_file.flush();
+    return n;
+  }
+
+  void drainTask_(void*) {
+    for (;;) {
+      vTaskDelay(pdMS_TO_TICKS(g_cfg.drainMs));
+      xSemaphoreTake(g_drainLock, portMAX_DELAY);
+      drain_();
+      xSemaphoreGive(g_drainLock);
+    }
+  }
+}
+
+bool Log::begin(const Config& cfg) {
+  if (g_started.load()) return true;
+  g_cfg = cfg;
+  for (uint32_t i = 0; i < kSlots; ++i) g_ring[i].seq.store(i, std::memory_order_relaxed);
+  g_head.store(0);
+  g_tail = 0;
+
+  g_drainLock = xSemaphoreCreateMutex();
+  if (!g_drainLock) return false;
+  openFile_();
+  if (cfg.filePath && !g_file) Serial.printf("[LOG] open %s failed, serial only\n", cfg.filePath);
+
+  g_started.store(true, std::memory_order_release);
+  if (xTaskCreatePinnedToCore(drainTask_, "log", cfg.stack, nullptr, cfg.prio, nullptr, cfg.core) != pdPASS) {
+    g_started.store(false);
+    Serial.println("[LOG] drain task create failed");
+    return false;
+  }
+  return true;
+}
+
+void Log::setLevel(Level lv) {
+  g_level.store(lv, std::memory_order_relaxed);
+}
+
+void Log::write(Level lv, const char* tag, const char* fmt, ...) {
+  if (lv > g_level.load(std::memory_order_relaxed)) return;
+  const uint32_t t0 = micros();
+
+  va_list ap;
+  va_start(ap, fmt);
+
+  if (!g_started.load(std::memory_order_acquire)) {
+    // begin() 전: 부팅 초기라 동기 출력
+    char msg[kMsgMax], line[kMsgMax + 32];
+    const int n = vsnprintf(msg, sizeof(msg), fmt, ap);
+    va_end(ap);
+    const size_t len = n < 0 ? 0 : ((size_t)n < sizeof(msg) ? (size_t)n : sizeof(msg) - 1);
+    Serial.write((const uint8_t*)line, formatLine_(line, sizeof(line), millis(), lv, tag, msg, len));
+    return;
+  }
+
+  uint32_t pos = g_head.load(std::memory_order_relaxed);
+  Slot* s;
+  for (;;) {
+    s = &g_ring[pos & (kSlots - 1)];
+    const int32_t dif = (int32_t)(s->seq.load(std::memory_order_acquire) - pos);
+    if (dif == 0) {
+      if (g_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+    } else if (dif < 0) {
+      va_end(ap);
+      g_dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    } else {
+      pos = g_head.load(std::memory_order_relaxed);
+    }
+  }
+
+  const int n = vsnprintf(s->msg, kMsgMax, fmt, ap);
+  va_end(ap);
+  size_t len = n < 0 ? 0 : (size_t)n;
+  if (len >= kMsgMax) { len = kMsgMax - 1; g_truncated.fetch_add(1, std::memory_order_relaxed); }
+  s->ms    = millis();
+  s->tag   = tag;
+  s->level = lv;
+  s->len   = (uint8_t)len;
+  s->seq.store(pos + 1, std::memory_order_release);
+
+  g_written.fetch_add(1, std::memory_order_relaxed);
+  const uint32_t dt = micros() - t0;
+  uint32_t m = g_maxUs.load(std::memory_order_relaxed);
+  while (dt > m && !g_maxUs.compare_exchange_weak(m, dt, std::memory_order_relaxed)) {}
+}
+
+void Log::flush() {
+  if (!g_started.load()) return;
+  xSemaphoreTake(g_drainLock, portMAX_DELAY);
+  drain_();
+  Serial.flush();
+  xSemaphoreGive(g_drainLock);
+}
+
+Log::Stats Log::stats() {
+  return Stats{ g_written.load(), g_dropped.load(), g_truncated.load(), g_fileBytes, g_maxUs.load() };
+}
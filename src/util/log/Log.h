@@ -0,0 +1,77 @@
+#pragma once
+#include <Arduino.h>
+
+// 비동기 로그
+//  - LOGE/LOGW/LOGI/LOGD/LOGV(tag, fmt, ...) : 호출 지점에서 링 슬롯에 바로 포맷만 하고 반환
+//      슬롯 확보는 CAS 한 번 (락/대기 없음, 여러 태스크 동시 사용 가능). 링이 차면 버리고 카운트
+//  - 저우선순위 태스크가 링을 비워 Serial 로 출력 (+ 선택: LittleFS 회전 파일)
+//  - GYMBUDDY_LOG_LEVEL 보다 높은 레벨 호출은 컴파일 단계에서 사라짐 (인자도 평가 안 됨)
+//  - begin() 전 호출은 Serial 로 바로 출력 (부팅 초기 로그 유지)
+//  - ISR 에서는 사용 금지 (vsnprintf)
+
+// 0 = 없음, 1 = Error, 2 = Warn, 3 = Info, 4 = Debug, 5 = Verbose
+#ifndef GYMBUDDY_LOG_LEVEL
+#define GYMBUDDY_LOG_LEVEL 3
+#endif
+
+namespace Log {
+  enum Level : uint8_t { kNone = 0, kError, kWarn, kInfo, kDebug, kVerbose };
+
+  struct Config {
+    const char* filePath  = nullptr;     // 예: "/log.txt" (nullptr = 파일 미러 끔)
+    uint32_t    fileMax   = 64 * 1024;   // 넘으면 <path>.1 로 돌리고 새 파일
+    uint16_t    drainMs   = 20;          // 출력 태스크 주기
+    uint8_t     core      = 0;
+    UBaseType_t prio      = 1;
+    uint32_t    stack     = 3072;
+  };
+
+  struct Stats {
+    uint32_t written;     // 링에 들어간 메시지
+    uint32_t dropped;     // 링이 차서 버린 메시지
+    uint32_t truncated;   // 슬롯보다 길어 잘린 메시지
+    uint32_t fileBytes;   // 파일 미러에 쓴 바이트
+    uint32_t maxFormatUs; // 호출 지점 최대 비용
+  };
+
+  bool begin(const Config& cfg = Config());
+
+  // 실행 중 임계값 (컴파일 임계값보다 낮출 수만 있음)
+  void setLevel(Level lv);
+
+  void write(Level lv, const char* tag, const char* fmt, ...) __attribute__((format(printf, 3, 4)));
+
+  // 링에 남은 것을 호출한 태스크에서 바로 출력 (재부팅 직전 등)
+  void flush();
+
+  Stats stats();
+}
+
+#define GYMBUDDY_LOG_AT_(lv, tag, ...) Log::write((lv), (tag), __VA_ARGS__)
+#define GYMBUDDY_LOG_NOP_(...)         do {} while (0)
+
+#if GYMBUDDY_LOG_LEVEL >= 1
+#define LOGE(tag, ...) GYMBUDDY_LOG_AT_(Log::kError, tag, __VA_ARGS__)
+#else
+#define LOGE(...) GYMBUDDY_LOG_NOP_()
+#endif
+#if GYMBUDDY_LOG_LEVEL >= 2
+#define LOGW(tag, ...) GYMBUDDY_LOG_AT_(Log::kWarn, tag, __VA_ARGS__)
+#else
+#define LOGW(...) GYMBUDDY_LOG_NOP_()
+#endif
+#if GYMBUDDY_LOG_LEVEL >= 3
+#define LOGI(tag, ...) GYMBUDDY_LOG_AT_(Log::kInfo, tag, __VA_ARGS__)
+#else
+#define LOGI(...) GYMBUDDY_LOG_NOP_()
+#endif
+#if GYMBUDDY_LOG_LEVEL >= 4
+#define LOGD(tag, ...) GYMBUDDY_LOG_AT_(Log::kDebug, tag, __VA_ARGS__)
+#else
+#define LOGD(...) GYMBUDDY_LOG_NOP_()
+#endif
+#if GYMBUDDY_LOG_LEVEL >= 5
+#define LOGV(tag, ...) GYMBUDDY_LOG_AT_(Log::kVerbose, tag, __VA_ARGS__)
+#else
+#define LOGV(...) GYMBUDDY_LOG_NOP_()
+#endif
@@ -0,0 +1,107 @@
+#include "Metrics.h"
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+
+using namespace Metrics;
+
+namespace {
+  // 상수 초기화 → 다른 번역 단위의 전역 메트릭 생성자보다 항상 먼저 준비됨
+  Metric* g_head = nullptr;
+  Metric* g_tail = nullptr;
+
+  void series_(Print& out, const Metric& m, const char* suffix, const char* extra) {
+    out.print(m.name());
+    if (suffix) out.print(suffix);
+    const char* l = m.labels();
+    if (l || extra) {
+      out.print('{');
+      if (l) out.print(l);
+      if (l && extra) out.print(',');
+      if (extra) out.print(extra);
+      out.print('}');
+    }
+    out.print(' ');
+  }
+
+  const char* typeName_(Metric::Type t) {
+    switch (t) {
+      case Metric::Type::Counter:   return "counter";
+      case Metric::Type::Gauge:     return "gauge";
+      case Metric::Type::Histogram: return "histogram";
+    }
+    return "untyped";
+  }
+
+  // 공통 시스템 메트릭
+  Gauge g_heapFree("gymbuddy_heap_free_bytes", "Free 8-bit heap",
+                   [] { return (float)heap_caps_get_free_size(MALLOC_CAP_8BIT); });
+  Gauge g_heapMin("gymbuddy_heap_min_free_bytes", "Lowest free 8-bit heap since boot",
+                  [] { return (float)heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT); });
+  Gauge g_heapBlock("gymbuddy_heap_largest_free_block_bytes", "Largest allocatable 8-bit block",
+                    [] { return (float)heap_caps_get_largest_free_block(MALLOC_CAP_8BIT); });
+  Gauge g_uptime("gymbuddy_uptime_seconds", "Seconds since boot",
+                 [] { return (float)(esp_timer_get_time() / 1000000); });
+}
+
+const uint32_t Metrics::kLatencyUs[10] = {100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000};
+const uint32_t Metrics::kLatencyMs[9]  = {50, 100, 250, 500, 1000, 2500, 5000, 10000, 30000};
+
+Metric::Metric(Type type, const char* name, const char* help, const char* labels)
+: type_(type), name_(name), help_(help), labels_(labels) {
+  if (g_tail) g_tail->next_ = this; else g_head = this;
+  g_tail = this;
+}
+
+void Counter::render(Print& out) const {
+  series_(out, *this, nullptr, nullptr);
+  out.println((unsigned long)value());
+}
+
+void Gauge::render(Print& out) const {
+  series_(out, *this, nullptr, nullptr);
+  const float v = value();
+  if (isnan(v)) out.println("NaN");
+  else          out.printf("%.6g\n", v);
+}
+
+Histogram::Histogram(const char* name, const char* help, const uint32_t* bounds, uint8_t n,
+                     float scale, const char* labels)
+: Metric(Type::Histogram, name, help, labels), bounds_(bounds),
+  n_(n > kMaxBounds ? kMaxBounds : n), scale_(scale) {}
+
+void Histogram::observe(uint32_t v) {
+  uint8_t i = 0;
+  while (i < n_ && v > bounds_[i]) ++i;
+  counts_[i].fetch_add(1, std::memory_order_relaxed);
+  const uint32_t old = sumLo_.fetch_add(v, std::memory_order_relaxed);
+  if ((uint32_t)(old + v) < old) sumHi_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Histogram::render(Print& out) const {
+  char le[24];
+  unsigned long cum = 0;
+  for (uint8_t i = 0; i <= n_; ++i) {
+    cum += counts_[i].load(std::memory_order_relaxed);
+    if (i < n_) snprintf(le, sizeof(le), "le=\"%.6g\"", bounds_[i] * scale_);
+    else        snprintf(le, sizeof(le), "le=\"+Inf\"");
+    series_(out, *this, "_bucket", le);
+    out.println(cum);
+  }
+  const uint64_t sum = ((uint64_t)sumHi_.load(std::memory_order_relaxed) << 32) |
+                       sumLo_.load(std::memory_order_relaxed);
+  series_(out, *this, "_sum", nullptr);
+  out.printf("%.6g\n", (double)sum * scale_);
+  series_(out, *this, "_count", nullptr);
+  out.println(cum);
+}
+
+void Metrics::render(Print& out) {
+  const char* prev = nullptr;
+  for (const Metric* m = g_head; m; m = m->next()) {
+    if (!prev || strcmp(prev, m->name()) != 0) {
+      out.printf("# HELP %s %s\n# TYPE %s %s\n", m->name(), m->help(), m->name(), typeName_(m->type()));
+      prev = m->name();
+    }
+    m->render(out);
+  }
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+
+// Prometheus 텍스트 형식 메트릭 (GET /metrics)
+//  - 각 모듈이 자기 .cpp 에 전역 객체로 선언 → 생성자에서 레지스트리(연결 리스트)에 등록
+//      등록은 정적 초기화 때만. 이후 목록은 읽기 전용이라 갱신/출력 모두 락 없음
+//  - 갱신: relaxed 원자 연산 1~2회 (히스토그램은 + 버킷 선형 탐색)
+//  - 이름이 같은 메트릭(라벨만 다름)은 같은 파일에 연달아 선언 → HELP/TYPE 한 번만 출력
+//  - 히스토그램은 정수(µs, ms 등)로 받고 출력 때 scale 을 곱함 (Prometheus 관례: _seconds)
+namespace Metrics {
+
+  class Metric {
+  public:
+    enum class Type : uint8_t { Counter, Gauge, Histogram };
+    Metric(Type type, const char* name, const char* help, const char* labels);
+    virtual ~Metric() = default;
+
+    Type        type() const   { return type_; }
+    const char* name() const   { return name_; }
+    const char* help() const   { return help_; }
+    const char* labels() const { return labels_; }
+    Metric*     next() const   { return next_; }
+
+    virtual void render(Print& out) const = 0;
+
+  private:
+    Type        type_;
+    const char* name_;
+    const char* help_;
+    const char* labels_;     // 예: "task=\"sense\"" (nullptr = 없음)
+    Metric*     next_ = nullptr;
+  };
+
+  class Counter : public Metric {
+  public:
+    Counter(const char* name, const char* help, const char* labels = nullptr)
+    : Metric(Type::Counter, name, help, labels) {}
+    void     inc(uint32_t n = 1) { v_.fetch_add(n, std::memory_order_relaxed); }
+    uint32_t value() const       { return v_.load(std::memory_order_relaxed); }
+    void render(Print& out) const override;
+  private:
+    std::atomic<uint32_t> v_{0};
+  };
+
+  // set() 으로 갱신하거나, fn 을 주면 스크레이프 때 읽음 (힙/RSSI 등)
+  class Gauge : public Metric {
+  public:
+    using Fn = float (*)();
+    Gauge(const char* name, const char* help, Fn fn = nullptr, const char* labels = nullptr)
+    : Metric(Type::Gauge, name, help, labels), fn_(fn) {}
+    void  set(float v)  { v_.store(v, std::memory_order_relaxed); }
+    float value() const { return fn_ ? fn_() : v_.load(std::memory_order_relaxed); }
+    void render(Print& out) const override;
+  private:
+    Fn                 fn_;
+    std::atomic<float> v_{0.0f};
+  };
+
+  class Histogram : public Metric {
+  public:
+    static constexpr uint8_t kMaxBounds = 12;
+    // bounds: 오름차순 상한(정수 단위), +Inf 버킷은 자동
+    Histogram(const char* name, const char* help, const uint32_t* bounds, uint8_t n,
+              float scale, const char* labels = nullptr);
+    void observe(uint32_t v);
+    void render(Print& out) const override;
+  private:
+    const uint32_t*       bounds_;
+    uint8_t               n_;
+    float                 scale_;
+    std::atomic<uint32_t> counts_[kMaxBounds + 1] = {};
+    std::atomic<uint32_t> sumLo_{0}, sumHi_{0};   // 64비트 합 (자리올림은 따로, 읽을 때 잠깐 어긋날 수 있음)
+  };
+
+  // 자주 쓰는 버킷
+  extern const uint32_t kLatencyUs[10];   // 100µs ~ 100ms
+  extern const uint32_t kLatencyMs[9];    // 50ms ~ 30s
+
+  // 등록된 전체 메트릭을 텍스트 형식으로
+  void render(Print& out);
+}
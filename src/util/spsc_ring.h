@@ -0,0 +1,39 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+// 생산자 1 / 소비자 1 고정 크기 링 (락 없음, 힙 없음)
+//  - push(): 가득 차면 대기하지 않고 false (호출부가 드롭 카운트)
+//  - N 은 2의 거듭제곱 → 인덱스는 마스크
+template <class T, size_t N>
+class SpscRing {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be a power of two");
+
+public:
+  bool push(const T& v) {
+    const uint32_t w = wr_.load(std::memory_order_relaxed);
+    if (w - rd_.load(std::memory_order_acquire) >= N) return false;
+    buf_[w & (N - 1)] = v;
+    wr_.store(w + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t pop(T* out, size_t max) {
+    const uint32_t r = rd_.load(std::memory_order_relaxed);
+    const uint32_t avail = wr_.load(std::memory_order_acquire) - r;
+    const size_t n = avail < max ? avail : max;
+    for (size_t i = 0; i < n; ++i) out[i] = buf_[(r + i) & (N - 1)];
+    rd_.store(r + (uint32_t)n, std::memory_order_release);
+    return n;
+  }
+
+  // 소비자 쪽에서만 호출
+  void clear() { rd_.store(wr_.load(std::memory_order_acquire), std::memory_order_release); }
+  size_t size() const { return wr_.load(std::memory_order_acquire) - rd_.load(std::memory_order_acquire); }
+
+private:
+  T buf_[N];
+  std::atomic<uint32_t> wr_{0};
+  std::atomic<uint32_t> rd_{0};
+};
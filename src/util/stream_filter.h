@@ -0,0 +1,205 @@
+#pragma once
+#include <stdint.h>
+#include "math_utils.h"
+
+// 거리 샘플용 스트리밍 필터 — 샘플 1개 입력에 출력 1개, 힙/부동소수 없음
+//  - SlidingMedian : 최근 N개 중앙값. 인덱스 달린 max/min 힙 쌍으로 갱신 O(log N)
+//  - HampelFilter  : |x - median| > k·σ 이면 median 으로 치환. σ 는 |x - median| 의 EMA(×1.4826)로 근사
+//  - IntEma        : y += (x - y) / 2^shift, 4bit 소수부 고정소수점
+//  - FilterChain   : Hampel → Median → EMA 순서, 각 단계 on/off
+
+class SlidingMedian {
+public:
+  static constexpr uint8_t kMaxWindow = 31;
+
+  explicit SlidingMedian(uint8_t window = 5) { setWindow(window); }
+
+  void setWindow(uint8_t window) {
+    n_ = (window == 0) ? 1 : (window > kMaxWindow ? kMaxWindow : window);
+    reset();
+  }
+  void reset() { count_ = 0; head_ = 0; nLo_ = 0; nHi_ = 0; }
+  uint8_t window() const { return n_; }
+
+  uint16_t push(uint16_t v) {
+    const uint8_t slot = head_;
+    head_ = (uint8_t)((head_ + 1) % n_);
+    val_[slot] = v;
+
+    if (count_ < n_) {
+      count_++;
+      if (nLo_ == 0 || v <= val_[lo_[0]]) insert_(false, slot);
+      else                                  insert_(true, slot);
+      // 크기 균형: nLo == nHi 또는 nLo == nHi + 1
+      if (nLo_ > nHi_ + 1)  insert_(true,  popTop_(false));
+      else if (nHi_ > nLo_) insert_(false, popTop_(true));
+    } else {
+      // 가장 오래된 슬롯을 새 값으로 덮어쓰고 그 자리에서 힙 복구
+      const uint8_t w = where_[slot];
+      const bool hi = (w & 0x80) != 0;
+      const uint8_t i = siftUp_(hi, w & 0x7F);
+      siftDown_(hi, i);
+      // 경계 위반은 최대 한 쌍 → top 교환 한 번으로 복구
+      if (nHi_ && val_[lo_[0]] > val_[hi_[0]]) {
+        const uint8_t a = lo_[0], b = hi_[0];
+        set_(false, 0, b);
+        set_(true, 0, a);
+        siftDown_(false, 0);
+        siftDown_(true, 0);
+      }
+    }
+    return median();
+  }
+
+  uint16_t median() const {
+    if (count_ == 0) return 0;
+    if (nLo_ > nHi_) return val_[lo_[0]];
+    return (uint16_t)(((uint32_t)val_[lo_[0]] + val_[hi_[0]]) / 2);
+  }
+
+private:
+  // hi=false: lo 힙(max-heap), hi=true: hi 힙(min-heap)
+  uint8_t* heap_(bool hi) { return hi ? hi_ : lo_; }
+  uint8_t& size_(bool hi) { return hi ? nHi_ : nLo_; }
+  bool above_(bool hi, uint8_t a, uint8_t b) const { return hi ? val_[a] < val_[b] : val_[a] > val_[b]; }
+  void set_(bool hi, uint8_t i, uint8_t slot) {
+    heap_(hi)[i] = slot;
+    where_[slot] = (uint8_t)((hi ? 0x80 : 0) | i);
+  }
+
+  uint8_t siftUp_(bool hi, uint8_t i) {
+    uint8_t* h = heap_(hi);
+    while (i > 0) {
+      const uint8_t p = (uint8_t)((i - 1) / 2);
+      if (!above_(hi, h[i], h[p])) break;
+      const uint8_t a = h[i], b = h[p];
+      set_(hi, i, b);
+      set_(hi, p, a);
+      i = p;
+    }
+    return i;
+  }
+
+  void siftDown_(bool hi, uint8_t i) {
+    uint8_t* h = heap_(hi);
+    const uint8_t n = size_(hi);
+    for (;;) {
+      const uint8_t l = (uint8_t)(2 * i + 1), r = (uint8_t)(l + 1);
+      uint8_t best = i;
+      if (l < n && above_(hi, h[l], h[best])) best = l;
+      if (r < n && above_(hi, h[r], h[best])) best = r;
+      if (best == i) return;
+      const uint8_t a = h[i], b = h[best];
+      set_(hi, i, b);
+      set_(hi, best, a);
+      i = best;
+    }
+  }
+
+  void insert_(bool hi, uint8_t slot) {
+    const uint8_t i = size_(hi)++;
+    set_(hi, i, slot);
+    siftUp_(hi, i);
+  }
+
+  uint8_t popTop_(bool hi) {
+    uint8_t* h = heap_(hi);
+    const uint8_t top = h[0];
+    const uint8_t last = --size_(hi);
+    if (last) {
+      set_(hi, 0, h[last]);
+      siftDown_(hi, 0);
+    }
+    return top;
+  }
+
+  uint16_t val_[kMaxWindow];
+  uint8_t  where_[kMaxWindow];   // slot → (hi?0x80:0) | 힙 인덱스
+  uint8_t  lo_[kMaxWindow];
+  uint8_t  hi_[kMaxWindow];
+  uint8_t  n_ = 1, count_ = 0, head_ = 0, nLo_ = 0, nHi_ = 0;
+};
+
+class HampelFilter {
+public:
+  // k_x10: 임계 배수 ×10 (30 = 3σ), window: 중앙값 창 크기
+  HampelFilter(uint8_t window = 7, uint8_t k_x10 = 30) : med_(window), kx10_(k_x10) {}
+
+  void reset() { med_.reset(); scaleQ4_ = 0; warm_ = 0; }
+
+  uint16_t push(uint16_t x) {
+    const uint16_t m = med_.push(x);
+    const uint32_t dev = absdiff(x, m);
+    // σ ≈ 1.4826·MAD, MAD 는 |x-m| 의 EMA(1/16)로 근사 — 1.4826 ≈ 95/64
+    const uint32_t devQ4 = dev << 4;
+    scaleQ4_ += ((int32_t)devQ4 - (int32_t)scaleQ4_) / 16;
+    if (warm_ < med_.window()) { warm_++; return x; }    // 창이 찰 때까진 통과
+    const uint32_t sigmaQ4 = ((uint32_t)scaleQ4_ * 95u) / 64u;
+    // 1mm 미만 σ 는 1mm 로 (정지 상태에서 모든 변화가 이상치로 잡히지 않도록)
+    const uint32_t floorQ4 = sigmaQ4 < 16 ? 16 : sigmaQ4;
+    if (devQ4 * 10u > floorQ4 * kx10_) { rejected_++; return m; }
+    return x;
+  }
+
+  uint32_t rejected() const { return rejected_; }
+
+private:
+  SlidingMedian med_;
+  uint8_t  kx10_;
+  int32_t  scaleQ4_ = 0;
+  uint8_t  warm_ = 0;
+  uint32_t rejected_ = 0;
+};
+
+class IntEma {
+public:
+  explicit IntEma(uint8_t shift = 2) : shift_(shift) {}
+  void reset() { primed_ = false; }
+  uint16_t push(uint16_t x) {
+    const int32_t xq = (int32_t)x << 4;
+    if (!primed_) { yQ4_ = xq; primed_ = true; }
+    else yQ4_ += (xq - yQ4_) >> shift_;   // 산술 시프트: 음수도 바닥 방향
+    return (uint16_t)((yQ4_ + 8) >> 4);
+  }
+private:
+  uint8_t shift_;
+  int32_t yQ4_ = 0;
+  bool    primed_ = false;
+};
+
+// 클래스 밖에 둬야 기본 인자(Config{})로 쓸 수 있음
+struct FilterConfig {
+  uint8_t hampelWindow = 7;   // 0 = Hampel 끔
+  uint8_t hampelK_x10  = 30;
+  uint8_t medianWindow = 3;   // 0/1 = 중앙값 끔
+  uint8_t emaShift     = 0;   // 0 = EMA 끔, 2 = α 1/4
+};
+
+class FilterChain {
+public:
+  using Config = FilterConfig;
+
+  explicit FilterChain(const Config& cfg = Config{})
+  : cfg_(cfg),
+    hampel_(cfg.hampelWindow ? cfg.hampelWindow : 1, cfg.hampelK_x10),
+    median_(cfg.medianWindow ? cfg.medianWindow : 1),
+    ema_(cfg.emaShift) {}
+
+  void reset() { hampel_.reset(); median_.reset(); ema_.reset(); }
+
+  uint16_t push(uint16_t x) {
+    if (cfg_.hampelWindow > 1) x = hampel_.push(x);
+    if (cfg_.medianWindow > 1) x = median_.push(x);
+    if (cfg_.emaShift)         x = ema_.push(x);
+    return x;
+  }
+
+  const Config& config() const { return cfg_; }
+  uint32_t outliers() const { return hampel_.rejected(); }
+
+private:
+  Config        cfg_;
+  HampelFilter  hampel_;
+  SlidingMedian median_;
+  IntEma        ema_;
+};
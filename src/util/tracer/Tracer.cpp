@@ -0,0 +1,203 @@
+#include "Tracer.h"
+#include <Arduino.h>
+#include <atomic>
+#include <esp_cpu.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "src/util/log/Log.h"
+
+namespace {
+  constexpr uint8_t kCores    = 2;
+  constexpr uint8_t kTasksMax = 24;
+
+  struct Event {             // 16B (ESP32 32비트 포인터)
+    uint32_t    startUs;     // esp_timer 하위 32비트 (71분 주기)
+    uint32_t    durCyc;
+    const char* name;
+    uint8_t     tid;         // g_tasks 인덱스
+    uint8_t     rsv[3];
+  };
+
+  Event*   g_ring[kCores] = {};
+  uint32_t g_cap   = 0;
+  bool     g_psram = false;
+  std::atomic<uint32_t> g_head[kCores];
+  std::atomic<bool>     g_paused{false};
+  std::atomic<uint32_t> g_exportToken{0};     // 진행 중인 내보내기 (0 = 없음)
+  uint32_t              g_nextToken = 1;
+
+  // 태스크 이름은 처음 볼 때 복사 (내보낼 때 핸들이 이미 지워졌을 수 있음)
+  struct TaskName { TaskHandle_t h; char name[configMAX_TASK_NAME_LEN]; };
+  TaskName              g_tasks[kTasksMax];
+  std::atomic<uint8_t>  g_nTasks{0};
+  portMUX_TYPE          g_mux = portMUX_INITIALIZER_UNLOCKED;
+
+  uint8_t tid_() {
+    const TaskHandle_t h = xTaskGetCurrentTaskHandle();
+    const uint8_t n = g_nTasks.load(std::memory_order_acquire);
+    for (uint8_t i = 0; i < n; ++i) if (g_tasks[i].h == h) return i;
+
+    uint8_t id = kTasksMax;   // 가득 차면 마지막 칸("other")에 몰아 넣음
+    portENTER_CRITICAL(&g_mux);
+    const uint8_t m = g_nTasks.load(std::memory_order_relaxed);
+    for (uint8_t i = n; i < m; ++i) if (g_tasks[i].h == h) { id = i; break; }
+    if (id == kTasksMax && m < kTasksMax - 1) {
+      g_tasks[m].h = h;
+      strlcpy(g_tasks[m].name, pcTaskGetName(nullptr), sizeof(g_tasks[m].name));
+      g_nTasks.store(m + 1, std::memory_order_release);
+      id = m;
+    }
+    portEXIT_CRITICAL(&g_mux);
+    return id == kTasksMax ? kTasksMax - 1 : id;
+  }
+
+  inline uint32_t cpuMhz_() { return getCpuFrequencyMhz(); }
+}
+
+bool Tracer::begin(const Config& cfg) {
+#if GYMBUDDY_TRACE
+  if (g_ring[0]) return true;
+  strlcpy(g_tasks[kTasksMax - 1].name, "other", sizeof(g_tasks[0].name));
+  auto alloc = [](uint32_t n, uint32_t caps) { return (Event*)heap_caps_calloc(n, sizeof(Event), caps); };
+  if (psramFound() && cfg.psramEvents) {
+    g_ring[0] = alloc(cfg.psramEvents, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    g_ring[1] = alloc(cfg.psramEvents, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (g_ring[0] && g_ring[1]) { g_cap = cfg.psramEvents; g_psram = true; }
+  }
+  if (!g_cap && cfg.internalEvents) {
+    for (auto& r : g_ring) { heap_caps_free(r); r = nullptr; }
+    g_ring[0] = alloc(cfg.internalEvents, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    g_ring[1] = alloc(cfg.internalEvents, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (g_ring[0] && g_ring[1]) g_cap = cfg.internalEvents;
+  }
+  if (!g_cap) {
+    for (auto& r : g_ring) { heap_caps_free(r); r = nullptr; }
+    LOGE("TRACER", "buffer alloc failed");
+    return false;
+  }
+  LOGI("TRACER", "%lu events/core (%s)", (unsigned long)g_cap, g_psram ? "PSRAM" : "internal");
+  return true;
+#else
+  (void)cfg;
+  return false;
+#endif
+}
+
+Tracer::Stats Tracer::stats() {
+  return Stats{ g_cap != 0, g_psram, g_cap, { g_head[0].load(), g_head[1].load() } };
+}
+
+void Tracer::record(const char* name, uint32_t startUs, uint32_t startCyc, uint8_t startCore) {
+  if (!g_cap || g_paused.load(std::memory_order_relaxed)) return;
+  const uint8_t core = (uint8_t)xPortGetCoreID();
+  // CCOUNT 는 코어마다 따로 → 도중에 코어가 바뀌었으면 µs 로 계산
+  const uint32_t dur = (core == startCore)
+    ? esp_cpu_get_cycle_count() - startCyc
+    : ((uint32_t)esp_timer_get_time() - startUs) * cpuMhz_();
+  const uint32_t i = g_head[core].fetch_add(1, std::memory_order_relaxed);
+  g_ring[core][i % g_cap] = Event{startUs, dur, name, tid_(), {}};
+}
+
+#if GYMBUDDY_TRACE
+Tracer::Scope::Scope(const char* name)
+: name_(name), us_((uint32_t)esp_timer_get_time()), cyc_(esp_cpu_get_cycle_count()), core_((uint8_t)xPortGetCoreID()) {}
+
+Tracer::Scope::~Scope() { record(name_, us_, cyc_, core_); }
+#endif
+
+// ---------- 내보내기 (Chrome trace event format, JSON object 형식) ----------
+
+Tracer::Export Tracer::beginExport() {
+  Export ex;
+  if (!g_cap) return ex;
+  uint32_t expected = 0;
+  portENTER_CRITICAL(&g_mux);
+  uint32_t token = g_nextToken++;
+  if (!token) token = g_nextToken++;
+  portEXIT_CRITICAL(&g_mux);
+  if (!g_exportToken.compare_exchange_strong(expected, token)) return ex;
+  g_paused.store(true);
+  vTaskDelay(1);            // 이미 슬롯을 잡은 기록이 끝나도록
+  ex.token = token;
+  return ex;
+}
+
+void Tracer::endExport(const Export& ex) {
+  uint32_t expected = ex.token;
+  if (ex.token && g_exportToken.compare_exchange_strong(expected, 0)) g_paused.store(false);
+}
+
+size_t Tracer::fillExport(Export& ex, uint8_t* buf, size_t maxLen) {
+  enum : uint8_t { kHead, kProc, kThreads, kEvents, kTail, kDone };
+  if (!ex.token || maxLen < kExportLineMax) return 0;
+
+  char* out = (char*)buf;
+  size_t w = 0;
+  auto room = [&] { return maxLen - w >= kExportLineMax; };
+  auto sep  = [&] { if (!ex.first) out[w++] = ','; ex.first = false; out[w++] = '\n'; };
+
+  // 32비트 µs 를 부팅 이후 시각으로 (모든 이벤트는 최근 71분 안)
+  const int64_t  nowFull = esp_timer_get_time();
+  const uint32_t now32   = (uint32_t)nowFull;
+  const float    mhz     = (float)cpuMhz_();
+
+  while (room() && ex.stage != kDone) {
+    switch (ex.stage) {
+      case kHead:
+        w += snprintf(out + w, maxLen - w, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+        ex.stage = kProc;
+        break;
+
+      case kProc:
+        sep();
+        w += snprintf(out + w, maxLen - w,
+                      "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"args\":{\"name\":\"core%u\"}}",
+                      ex.core, ex.core);
+        if (++ex.core >= kCores) { ex.core = 0; ex.stage = kThreads; }
+        break;
+
+      case kThreads: {
+        const uint8_t m = g_nTasks.load();
+        const uint8_t n = m >= kTasksMax - 1 ? kTasksMax : m;   // "other" 칸까지
+        if (ex.index >= n) { ex.index = 0; ex.core = 0; ex.stage = kEvents; break; }
+        // 태스크가 어느 코어에서 돌았는지 모르므로 양쪽 pid 에 같은 이름
+        for (uint8_t c = 0; c < kCores; ++c) {
+          sep();
+          w += snprintf(out + w, maxLen - w,
+                        "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%lu,\"args\":{\"name\":\"%s\"}}",
+                        c, (unsigned long)ex.index, g_tasks[ex.index].name);
+        }
+        ex.index++;
+        break;
+      }
+
+      case kEvents: {
+        const uint32_t head = g_head[ex.core].load();
+        const uint32_t n    = head < g_cap ? head : g_cap;
+        if (ex.index >= n) {
+          ex.index = 0;
+          if (++ex.core >= kCores) ex.stage = kTail;
+          break;
+        }
+        const Event& e = g_ring[ex.core][(head - n + ex.index) % g_cap];
+        ex.index++;
+        if (!e.name) continue;
+        const double ts = (double)(nowFull - (int64_t)(uint32_t)(now32 - e.startUs));
+        sep();
+        w += snprintf(out + w, maxLen - w,
+                      "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%u,\"tid\":%u,\"ts\":%.0f,\"dur\":%.3f}",
+                      e.name, ex.core, e.tid, ts, e.durCyc / mhz);
+        break;
+      }
+
+      case kTail:
+        w += snprintf(out + w, maxLen - w, "\n]}\n");
+        ex.stage = kDone;
+        break;
+    }
+  }
+  if (ex.stage == kDone && w == 0) endExport(ex);
+  return w;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// 태스크/함수 구간 트레이서 (GET /api/systrace → Chrome trace JSON, Perfetto 에서 열림)
+//  - TRACE_SCOPE("dist.read") : 스코프 진입~종료를 "X"(complete) 이벤트 1개로 기록
+//      시작 = esp_timer(µs), 길이 = CCOUNT 차이(사이클) → 진입/종료가 다른 코어면 esp_timer 로 대체
+//  - 코어별 링(덮어쓰기). 기록은 원자 증가 1회 + 16B 쓰기, 락/할당 없음 (ISR 금지)
+//  - 이름은 문자열 리터럴만 (포인터를 보관)
+//  - GYMBUDDY_TRACE=0 이면 매크로가 비어 호출 지점 비용 0 (host 빌드도 0)
+//    빌드 옵션 -DGYMBUDDY_TRACE=1 또는 여기서 변경
+#ifndef GYMBUDDY_TRACE
+#define GYMBUDDY_TRACE 0
+#endif
+
+namespace Tracer {
+  struct Config {
+    uint32_t psramEvents    = 16384;   // 코어당 (16B × 16k = 256KB)
+    uint32_t internalEvents = 1024;    // PSRAM 없을 때 코어당 (16KB)
+  };
+
+  struct Stats {
+    bool     enabled;        // 컴파일 포함 + 버퍼 있음
+    bool     psram;
+    uint32_t capacity;       // 코어당 이벤트
+    uint32_t recorded[2];    // 부팅 이후 코어별 기록 수 (capacity 초과분은 덮어씀)
+  };
+
+  bool  begin(const Config& cfg = Config{});
+  Stats stats();
+
+  void record(const char* name, uint32_t startUs, uint32_t startCyc, uint8_t startCore);
+
+  // 내보내기: 시작하면 기록을 멈추고(링 고정) 끝나거나 end() 하면 재개. 동시에 하나만
+  struct Export {
+    uint32_t token  = 0;     // 0 = 시작 실패 (비활성/다른 내보내기 중)
+    uint8_t  stage  = 0;
+    uint8_t  core   = 0;
+    uint32_t index  = 0;
+    bool     first  = true;
+  };
+  constexpr size_t kExportLineMax = 256;   // 한 단계 최대 출력. maxLen 이 이보다 작으면 0 → 호출 쪽에서 재시도
+  Export beginExport();
+  size_t fillExport(Export& ex, uint8_t* buf, size_t maxLen);   // 0 = 끝
+  void   endExport(const Export& ex);
+
+#if GYMBUDDY_TRACE
+  class Scope {
+  public:
+    explicit Scope(const char* name);
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+  private:
+    const char* name_;
+    uint32_t    us_;
+    uint32_t    cyc_;
+    uint8_t     core_;
+  };
+#endif
+}
+
+#if GYMBUDDY_TRACE
+#define GYMBUDDY_TRACE_CAT2_(a, b) a##b
+#define GYMBUDDY_TRACE_CAT_(a, b)  GYMBUDDY_TRACE_CAT2_(a, b)
+#define TRACE_SCOPE(name)          Tracer::Scope GYMBUDDY_TRACE_CAT_(traceScope_, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name)          do {} while (0)
+#endif